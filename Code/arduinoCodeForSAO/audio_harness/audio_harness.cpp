@@ -0,0 +1,420 @@
+// audio_harness.cpp
+//
+// Runs the skull's microphone pipeline on a WAV file, on a Linux host.
+// The WAV is resampled to SAMPLE_RATE, turned into a PDM bitstream by a
+// second-order sigma-delta modulator (what the microphone does in hardware)
+// and fed through the same code the sketch uses: PDM decimation, level
+// meter / AGC / sound gestures per capture block, then the overlapped FFT,
+// spectrum levels, band energies, beat tracking and pitch per frame.
+//
+// Build (from this directory):
+//   g++ -O2 -I../skull_of_fate_v1 -o audio_harness audio_harness.cpp ../skull_of_fate_v1/AudioPipeline.cpp ../skull_of_fate_v1/BeatTracker.cpp ../skull_of_fate_v1/BeatClock.cpp ../skull_of_fate_v1/SoundGestures.cpp ../skull_of_fate_v1/PitchTracker.cpp
+//
+// Usage:
+//   ./audio_harness song.wav [frames.csv]
+//   ./audio_harness --click <bpm> [seconds]
+//
+// Prints per-stage throughput, detected gestures and a once-a-second
+// volume / tempo summary. The optional CSV gets one row per FFT frame.
+// --click runs a synthetic click track instead and checks that it gives
+// about one onset per beat, locks the beat clock to its tempo and never
+// sets off a sound gesture; the exit status is non-zero if it does not.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+#include "AudioPipeline.h"
+#include "BeatTracker.h"
+#include "BeatClock.h"
+#include "SoundGestures.h"
+#include "PitchTracker.h"
+
+#define PDM_RATE (SAMPLE_RATE * PDM_DECIMATION)
+#define SIGMA_DELTA_LEVEL 0.5  // Input scale into the modulator; keeps it out of overload
+
+// --click self-check
+#define CLICK_DEFAULT_SECONDS 12
+#define CLICK_LENGTH_MS 30          // Noise burst per beat, 5 ms decay
+#define CLICK_LEVEL 0.6
+#define CLICK_ROOM_LEVEL 0.003      // Background hiss; digital silence makes the modulator idle-tone
+#define CLICK_SETTLE_MS 4000        // Tempo is checked on the beats after this
+#define CLICK_MIN_ONSETS_PER_BEAT 0.8
+#define CLICK_MAX_ONSETS_PER_BEAT 1.25
+#define CLICK_BPM_TOLERANCE 2
+
+// Reads 16-bit PCM WAV, mixing all channels down to mono in -1..1
+static bool readWav(const char* path, std::vector<float> &samples, uint32_t &rate) {
+  FILE* file = fopen(path, "rb");
+  if (file == NULL) {
+    printf("Cannot open %s\n", path);
+    return false;
+  }
+
+  char riff[12];
+  if (fread(riff, 1, 12, file) != 12 || memcmp(riff, "RIFF", 4) != 0 || memcmp(riff + 8, "WAVE", 4) != 0) {
+    printf("%s is not a WAV file\n", path);
+    fclose(file);
+    return false;
+  }
+
+  uint16_t format = 0;
+  uint16_t channels = 0;
+  uint16_t bits = 0;
+  rate = 0;
+
+  // Walk the chunks up to the sample data
+  char id[4];
+  uint32_t size;
+  while (fread(id, 1, 4, file) == 4 && fread(&size, 4, 1, file) == 1) {
+    if (memcmp(id, "fmt ", 4) == 0) {
+      uint8_t fmt[16];
+      if (size < 16 || fread(fmt, 1, 16, file) != 16) {
+        break;
+      }
+      memcpy(&format, fmt, 2);
+      memcpy(&channels, fmt + 2, 2);
+      memcpy(&rate, fmt + 4, 4);
+      memcpy(&bits, fmt + 14, 2);
+      fseek(file, size - 16 + (size & 1), SEEK_CUR);
+    } else if (memcmp(id, "data", 4) == 0) {
+      if (format != 1 || bits != 16 || channels == 0) {
+        printf("Only 16-bit PCM WAV files are supported\n");
+        fclose(file);
+        return false;
+      }
+      uint32_t frames = size / (2 * channels);
+      std::vector<int16_t> raw(frames * channels);
+      frames = fread(raw.data(), 2 * channels, frames, file);
+      samples.resize(frames);
+      for (uint32_t i = 0; i < frames; i++) {
+        int32_t sum = 0;
+        for (uint16_t c = 0; c < channels; c++) {
+          sum += raw[i * channels + c];
+        }
+        samples[i] = sum / (32768.0f * channels);
+      }
+      fclose(file);
+      return true;
+    } else {
+      fseek(file, size + (size & 1), SEEK_CUR);
+    }
+  }
+
+  printf("%s has no sample data\n", path);
+  fclose(file);
+  return false;
+}
+
+// Linear-interpolating resampler
+static std::vector<float> resample(const std::vector<float> &in, uint32_t fromRate, uint32_t toRate) {
+  if (fromRate == toRate || in.empty()) {
+    return in;
+  }
+  size_t count = (size_t)((uint64_t)in.size() * toRate / fromRate);
+  std::vector<float> out(count);
+  for (size_t i = 0; i < count; i++) {
+    double position = (double)i * fromRate / toRate;
+    size_t index = (size_t)position;
+    double frac = position - index;
+    float next = (index + 1 < in.size()) ? in[index + 1] : in[index];
+    out[i] = in[index] * (1.0 - frac) + next * frac;
+  }
+  return out;
+}
+
+// White noise in -1..1 (LCG)
+static float noise(uint32_t &seed) {
+  seed = seed * 1664525 + 1013904223;
+  return (int32_t)seed / 2147483648.0f;
+}
+
+// A noise burst on every beat, like a metronome in a quiet room
+static std::vector<float> clickTrack(uint16_t bpm, uint32_t seconds) {
+  std::vector<float> pcm((size_t)seconds * SAMPLE_RATE);
+  uint32_t seed = 1;
+  for (size_t i = 0; i < pcm.size(); i++) {
+    pcm[i] = CLICK_ROOM_LEVEL * noise(seed);
+  }
+  for (double beat = 0; beat < seconds; beat += 60.0 / bpm) {
+    size_t start = (size_t)(beat * SAMPLE_RATE);
+    for (size_t i = 0; i < (size_t)CLICK_LENGTH_MS * SAMPLE_RATE / 1000 && start + i < pcm.size(); i++) {
+      pcm[start + i] += CLICK_LEVEL * noise(seed) * expf(-(float)i / (SAMPLE_RATE * 0.005f));
+    }
+  }
+  return pcm;
+}
+
+// Second-order sigma-delta modulator at the PDM clock. Each PCM sample is
+// linearly interpolated up to PDM_DECIMATION bits, packed 16 per word with
+// the first bit in bit 0 like the I2S receiver delivers them.
+static std::vector<uint16_t> sigmaDelta(const std::vector<float> &pcm) {
+  std::vector<uint16_t> words(pcm.size() * PDM_WORDS_PER_SAMPLE, 0);
+  double integrator1 = 0.0;
+  double integrator2 = 0.0;
+  double feedback = -1.0;
+
+  for (size_t i = 0; i < pcm.size(); i++) {
+    float next = (i + 1 < pcm.size()) ? pcm[i + 1] : pcm[i];
+    for (int b = 0; b < PDM_DECIMATION; b++) {
+      double x = (pcm[i] + (next - pcm[i]) * b / PDM_DECIMATION) * SIGMA_DELTA_LEVEL;
+      integrator1 += x - feedback;
+      integrator2 += integrator1 - feedback;
+      feedback = (integrator2 >= 0.0) ? 1.0 : -1.0;
+      if (feedback > 0.0) {
+        words[i * PDM_WORDS_PER_SAMPLE + b / 16] |= 1 << (b % 16);
+      }
+    }
+  }
+  return words;
+}
+
+// Accumulated time for one pipeline stage
+struct Stage {
+  const char* name;
+  double seconds;
+  uint32_t calls;
+};
+
+typedef std::chrono::steady_clock Clock;
+
+static double since(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static void report(const Stage &stage, uint32_t items, const char* item, double audioSeconds) {
+  printf("  %-18s %9.1f ns/%-7s %6.2f%% of real time\n",
+         stage.name,
+         items ? stage.seconds * 1e9 / items : 0.0,
+         item,
+         audioSeconds > 0 ? stage.seconds * 100.0 / audioSeconds : 0.0);
+}
+
+// What a run ended with
+struct PipelineResult {
+  uint32_t onsets;
+  uint32_t settledOnsets;  // Onsets after CLICK_SETTLE_MS
+  uint16_t bpm;
+  uint8_t confidence;
+  uint16_t clockBpm;
+  uint32_t gestures;  // Double claps and knock patterns heard
+};
+
+// Runs PCM at SAMPLE_RATE through the sketch's pipeline, printing as it goes
+static PipelineResult runPipeline(const std::vector<float> &pcmIn, FILE* csv) {
+  double audioSeconds = (double)pcmIn.size() / SAMPLE_RATE;
+
+  Stage modulator = { "sigma-delta", 0, 0 };
+  Clock::time_point start = Clock::now();
+  std::vector<uint16_t> pdmWords = sigmaDelta(pcmIn);
+  modulator.seconds = since(start);
+  printf("Simulated %u PDM bits (%.1f MHz clock) in %.2f s\n\n",
+         (unsigned)(pdmWords.size() * 16), PDM_RATE / 1e6, modulator.seconds);
+
+  if (csv != NULL) {
+    fprintf(csv, "time_ms,volume,loudness,bass,mid,treble,flux,onset,tracker_bpm,confidence,clock_bpm,pitch_hz,note,clarity\n");
+  }
+
+  // Pipeline state, as in the sketch
+  std::vector<int16_t> pcm(pdmWords.size() / PDM_WORDS_PER_SAMPLE);
+  LevelMeter meter = {};
+  MicAgc agc;
+  micAgcBegin(agc, 0);
+  SoundGestureDetector gestures = {};
+  static SpectrumAnalyzer<FFT_SIZE> analyzer;
+  uint16_t spectrum[FFT_SIZE / 2] = { 0 };
+  int32_t spectrumMax = SPECTRUM_AGC_START;
+  BandEnergies bands = {};
+  BeatTracker tracker;
+  beatTrackerReset(tracker);
+  static PitchTracker pitch;
+  pitchTrackerReset(pitch);
+
+  Stage decimate = { "decimate", 0, 0 };
+  Stage level = { "meter+agc+gesture", 0, 0 };
+  Stage fft = { "window+fft", 0, 0 };
+  Stage bandStage = { "levels+bands", 0, 0 };
+  Stage beat = { "beat tracking", 0, 0 };
+  Stage pitchStage = { "pitch", 0, 0 };
+
+  uint16_t volume = 0;
+  uint32_t nextFrameEnd = FFT_SIZE;
+  uint32_t onsets = 0;
+  uint32_t settledOnsets = 0;
+  uint32_t gestureCount = 0;
+  uint32_t second = 0;
+  uint32_t volumeSum = 0;
+  uint32_t volumeBlocks = 0;
+  uint16_t volumePeak = 0;
+
+  printf("  time  volume(avg/peak)  tracker bpm  conf  clock bpm\n");
+
+  uint32_t blocks = pcm.size() / CAPTURE_BLOCK_SAMPLES;
+  for (uint32_t b = 0; b < blocks; b++) {
+    uint32_t offset = b * CAPTURE_BLOCK_SAMPLES;
+
+    // Capture interrupt work
+    start = Clock::now();
+    pdmDecimateBlock(&pdmWords[offset * PDM_WORDS_PER_SAMPLE], &pcm[offset], CAPTURE_BLOCK_SAMPLES);
+    decimate.seconds += since(start);
+    decimate.calls++;
+
+    start = Clock::now();
+    levelMeterBlock(meter, &pcm[offset], CAPTURE_BLOCK_SAMPLES);
+    volume = micAgcUpdate(agc, meter.loudness);
+    SoundGesture gesture = soundGestureBlock(gestures, meter.loudness, meter.crossings);
+    level.seconds += since(start);
+    level.calls++;
+
+    uint32_t written = offset + CAPTURE_BLOCK_SAMPLES;
+    uint32_t nowMs = (uint64_t)written * 1000 / SAMPLE_RATE;
+    if (gesture == SOUND_GESTURE_DOUBLE_CLAP) {
+      printf("  %6.2f s: double clap\n", nowMs / 1000.0);
+      gestureCount++;
+    } else if (gesture == SOUND_GESTURE_KNOCK) {
+      printf("  %6.2f s: knock pattern\n", nowMs / 1000.0);
+      gestureCount++;
+    }
+
+    volumeSum += volume;
+    volumeBlocks++;
+    if (volume > volumePeak) {
+      volumePeak = volume;
+    }
+
+    // processFFT() for every overlapped frame that is now complete
+    while (nextFrameEnd <= written) {
+      start = Clock::now();
+      analyzer.process(&pcm[nextFrameEnd - FFT_SIZE]);
+      fft.seconds += since(start);
+      fft.calls++;
+
+      start = Clock::now();
+      spectrumLevels(analyzer.magnitude, spectrum, FFT_SIZE / 2, spectrumMax);
+      bandEnergiesUpdate(bands, spectrum, FFT_SIZE, SAMPLE_RATE);
+      bandStage.seconds += since(start);
+      bandStage.calls++;
+
+      uint32_t frameMs = (uint64_t)nextFrameEnd * 1000 / SAMPLE_RATE;
+      start = Clock::now();
+      bool onset = beatTrackerUpdate(tracker, bands.energy, frameMs);
+      if (onset) {
+        beatClockAudioBeat(frameMs);
+      }
+      if (tracker.confidence >= BEAT_MIN_CONFIDENCE) {
+        beatClockAudioTempo(tracker.bpm, frameMs);
+      }
+      beat.seconds += since(start);
+      beat.calls++;
+      onsets += onset;
+      if (frameMs >= CLICK_SETTLE_MS) {
+        settledOnsets += onset;
+      }
+
+      // processPitch() reads the longer frame ending at the same point
+      bool voiced = false;
+      if (nextFrameEnd >= PITCH_FRAME_SAMPLES) {
+        start = Clock::now();
+        voiced = pitchTrackerUpdate(pitch, &pcm[nextFrameEnd - PITCH_FRAME_SAMPLES]);
+        pitchStage.seconds += since(start);
+        pitchStage.calls++;
+      }
+
+      if (csv != NULL) {
+        fprintf(csv, "%u,%.2f,%.2f,%.2f,%.2f,%.2f,%u,%d,%u,%u,%u,%u,%d,%u\n",
+                frameMs, volume / 256.0, meter.loudness / 256.0,
+                bands.bass / 256.0, bands.mid / 256.0, bands.treble / 256.0,
+                tracker.flux, onset ? 1 : 0, tracker.bpm, tracker.confidence, beatClockBpm(),
+                voiced ? pitch.frequency : 0, voiced ? pitch.note : -1, pitch.clarity);
+      }
+      nextFrameEnd += analyzer.HOP;
+    }
+
+    // Once a second summary
+    if (nowMs / 1000 != second) {
+      printf("  %4us  %6.2f / %5.2f     %5u     %4u    %5u\n",
+             second, volumeSum / 256.0 / volumeBlocks, volumePeak / 256.0,
+             tracker.bpm, tracker.confidence, beatClockBpm());
+      second = nowMs / 1000;
+      volumeSum = 0;
+      volumeBlocks = 0;
+      volumePeak = 0;
+    }
+  }
+
+  double pipeline = decimate.seconds + level.seconds + fft.seconds + bandStage.seconds + beat.seconds + pitchStage.seconds;
+  printf("\n%u onsets, tempo %u BPM (confidence %u), beat clock %u BPM\n\n",
+         onsets, tracker.bpm, tracker.confidence, beatClockBpm());
+  printf("Per-stage cost on this host (%u blocks, %u frames):\n", decimate.calls, fft.calls);
+  report(decimate, decimate.calls * CAPTURE_BLOCK_SAMPLES, "sample", audioSeconds);
+  report(level, level.calls, "block", audioSeconds);
+  report(fft, fft.calls, "frame", audioSeconds);
+  report(bandStage, bandStage.calls, "frame", audioSeconds);
+  report(beat, beat.calls, "frame", audioSeconds);
+  report(pitchStage, pitchStage.calls, "frame", audioSeconds);
+  printf("  %-18s %9.1f x real time\n", "pipeline total", pipeline > 0 ? audioSeconds / pipeline : 0.0);
+
+  PipelineResult result = { onsets, settledOnsets, tracker.bpm, tracker.confidence, beatClockBpm(), gestureCount };
+  return result;
+}
+
+// Synthetic click track: about one onset per beat, and the clock on its tempo
+static int clickCheck(uint16_t bpm, uint32_t seconds) {
+  if (bpm < BEAT_MIN_BPM || bpm > BEAT_MAX_BPM || seconds * 1000 <= CLICK_SETTLE_MS) {
+    printf("Click tempo must be %u-%u BPM and longer than %u ms\n", BEAT_MIN_BPM, BEAT_MAX_BPM, CLICK_SETTLE_MS);
+    return 1;
+  }
+  printf("Click track: %u BPM for %u s\n", bpm, seconds);
+  PipelineResult result = runPipeline(clickTrack(bpm, seconds), NULL);
+
+  double beats = (seconds * 1000 - CLICK_SETTLE_MS) * bpm / 60000.0;
+  double perBeat = result.settledOnsets / beats;
+  int bpmError = (int)result.clockBpm - bpm;
+  bool onsetsOk = perBeat >= CLICK_MIN_ONSETS_PER_BEAT && perBeat <= CLICK_MAX_ONSETS_PER_BEAT;
+  bool tempoOk = bpmError >= -CLICK_BPM_TOLERANCE && bpmError <= CLICK_BPM_TOLERANCE;
+
+  printf("\n%.2f onsets per beat after %u ms: %s\n", perBeat, CLICK_SETTLE_MS, onsetsOk ? "ok" : "FAIL");
+  printf("Beat clock %u BPM for a %u BPM click: %s\n", result.clockBpm, bpm, tempoOk ? "ok" : "FAIL");
+  printf("%u sound gestures set off: %s\n", result.gestures, result.gestures == 0 ? "ok" : "FAIL");
+  return onsetsOk && tempoOk && result.gestures == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+  if (argc >= 3 && strcmp(argv[1], "--click") == 0) {
+    uint32_t seconds = argc >= 4 ? atoi(argv[3]) : CLICK_DEFAULT_SECONDS;
+    return clickCheck(atoi(argv[2]), seconds);
+  }
+  if (argc < 2) {
+    printf("Usage: %s input.wav [frames.csv]\n", argv[0]);
+    printf("       %s --click <bpm> [seconds]\n", argv[0]);
+    return 1;
+  }
+
+  std::vector<float> input;
+  uint32_t rate;
+  if (!readWav(argv[1], input, rate)) {
+    return 1;
+  }
+  std::vector<float> pcmIn = resample(input, rate, SAMPLE_RATE);
+  printf("%s: %.2f s at %u Hz, resampled to %u Hz\n", argv[1], (double)pcmIn.size() / SAMPLE_RATE, rate, SAMPLE_RATE);
+
+  FILE* csv = NULL;
+  if (argc >= 3) {
+    csv = fopen(argv[2], "w");
+    if (csv == NULL) {
+      printf("Cannot write %s\n", argv[2]);
+      return 1;
+    }
+  }
+
+  runPipeline(pcmIn, csv);
+
+  if (csv != NULL) {
+    fclose(csv);
+  }
+  return 0;
+}
@@ -0,0 +1,183 @@
+// AudioCapture.cpp
+
+#include "AudioCapture.h"
+#include <Adafruit_ZeroDMA.h>
+
+Adafruit_ZeroDMA pdmDMA;
+
+// Raw PDM words, filled by DMA one block at a time
+static uint16_t pdmWords[CAPTURE_DMA_BLOCKS][CAPTURE_BLOCK_WORDS];
+static uint8_t dmaBlock = 0;  // Block the DMA is filling right now
+
+// Decimated PCM history
+static int16_t pcmRing[CAPTURE_RING_SAMPLES];
+static volatile uint32_t pcmWritten = 0;
+
+// Level meter and AGC, updated every block
+static LevelMeter meter;
+static MicAgc micAgc = { (int32_t)MIC_DEFAULT_FLOOR << 8, (int32_t)MIC_DEFAULT_LOUD << 8 };
+static volatile uint16_t volume = 0;
+
+// Acoustic gestures
+static SoundGestureDetector gestureDetector;
+static SoundGestureCallback gestureCallback = NULL;
+static volatile bool gesturesEnabled = true;
+
+// Block-complete interrupt: decimate and meter the block the DMA just finished
+static void onPdmBlockDone(Adafruit_ZeroDMA* dma) {
+  (void)dma;
+  uint32_t writeIndex = pcmWritten & (CAPTURE_RING_SAMPLES - 1);
+  pdmDecimateBlock(pdmWords[dmaBlock], &pcmRing[writeIndex], CAPTURE_BLOCK_SAMPLES);
+  levelMeterBlock(meter, &pcmRing[writeIndex], CAPTURE_BLOCK_SAMPLES);
+  volume = micAgcUpdate(micAgc, meter.loudness);
+
+  SoundGesture gesture = soundGestureBlock(gestureDetector, meter.loudness, meter.crossings);
+  if (gesture != SOUND_GESTURE_NONE && gestureCallback != NULL && gesturesEnabled) {
+    gestureCallback(gesture);
+  }
+  pcmWritten += CAPTURE_BLOCK_SAMPLES;
+  dmaBlock = (dmaBlock + 1) % CAPTURE_DMA_BLOCKS;
+}
+
+bool audioCaptureBegin() {
+  pdmDMA.setTrigger(I2S_DMAC_ID_RX_0 + CAPTURE_I2S_SERIALIZER);
+  pdmDMA.setAction(DMA_TRIGGER_ACTON_BEAT);
+
+  ZeroDMAstatus status = pdmDMA.allocate();
+  if (status != DMA_STATUS_OK) {
+    Serial.println("Failed to allocate PDM DMA channel!");
+    pdmDMA.printStatus(status);
+    return false;
+  }
+
+  // One descriptor per block, looped into a ring. The low half of the
+  // 32-bit I2S data register holds the 16 PDM bits (same as pdm.read() & 0xFFFF).
+  for (int b = 0; b < CAPTURE_DMA_BLOCKS; b++) {
+    DmacDescriptor* desc = pdmDMA.addDescriptor(
+      (void*)&I2S->DATA[CAPTURE_I2S_SERIALIZER].reg,
+      pdmWords[b],
+      CAPTURE_BLOCK_WORDS,
+      DMA_BEAT_SIZE_HWORD,
+      false,  // Source is the fixed I2S data register
+      true);
+    if (desc == NULL) {
+      Serial.println("Failed to add PDM DMA descriptor!");
+      return false;
+    }
+    desc->BTCTRL.bit.BLOCKACT = DMA_BLOCK_ACTION_INT;  // Interrupt after every block
+  }
+  pdmDMA.loop(true);
+  pdmDMA.setCallback(onPdmBlockDone);
+
+  dmaBlock = 0;
+  pcmWritten = 0;
+  status = pdmDMA.startJob();
+  if (status != DMA_STATUS_OK) {
+    Serial.println("Failed to start PDM DMA!");
+    pdmDMA.printStatus(status);
+    return false;
+  }
+  return true;
+}
+
+void audioCaptureStop() {
+  pdmDMA.abort();
+  I2S->CTRLA.bit.ENABLE = 0;
+  while (I2S->SYNCBUSY.bit.ENABLE);
+}
+
+bool audioCaptureResume() {
+  I2S->CTRLA.bit.ENABLE = 1;
+  while (I2S->SYNCBUSY.bit.ENABLE);
+
+  // The ring starts over at the first descriptor; the PCM history carries on
+  dmaBlock = 0;
+  ZeroDMAstatus status = pdmDMA.startJob();
+  if (status != DMA_STATUS_OK) {
+    Serial.println("Failed to restart PDM DMA!");
+    pdmDMA.printStatus(status);
+    return false;
+  }
+  return true;
+}
+
+uint32_t audioCaptureSamplesWritten() {
+  return pcmWritten;
+}
+
+uint16_t audioCaptureVolume() {
+  return volume;
+}
+
+uint16_t audioCaptureThreshold() {
+  noInterrupts();  // The DMA interrupt updates both words
+  MicAgc agc = micAgc;
+  interrupts();
+  return micAgcThreshold(agc);
+}
+
+uint16_t audioCaptureLoudness() {
+  return meter.loudness;
+}
+
+uint16_t audioCapturePeak() {
+  return meter.peak;
+}
+
+void audioCaptureSetCalibration(uint32_t calibration) {
+  MicAgc seeded;
+  micAgcBegin(seeded, calibration);
+  noInterrupts();
+  micAgc = seeded;
+  interrupts();
+}
+
+void audioCaptureSetGestureCallback(SoundGestureCallback callback) {
+  gestureCallback = callback;
+}
+
+void audioCaptureEnableGestures(bool enabled) {
+  gesturesEnabled = enabled;
+}
+
+bool audioCaptureLatest(int16_t* dest, uint16_t count) {
+  // Leave a block of headroom so the interrupt cannot overwrite what is being copied
+  if (count > CAPTURE_RING_SAMPLES - CAPTURE_BLOCK_SAMPLES) {
+    count = CAPTURE_RING_SAMPLES - CAPTURE_BLOCK_SAMPLES;
+  }
+
+  uint32_t end = pcmWritten;
+  if (end < count) {
+    return false;
+  }
+
+  uint32_t start = end - count;
+  for (uint16_t i = 0; i < count; i++) {
+    dest[i] = pcmRing[(start + i) & (CAPTURE_RING_SAMPLES - 1)];
+  }
+  return true;
+}
+
+bool audioCaptureFrame(int16_t* dest, uint16_t count, uint16_t hop, uint32_t &cursor) {
+  if (count > CAPTURE_RING_SAMPLES - CAPTURE_BLOCK_SAMPLES) {
+    count = CAPTURE_RING_SAMPLES - CAPTURE_BLOCK_SAMPLES;
+  }
+
+  uint32_t written = pcmWritten;
+  if (cursor < count) {
+    cursor = count;
+  }
+  if ((int32_t)(written - cursor) < 0) {
+    return false;  // Next frame not captured yet
+  }
+  if (written - cursor > CAPTURE_RING_SAMPLES - CAPTURE_BLOCK_SAMPLES - count) {
+    cursor = written;  // Fell behind; the older samples are being overwritten
+  }
+
+  uint32_t start = cursor - count;
+  for (uint16_t i = 0; i < count; i++) {
+    dest[i] = pcmRing[(start + i) & (CAPTURE_RING_SAMPLES - 1)];
+  }
+  cursor += hop;
+  return true;
+}
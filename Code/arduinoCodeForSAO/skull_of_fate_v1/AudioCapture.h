@@ -0,0 +1,62 @@
+// AudioCapture.h
+
+#ifndef AUDIOCAPTURE_H
+#define AUDIOCAPTURE_H
+
+#include <Arduino.h>
+#include "AudioPipeline.h"
+#include "SoundGestures.h"
+
+// Continuous microphone capture. DMA copies raw PDM words from the I2S
+// receiver into a ring of blocks; each block-complete interrupt decimates
+// the finished block into the PCM ring buffer below and runs the level
+// meter, AGC and acoustic gesture recognizer on it. Readers never wait on the microphone, and the
+// volume is always current without any FFT work.
+
+// I2S serializer the PDM data pin (D12 / PA19 = I2S SD0) is wired to
+#define CAPTURE_I2S_SERIALIZER 0
+
+#define CAPTURE_BLOCK_WORDS (CAPTURE_BLOCK_SAMPLES * PDM_WORDS_PER_SAMPLE)  // PDM words per DMA block
+#define CAPTURE_DMA_BLOCKS 4                                            // DMA ring length in blocks
+#define CAPTURE_RING_SAMPLES 1024                                       // PCM history, power of two
+
+// Starts DMA capture; call after the PDM microphone has been configured
+bool audioCaptureBegin();
+
+// Stops the DMA and the I2S clock, which puts the microphone to sleep
+void audioCaptureStop();
+
+// Restarts the clock and the DMA ring after audioCaptureStop()
+bool audioCaptureResume();
+
+// Total PCM samples written since capture started (wraps at 2^32)
+uint32_t audioCaptureSamplesWritten();
+
+// Copies the newest 'count' PCM samples (oldest first) into 'dest'.
+// Returns false if fewer than 'count' samples have been captured yet.
+bool audioCaptureLatest(int16_t* dest, uint16_t count);
+
+// Level meter and AGC results from the newest block (see LevelMeter / MicAgc)
+uint16_t audioCaptureVolume();     // 0-15, 8.8 fixed point
+uint16_t audioCaptureThreshold();  // Quiet / sound boundary in volume units
+uint16_t audioCaptureLoudness();   // log2(rms), 8.8 fixed point
+uint16_t audioCapturePeak();       // Peak envelope, PCM units
+
+// Seeds the AGC from Config.mic_calibration (0 = not calibrated)
+void audioCaptureSetCalibration(uint32_t calibration);
+
+// Called from the capture interrupt when a double clap or knock pattern is
+// heard; keep it short and leave the real work to the main loop
+typedef void (*SoundGestureCallback)(SoundGesture gesture);
+void audioCaptureSetGestureCallback(SoundGestureCallback callback);
+
+// Mutes gesture callbacks, e.g. while the user is asked to make noise
+void audioCaptureEnableGestures(bool enabled);
+
+// Sequential frames for overlapped analysis. 'cursor' is the sample index
+// where the next frame ends (start it at 0). Copies the 'count' samples
+// ending at the cursor and advances it by 'hop'; returns false until they
+// have been captured. A reader that falls behind skips to the newest frame.
+bool audioCaptureFrame(int16_t* dest, uint16_t count, uint16_t hop, uint32_t &cursor);
+
+#endif  // AUDIOCAPTURE_H
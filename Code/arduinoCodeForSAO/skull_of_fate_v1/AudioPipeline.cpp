@@ -0,0 +1,531 @@
+// AudioPipeline.cpp
+
+#include "AudioPipeline.h"
+
+const uint16_t sincfilter[PDM_DECIMATION] = {
+  0, 2, 9, 21, 39, 63, 94, 132,
+  179, 236, 302, 379, 467, 565, 674, 792,
+  920, 1055, 1196, 1341, 1487, 1633, 1776, 1913,
+  2042, 2159, 2263, 2352, 2422, 2474, 2506, 2516,
+  2506, 2474, 2422, 2352, 2263, 2159, 2042, 1913,
+  1776, 1633, 1487, 1341, 1196, 1055, 920, 792,
+  674, 565, 467, 379, 302, 236, 179, 132,
+  94, 63, 39, 21, 9, 2, 0
+};
+
+// pdmByteSums[k][v] = sum of sincfilter[8k + b] for every bit b set in v.
+// Generated from sincfilter; const so it stays in flash.
+const uint16_t pdmByteSums[PDM_DECIMATION / 8][256] = {
+  // Taps 0-7
+  {
+    0, 0, 2, 2, 9, 9, 11, 11, 21, 21, 23, 23, 30, 30, 32, 32,
+    39, 39, 41, 41, 48, 48, 50, 50, 60, 60, 62, 62, 69, 69, 71, 71,
+    63, 63, 65, 65, 72, 72, 74, 74, 84, 84, 86, 86, 93, 93, 95, 95,
+    102, 102, 104, 104, 111, 111, 113, 113, 123, 123, 125, 125, 132, 132, 134, 134,
+    94, 94, 96, 96, 103, 103, 105, 105, 115, 115, 117, 117, 124, 124, 126, 126,
+    133, 133, 135, 135, 142, 142, 144, 144, 154, 154, 156, 156, 163, 163, 165, 165,
+    157, 157, 159, 159, 166, 166, 168, 168, 178, 178, 180, 180, 187, 187, 189, 189,
+    196, 196, 198, 198, 205, 205, 207, 207, 217, 217, 219, 219, 226, 226, 228, 228,
+    132, 132, 134, 134, 141, 141, 143, 143, 153, 153, 155, 155, 162, 162, 164, 164,
+    171, 171, 173, 173, 180, 180, 182, 182, 192, 192, 194, 194, 201, 201, 203, 203,
+    195, 195, 197, 197, 204, 204, 206, 206, 216, 216, 218, 218, 225, 225, 227, 227,
+    234, 234, 236, 236, 243, 243, 245, 245, 255, 255, 257, 257, 264, 264, 266, 266,
+    226, 226, 228, 228, 235, 235, 237, 237, 247, 247, 249, 249, 256, 256, 258, 258,
+    265, 265, 267, 267, 274, 274, 276, 276, 286, 286, 288, 288, 295, 295, 297, 297,
+    289, 289, 291, 291, 298, 298, 300, 300, 310, 310, 312, 312, 319, 319, 321, 321,
+    328, 328, 330, 330, 337, 337, 339, 339, 349, 349, 351, 351, 358, 358, 360, 360
+  },
+  // Taps 8-15
+  {
+    0, 179, 236, 415, 302, 481, 538, 717, 379, 558, 615, 794, 681, 860, 917, 1096,
+    467, 646, 703, 882, 769, 948, 1005, 1184, 846, 1025, 1082, 1261, 1148, 1327, 1384, 1563,
+    565, 744, 801, 980, 867, 1046, 1103, 1282, 944, 1123, 1180, 1359, 1246, 1425, 1482, 1661,
+    1032, 1211, 1268, 1447, 1334, 1513, 1570, 1749, 1411, 1590, 1647, 1826, 1713, 1892, 1949, 2128,
+    674, 853, 910, 1089, 976, 1155, 1212, 1391, 1053, 1232, 1289, 1468, 1355, 1534, 1591, 1770,
+    1141, 1320, 1377, 1556, 1443, 1622, 1679, 1858, 1520, 1699, 1756, 1935, 1822, 2001, 2058, 2237,
+    1239, 1418, 1475, 1654, 1541, 1720, 1777, 1956, 1618, 1797, 1854, 2033, 1920, 2099, 2156, 2335,
+    1706, 1885, 1942, 2121, 2008, 2187, 2244, 2423, 2085, 2264, 2321, 2500, 2387, 2566, 2623, 2802,
+    792, 971, 1028, 1207, 1094, 1273, 1330, 1509, 1171, 1350, 1407, 1586, 1473, 1652, 1709, 1888,
+    1259, 1438, 1495, 1674, 1561, 1740, 1797, 1976, 1638, 1817, 1874, 2053, 1940, 2119, 2176, 2355,
+    1357, 1536, 1593, 1772, 1659, 1838, 1895, 2074, 1736, 1915, 1972, 2151, 2038, 2217, 2274, 2453,
+    1824, 2003, 2060, 2239, 2126, 2305, 2362, 2541, 2203, 2382, 2439, 2618, 2505, 2684, 2741, 2920,
+    1466, 1645, 1702, 1881, 1768, 1947, 2004, 2183, 1845, 2024, 2081, 2260, 2147, 2326, 2383, 2562,
+    1933, 2112, 2169, 2348, 2235, 2414, 2471, 2650, 2312, 2491, 2548, 2727, 2614, 2793, 2850, 3029,
+    2031, 2210, 2267, 2446, 2333, 2512, 2569, 2748, 2410, 2589, 2646, 2825, 2712, 2891, 2948, 3127,
+    2498, 2677, 2734, 2913, 2800, 2979, 3036, 3215, 2877, 3056, 3113, 3292, 3179, 3358, 3415, 3594
+  },
+  // Taps 16-23
+  {
+    0, 920, 1055, 1975, 1196, 2116, 2251, 3171, 1341, 2261, 2396, 3316, 2537, 3457, 3592, 4512,
+    1487, 2407, 2542, 3462, 2683, 3603, 3738, 4658, 2828, 3748, 3883, 4803, 4024, 4944, 5079, 5999,
+    1633, 2553, 2688, 3608, 2829, 3749, 3884, 4804, 2974, 3894, 4029, 4949, 4170, 5090, 5225, 6145,
+    3120, 4040, 4175, 5095, 4316, 5236, 5371, 6291, 4461, 5381, 5516, 6436, 5657, 6577, 6712, 7632,
+    1776, 2696, 2831, 3751, 2972, 3892, 4027, 4947, 3117, 4037, 4172, 5092, 4313, 5233, 5368, 6288,
+    3263, 4183, 4318, 5238, 4459, 5379, 5514, 6434, 4604, 5524, 5659, 6579, 5800, 6720, 6855, 7775,
+    3409, 4329, 4464, 5384, 4605, 5525, 5660, 6580, 4750, 5670, 5805, 6725, 5946, 6866, 7001, 7921,
+    4896, 5816, 5951, 6871, 6092, 7012, 7147, 8067, 6237, 7157, 7292, 8212, 7433, 8353, 8488, 9408,
+    1913, 2833, 2968, 3888, 3109, 4029, 4164, 5084, 3254, 4174, 4309, 5229, 4450, 5370, 5505, 6425,
+    3400, 4320, 4455, 5375, 4596, 5516, 5651, 6571, 4741, 5661, 5796, 6716, 5937, 6857, 6992, 7912,
+    3546, 4466, 4601, 5521, 4742, 5662, 5797, 6717, 4887, 5807, 5942, 6862, 6083, 7003, 7138, 8058,
+    5033, 5953, 6088, 7008, 6229, 7149, 7284, 8204, 6374, 7294, 7429, 8349, 7570, 8490, 8625, 9545,
+    3689, 4609, 4744, 5664, 4885, 5805, 5940, 6860, 5030, 5950, 6085, 7005, 6226, 7146, 7281, 8201,
+    5176, 6096, 6231, 7151, 6372, 7292, 7427, 8347, 6517, 7437, 7572, 8492, 7713, 8633, 8768, 9688,
+    5322, 6242, 6377, 7297, 6518, 7438, 7573, 8493, 6663, 7583, 7718, 8638, 7859, 8779, 8914, 9834,
+    6809, 7729, 7864, 8784, 8005, 8925, 9060, 9980, 8150, 9070, 9205, 10125, 9346, 10266, 10401, 11321
+  },
+  // Taps 24-31
+  {
+    0, 2042, 2159, 4201, 2263, 4305, 4422, 6464, 2352, 4394, 4511, 6553, 4615, 6657, 6774, 8816,
+    2422, 4464, 4581, 6623, 4685, 6727, 6844, 8886, 4774, 6816, 6933, 8975, 7037, 9079, 9196, 11238,
+    2474, 4516, 4633, 6675, 4737, 6779, 6896, 8938, 4826, 6868, 6985, 9027, 7089, 9131, 9248, 11290,
+    4896, 6938, 7055, 9097, 7159, 9201, 9318, 11360, 7248, 9290, 9407, 11449, 9511, 11553, 11670, 13712,
+    2506, 4548, 4665, 6707, 4769, 6811, 6928, 8970, 4858, 6900, 7017, 9059, 7121, 9163, 9280, 11322,
+    4928, 6970, 7087, 9129, 7191, 9233, 9350, 11392, 7280, 9322, 9439, 11481, 9543, 11585, 11702, 13744,
+    4980, 7022, 7139, 9181, 7243, 9285, 9402, 11444, 7332, 9374, 9491, 11533, 9595, 11637, 11754, 13796,
+    7402, 9444, 9561, 11603, 9665, 11707, 11824, 13866, 9754, 11796, 11913, 13955, 12017, 14059, 14176, 16218,
+    2516, 4558, 4675, 6717, 4779, 6821, 6938, 8980, 4868, 6910, 7027, 9069, 7131, 9173, 9290, 11332,
+    4938, 6980, 7097, 9139, 7201, 9243, 9360, 11402, 7290, 9332, 9449, 11491, 9553, 11595, 11712, 13754,
+    4990, 7032, 7149, 9191, 7253, 9295, 9412, 11454, 7342, 9384, 9501, 11543, 9605, 11647, 11764, 13806,
+    7412, 9454, 9571, 11613, 9675, 11717, 11834, 13876, 9764, 11806, 11923, 13965, 12027, 14069, 14186, 16228,
+    5022, 7064, 7181, 9223, 7285, 9327, 9444, 11486, 7374, 9416, 9533, 11575, 9637, 11679, 11796, 13838,
+    7444, 9486, 9603, 11645, 9707, 11749, 11866, 13908, 9796, 11838, 11955, 13997, 12059, 14101, 14218, 16260,
+    7496, 9538, 9655, 11697, 9759, 11801, 11918, 13960, 9848, 11890, 12007, 14049, 12111, 14153, 14270, 16312,
+    9918, 11960, 12077, 14119, 12181, 14223, 14340, 16382, 12270, 14312, 14429, 16471, 14533, 16575, 16692, 18734
+  },
+  // Taps 32-39
+  {
+    0, 2506, 2474, 4980, 2422, 4928, 4896, 7402, 2352, 4858, 4826, 7332, 4774, 7280, 7248, 9754,
+    2263, 4769, 4737, 7243, 4685, 7191, 7159, 9665, 4615, 7121, 7089, 9595, 7037, 9543, 9511, 12017,
+    2159, 4665, 4633, 7139, 4581, 7087, 7055, 9561, 4511, 7017, 6985, 9491, 6933, 9439, 9407, 11913,
+    4422, 6928, 6896, 9402, 6844, 9350, 9318, 11824, 6774, 9280, 9248, 11754, 9196, 11702, 11670, 14176,
+    2042, 4548, 4516, 7022, 4464, 6970, 6938, 9444, 4394, 6900, 6868, 9374, 6816, 9322, 9290, 11796,
+    4305, 6811, 6779, 9285, 6727, 9233, 9201, 11707, 6657, 9163, 9131, 11637, 9079, 11585, 11553, 14059,
+    4201, 6707, 6675, 9181, 6623, 9129, 9097, 11603, 6553, 9059, 9027, 11533, 8975, 11481, 11449, 13955,
+    6464, 8970, 8938, 11444, 8886, 11392, 11360, 13866, 8816, 11322, 11290, 13796, 11238, 13744, 13712, 16218,
+    1913, 4419, 4387, 6893, 4335, 6841, 6809, 9315, 4265, 6771, 6739, 9245, 6687, 9193, 9161, 11667,
+    4176, 6682, 6650, 9156, 6598, 9104, 9072, 11578, 6528, 9034, 9002, 11508, 8950, 11456, 11424, 13930,
+    4072, 6578, 6546, 9052, 6494, 9000, 8968, 11474, 6424, 8930, 8898, 11404, 8846, 11352, 11320, 13826,
+    6335, 8841, 8809, 11315, 8757, 11263, 11231, 13737, 8687, 11193, 11161, 13667, 11109, 13615, 13583, 16089,
+    3955, 6461, 6429, 8935, 6377, 8883, 8851, 11357, 6307, 8813, 8781, 11287, 8729, 11235, 11203, 13709,
+    6218, 8724, 8692, 11198, 8640, 11146, 11114, 13620, 8570, 11076, 11044, 13550, 10992, 13498, 13466, 15972,
+    6114, 8620, 8588, 11094, 8536, 11042, 11010, 13516, 8466, 10972, 10940, 13446, 10888, 13394, 13362, 15868,
+    8377, 10883, 10851, 13357, 10799, 13305, 13273, 15779, 10729, 13235, 13203, 15709, 13151, 15657, 15625, 18131
+  },
+  // Taps 40-47
+  {
+    0, 1776, 1633, 3409, 1487, 3263, 3120, 4896, 1341, 3117, 2974, 4750, 2828, 4604, 4461, 6237,
+    1196, 2972, 2829, 4605, 2683, 4459, 4316, 6092, 2537, 4313, 4170, 5946, 4024, 5800, 5657, 7433,
+    1055, 2831, 2688, 4464, 2542, 4318, 4175, 5951, 2396, 4172, 4029, 5805, 3883, 5659, 5516, 7292,
+    2251, 4027, 3884, 5660, 3738, 5514, 5371, 7147, 3592, 5368, 5225, 7001, 5079, 6855, 6712, 8488,
+    920, 2696, 2553, 4329, 2407, 4183, 4040, 5816, 2261, 4037, 3894, 5670, 3748, 5524, 5381, 7157,
+    2116, 3892, 3749, 5525, 3603, 5379, 5236, 7012, 3457, 5233, 5090, 6866, 4944, 6720, 6577, 8353,
+    1975, 3751, 3608, 5384, 3462, 5238, 5095, 6871, 3316, 5092, 4949, 6725, 4803, 6579, 6436, 8212,
+    3171, 4947, 4804, 6580, 4658, 6434, 6291, 8067, 4512, 6288, 6145, 7921, 5999, 7775, 7632, 9408,
+    792, 2568, 2425, 4201, 2279, 4055, 3912, 5688, 2133, 3909, 3766, 5542, 3620, 5396, 5253, 7029,
+    1988, 3764, 3621, 5397, 3475, 5251, 5108, 6884, 3329, 5105, 4962, 6738, 4816, 6592, 6449, 8225,
+    1847, 3623, 3480, 5256, 3334, 5110, 4967, 6743, 3188, 4964, 4821, 6597, 4675, 6451, 6308, 8084,
+    3043, 4819, 4676, 6452, 4530, 6306, 6163, 7939, 4384, 6160, 6017, 7793, 5871, 7647, 7504, 9280,
+    1712, 3488, 3345, 5121, 3199, 4975, 4832, 6608, 3053, 4829, 4686, 6462, 4540, 6316, 6173, 7949,
+    2908, 4684, 4541, 6317, 4395, 6171, 6028, 7804, 4249, 6025, 5882, 7658, 5736, 7512, 7369, 9145,
+    2767, 4543, 4400, 6176, 4254, 6030, 5887, 7663, 4108, 5884, 5741, 7517, 5595, 7371, 7228, 9004,
+    3963, 5739, 5596, 7372, 5450, 7226, 7083, 8859, 5304, 7080, 6937, 8713, 6791, 8567, 8424, 10200
+  },
+  // Taps 48-55
+  {
+    0, 674, 565, 1239, 467, 1141, 1032, 1706, 379, 1053, 944, 1618, 846, 1520, 1411, 2085,
+    302, 976, 867, 1541, 769, 1443, 1334, 2008, 681, 1355, 1246, 1920, 1148, 1822, 1713, 2387,
+    236, 910, 801, 1475, 703, 1377, 1268, 1942, 615, 1289, 1180, 1854, 1082, 1756, 1647, 2321,
+    538, 1212, 1103, 1777, 1005, 1679, 1570, 2244, 917, 1591, 1482, 2156, 1384, 2058, 1949, 2623,
+    179, 853, 744, 1418, 646, 1320, 1211, 1885, 558, 1232, 1123, 1797, 1025, 1699, 1590, 2264,
+    481, 1155, 1046, 1720, 948, 1622, 1513, 2187, 860, 1534, 1425, 2099, 1327, 2001, 1892, 2566,
+    415, 1089, 980, 1654, 882, 1556, 1447, 2121, 794, 1468, 1359, 2033, 1261, 1935, 1826, 2500,
+    717, 1391, 1282, 1956, 1184, 1858, 1749, 2423, 1096, 1770, 1661, 2335, 1563, 2237, 2128, 2802,
+    132, 806, 697, 1371, 599, 1273, 1164, 1838, 511, 1185, 1076, 1750, 978, 1652, 1543, 2217,
+    434, 1108, 999, 1673, 901, 1575, 1466, 2140, 813, 1487, 1378, 2052, 1280, 1954, 1845, 2519,
+    368, 1042, 933, 1607, 835, 1509, 1400, 2074, 747, 1421, 1312, 1986, 1214, 1888, 1779, 2453,
+    670, 1344, 1235, 1909, 1137, 1811, 1702, 2376, 1049, 1723, 1614, 2288, 1516, 2190, 2081, 2755,
+    311, 985, 876, 1550, 778, 1452, 1343, 2017, 690, 1364, 1255, 1929, 1157, 1831, 1722, 2396,
+    613, 1287, 1178, 1852, 1080, 1754, 1645, 2319, 992, 1666, 1557, 2231, 1459, 2133, 2024, 2698,
+    547, 1221, 1112, 1786, 1014, 1688, 1579, 2253, 926, 1600, 1491, 2165, 1393, 2067, 1958, 2632,
+    849, 1523, 1414, 2088, 1316, 1990, 1881, 2555, 1228, 1902, 1793, 2467, 1695, 2369, 2260, 2934
+  },
+  // Taps 56-63
+  {
+    0, 94, 63, 157, 39, 133, 102, 196, 21, 115, 84, 178, 60, 154, 123, 217,
+    9, 103, 72, 166, 48, 142, 111, 205, 30, 124, 93, 187, 69, 163, 132, 226,
+    2, 96, 65, 159, 41, 135, 104, 198, 23, 117, 86, 180, 62, 156, 125, 219,
+    11, 105, 74, 168, 50, 144, 113, 207, 32, 126, 95, 189, 71, 165, 134, 228,
+    0, 94, 63, 157, 39, 133, 102, 196, 21, 115, 84, 178, 60, 154, 123, 217,
+    9, 103, 72, 166, 48, 142, 111, 205, 30, 124, 93, 187, 69, 163, 132, 226,
+    2, 96, 65, 159, 41, 135, 104, 198, 23, 117, 86, 180, 62, 156, 125, 219,
+    11, 105, 74, 168, 50, 144, 113, 207, 32, 126, 95, 189, 71, 165, 134, 228,
+    0, 94, 63, 157, 39, 133, 102, 196, 21, 115, 84, 178, 60, 154, 123, 217,
+    9, 103, 72, 166, 48, 142, 111, 205, 30, 124, 93, 187, 69, 163, 132, 226,
+    2, 96, 65, 159, 41, 135, 104, 198, 23, 117, 86, 180, 62, 156, 125, 219,
+    11, 105, 74, 168, 50, 144, 113, 207, 32, 126, 95, 189, 71, 165, 134, 228,
+    0, 94, 63, 157, 39, 133, 102, 196, 21, 115, 84, 178, 60, 154, 123, 217,
+    9, 103, 72, 166, 48, 142, 111, 205, 30, 124, 93, 187, 69, 163, 132, 226,
+    2, 96, 65, 159, 41, 135, 104, 198, 23, 117, 86, 180, 62, 156, 125, 219,
+    11, 105, 74, 168, 50, 144, 113, 207, 32, 126, 95, 189, 71, 165, 134, 228
+  }
+};
+
+int16_t pdmDecimate(const uint16_t* words) {
+  uint32_t runningsum = 0;
+  const uint16_t (*table)[256] = pdmByteSums;
+
+  for (uint8_t w = 0; w < PDM_WORDS_PER_SAMPLE; w++) {
+    uint16_t sample = words[w];
+    runningsum += table[0][sample & 0xFF];  // Bits 0-7 of the word
+    runningsum += table[1][sample >> 8];    // Bits 8-15
+    table += 2;
+  }
+
+  // Normalize the running sum
+  runningsum /= PDM_DECIMATION;
+
+  return (int16_t)runningsum - 32768;  // Center around zero
+}
+
+void pdmDecimateBlock(const uint16_t* words, int16_t* pcm, int count) {
+  for (int i = 0; i < count; i++) {
+    pcm[i] = pdmDecimate(words);
+    words += PDM_WORDS_PER_SAMPLE;
+  }
+}
+
+// Hann window, 0.5 * (1 - cos(2 pi i / 512)) in Q15
+const int16_t hannWindow[ANALYZER_MAX_FFT_SIZE] = {
+  0, 1, 5, 11, 20, 31, 44, 60, 79, 100, 123, 149, 177, 208, 241, 277,
+  315, 355, 398, 443, 491, 541, 593, 648, 705, 765, 827, 891, 958, 1027, 1098, 1171,
+  1247, 1325, 1406, 1488, 1573, 1660, 1749, 1841, 1935, 2030, 2128, 2229, 2331, 2435, 2542, 2650,
+  2761, 2874, 2989, 3105, 3224, 3345, 3468, 3592, 3719, 3847, 3978, 4110, 4244, 4380, 4518, 4657,
+  4799, 4942, 5086, 5233, 5381, 5531, 5682, 5835, 5990, 6146, 6304, 6463, 6624, 6786, 6950, 7115,
+  7281, 7449, 7618, 7789, 7961, 8134, 8308, 8484, 8660, 8838, 9017, 9197, 9379, 9561, 9744, 9929,
+  10114, 10300, 10487, 10675, 10864, 11054, 11244, 11436, 11628, 11820, 12014, 12208, 12403, 12598, 12794, 12990,
+  13187, 13385, 13583, 13781, 13980, 14179, 14378, 14578, 14778, 14978, 15178, 15379, 15580, 15780, 15981, 16182,
+  16383, 16585, 16786, 16987, 17187, 17388, 17589, 17789, 17989, 18189, 18389, 18588, 18787, 18986, 19184, 19382,
+  19580, 19777, 19973, 20169, 20364, 20559, 20753, 20947, 21139, 21331, 21523, 21713, 21903, 22092, 22280, 22467,
+  22653, 22838, 23023, 23206, 23388, 23570, 23750, 23929, 24107, 24283, 24459, 24633, 24806, 24978, 25149, 25318,
+  25486, 25652, 25817, 25981, 26143, 26304, 26463, 26621, 26777, 26932, 27085, 27236, 27386, 27534, 27681, 27825,
+  27968, 28110, 28249, 28387, 28523, 28657, 28789, 28920, 29048, 29175, 29299, 29422, 29543, 29662, 29778, 29893,
+  30006, 30117, 30225, 30332, 30436, 30538, 30639, 30737, 30832, 30926, 31018, 31107, 31194, 31279, 31361, 31442,
+  31520, 31596, 31669, 31740, 31809, 31876, 31940, 32002, 32062, 32119, 32174, 32226, 32276, 32324, 32369, 32412,
+  32452, 32490, 32526, 32559, 32590, 32618, 32644, 32667, 32688, 32707, 32723, 32736, 32747, 32756, 32762, 32766,
+  32767, 32766, 32762, 32756, 32747, 32736, 32723, 32707, 32688, 32667, 32644, 32618, 32590, 32559, 32526, 32490,
+  32452, 32412, 32369, 32324, 32276, 32226, 32174, 32119, 32062, 32002, 31940, 31876, 31809, 31740, 31669, 31596,
+  31520, 31442, 31361, 31279, 31194, 31107, 31018, 30926, 30832, 30737, 30639, 30538, 30436, 30332, 30225, 30117,
+  30006, 29893, 29778, 29662, 29543, 29422, 29299, 29175, 29048, 28920, 28789, 28657, 28523, 28387, 28249, 28110,
+  27968, 27825, 27681, 27534, 27386, 27236, 27085, 26932, 26777, 26621, 26463, 26304, 26143, 25981, 25817, 25652,
+  25486, 25318, 25149, 24978, 24806, 24633, 24459, 24283, 24107, 23929, 23750, 23570, 23388, 23206, 23023, 22838,
+  22653, 22467, 22280, 22092, 21903, 21713, 21523, 21331, 21139, 20947, 20753, 20559, 20364, 20169, 19973, 19777,
+  19580, 19382, 19184, 18986, 18787, 18588, 18389, 18189, 17989, 17789, 17589, 17388, 17187, 16987, 16786, 16585,
+  16384, 16182, 15981, 15780, 15580, 15379, 15178, 14978, 14778, 14578, 14378, 14179, 13980, 13781, 13583, 13385,
+  13187, 12990, 12794, 12598, 12403, 12208, 12014, 11820, 11628, 11436, 11244, 11054, 10864, 10675, 10487, 10300,
+  10114, 9929, 9744, 9561, 9379, 9197, 9017, 8838, 8660, 8484, 8308, 8134, 7961, 7789, 7618, 7449,
+  7281, 7115, 6950, 6786, 6624, 6463, 6304, 6146, 5990, 5835, 5682, 5531, 5381, 5233, 5086, 4942,
+  4799, 4657, 4518, 4380, 4244, 4110, 3978, 3847, 3719, 3592, 3468, 3345, 3224, 3105, 2989, 2874,
+  2761, 2650, 2542, 2435, 2331, 2229, 2128, 2030, 1935, 1841, 1749, 1660, 1573, 1488, 1406, 1325,
+  1247, 1171, 1098, 1027, 958, 891, 827, 765, 705, 648, 593, 541, 491, 443, 398, 355,
+  315, 277, 241, 208, 177, 149, 123, 100, 79, 60, 44, 31, 20, 11, 5, 1
+};
+
+// sin(2 pi i / 512) in Q15
+const int16_t sineTable[ANALYZER_MAX_FFT_SIZE] = {
+  0, 402, 804, 1206, 1608, 2009, 2410, 2811, 3212, 3612, 4011, 4410, 4808, 5205, 5602, 5998,
+  6393, 6786, 7179, 7571, 7962, 8351, 8739, 9126, 9512, 9896, 10278, 10659, 11039, 11417, 11793, 12167,
+  12539, 12910, 13279, 13645, 14010, 14372, 14732, 15090, 15446, 15800, 16151, 16499, 16846, 17189, 17530, 17869,
+  18204, 18537, 18868, 19195, 19519, 19841, 20159, 20475, 20787, 21096, 21403, 21705, 22005, 22301, 22594, 22884,
+  23170, 23452, 23731, 24007, 24279, 24547, 24811, 25072, 25329, 25582, 25832, 26077, 26319, 26556, 26790, 27019,
+  27245, 27466, 27683, 27896, 28105, 28310, 28510, 28706, 28898, 29085, 29268, 29447, 29621, 29791, 29956, 30117,
+  30273, 30424, 30571, 30714, 30852, 30985, 31113, 31237, 31356, 31470, 31580, 31685, 31785, 31880, 31971, 32057,
+  32137, 32213, 32285, 32351, 32412, 32469, 32521, 32567, 32609, 32646, 32678, 32705, 32728, 32745, 32757, 32765,
+  32767, 32765, 32757, 32745, 32728, 32705, 32678, 32646, 32609, 32567, 32521, 32469, 32412, 32351, 32285, 32213,
+  32137, 32057, 31971, 31880, 31785, 31685, 31580, 31470, 31356, 31237, 31113, 30985, 30852, 30714, 30571, 30424,
+  30273, 30117, 29956, 29791, 29621, 29447, 29268, 29085, 28898, 28706, 28510, 28310, 28105, 27896, 27683, 27466,
+  27245, 27019, 26790, 26556, 26319, 26077, 25832, 25582, 25329, 25072, 24811, 24547, 24279, 24007, 23731, 23452,
+  23170, 22884, 22594, 22301, 22005, 21705, 21403, 21096, 20787, 20475, 20159, 19841, 19519, 19195, 18868, 18537,
+  18204, 17869, 17530, 17189, 16846, 16499, 16151, 15800, 15446, 15090, 14732, 14372, 14010, 13645, 13279, 12910,
+  12539, 12167, 11793, 11417, 11039, 10659, 10278, 9896, 9512, 9126, 8739, 8351, 7962, 7571, 7179, 6786,
+  6393, 5998, 5602, 5205, 4808, 4410, 4011, 3612, 3212, 2811, 2410, 2009, 1608, 1206, 804, 402,
+  0, -402, -804, -1206, -1608, -2009, -2410, -2811, -3212, -3612, -4011, -4410, -4808, -5205, -5602, -5998,
+  -6393, -6786, -7179, -7571, -7962, -8351, -8739, -9126, -9512, -9896, -10278, -10659, -11039, -11417, -11793, -12167,
+  -12539, -12910, -13279, -13645, -14010, -14372, -14732, -15090, -15446, -15800, -16151, -16499, -16846, -17189, -17530, -17869,
+  -18204, -18537, -18868, -19195, -19519, -19841, -20159, -20475, -20787, -21096, -21403, -21705, -22005, -22301, -22594, -22884,
+  -23170, -23452, -23731, -24007, -24279, -24547, -24811, -25072, -25329, -25582, -25832, -26077, -26319, -26556, -26790, -27019,
+  -27245, -27466, -27683, -27896, -28105, -28310, -28510, -28706, -28898, -29085, -29268, -29447, -29621, -29791, -29956, -30117,
+  -30273, -30424, -30571, -30714, -30852, -30985, -31113, -31237, -31356, -31470, -31580, -31685, -31785, -31880, -31971, -32057,
+  -32137, -32213, -32285, -32351, -32412, -32469, -32521, -32567, -32609, -32646, -32678, -32705, -32728, -32745, -32757, -32765,
+  -32767, -32765, -32757, -32745, -32728, -32705, -32678, -32646, -32609, -32567, -32521, -32469, -32412, -32351, -32285, -32213,
+  -32137, -32057, -31971, -31880, -31785, -31685, -31580, -31470, -31356, -31237, -31113, -30985, -30852, -30714, -30571, -30424,
+  -30273, -30117, -29956, -29791, -29621, -29447, -29268, -29085, -28898, -28706, -28510, -28310, -28105, -27896, -27683, -27466,
+  -27245, -27019, -26790, -26556, -26319, -26077, -25832, -25582, -25329, -25072, -24811, -24547, -24279, -24007, -23731, -23452,
+  -23170, -22884, -22594, -22301, -22005, -21705, -21403, -21096, -20787, -20475, -20159, -19841, -19519, -19195, -18868, -18537,
+  -18204, -17869, -17530, -17189, -16846, -16499, -16151, -15800, -15446, -15090, -14732, -14372, -14010, -13645, -13279, -12910,
+  -12539, -12167, -11793, -11417, -11039, -10659, -10278, -9896, -9512, -9126, -8739, -8351, -7962, -7571, -7179, -6786,
+  -6393, -5998, -5602, -5205, -4808, -4410, -4011, -3612, -3212, -2811, -2410, -2009, -1608, -1206, -804, -402
+};
+
+void fftQ15(int16_t* re, int16_t* im, uint16_t n) {
+  // Bit-reverse reorder
+  for (uint16_t i = 1, j = 0; i < n; i++) {
+    uint16_t bit = n >> 1;
+    for (; j & bit; bit >>= 1) {
+      j ^= bit;
+    }
+    j ^= bit;
+    if (i < j) {
+      int16_t t = re[i];
+      re[i] = re[j];
+      re[j] = t;
+      t = im[i];
+      im[i] = im[j];
+      im[j] = t;
+    }
+  }
+
+  // Butterflies, scaling by 1/2 per stage so nothing overflows
+  for (uint16_t size = 2; size <= n; size <<= 1) {
+    uint16_t half = size >> 1;
+    uint16_t step = ANALYZER_MAX_FFT_SIZE / size;
+    for (uint16_t j = 0; j < half; j++) {
+      int32_t wr = sineTable[(j * step + ANALYZER_MAX_FFT_SIZE / 4) & (ANALYZER_MAX_FFT_SIZE - 1)];  // cos
+      int32_t wi = sineTable[j * step];                                                             // sin
+      for (uint16_t i = j; i < n; i += size) {
+        uint16_t k = i + half;
+        // x[k] * e^(-j angle)
+        int32_t tr = (re[k] * wr + im[k] * wi) >> 15;
+        int32_t ti = (im[k] * wr - re[k] * wi) >> 15;
+        re[k] = (re[i] - tr) >> 1;
+        im[k] = (im[i] - ti) >> 1;
+        re[i] = (re[i] + tr) >> 1;
+        im[i] = (im[i] + ti) >> 1;
+      }
+    }
+  }
+}
+
+uint16_t isqrt32(uint32_t value) {
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > value) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+// 256 * log2(1 + i / 32)
+static const uint8_t log2Mantissa[32] = {
+  0, 11, 22, 33, 44, 54, 63, 73, 82, 92, 100, 109, 118, 126, 134, 142,
+  150, 157, 165, 172, 179, 186, 193, 200, 207, 213, 220, 226, 232, 238, 244, 250
+};
+
+uint16_t log2Q8(uint32_t value) {
+  if (value < 2) {
+    return 0;
+  }
+
+  // Integer part from the top set bit, fraction from the next five bits
+  uint8_t exponent = 31;
+  for (uint8_t shift = 16; shift; shift >>= 1) {
+    if (!(value >> (32 - shift))) {
+      value <<= shift;
+      exponent -= shift;
+    }
+  }
+  return (exponent << 8) + log2Mantissa[(value >> 26) & 0x1F];
+}
+
+void spectrumLevels(const uint16_t* magnitude, uint16_t* levels, uint16_t bins, int32_t &agcMax) {
+  // Log magnitudes and the loudest bin of this frame
+  uint16_t maxCurr = 0;
+  for (uint16_t i = 1; i < bins; i++) {
+    levels[i] = log2Q8(magnitude[i]);
+    if (levels[i] > maxCurr) {
+      maxCurr = levels[i];
+    }
+  }
+
+  // Running maximum: jump up to a louder frame, decay towards quieter ones
+  int32_t target = (int32_t)maxCurr << 8;
+  if (target > agcMax) {
+    agcMax = target;
+  } else {
+    agcMax += ((target - agcMax) * SPECTRUM_AGC_DECAY) >> 8;
+  }
+
+  // Scale so the running maximum maps to 15; one division per frame
+  int32_t maxLog = agcMax >> 8;
+  if (maxLog < 256) {
+    maxLog = 256;  // Keep silence from blowing up the scale
+  }
+  uint32_t scale = ((uint32_t)SPECTRUM_LEVEL_MAX << 12) / maxLog;
+  for (uint16_t i = 1; i < bins; i++) {
+    uint32_t level = (levels[i] * scale) >> 12;
+    levels[i] = level > SPECTRUM_LEVEL_MAX ? SPECTRUM_LEVEL_MAX : level;
+  }
+}
+
+// Roughly half an octave per band from 60 Hz to 8 kHz
+const uint16_t bandEdgesHz[SPECTRUM_BANDS + 1] = {
+  60, 100, 160, 250, 400, 640, 1000, 1600, 2500, 4000, 8000
+};
+
+void bandEnergiesUpdate(BandEnergies &bands, const uint16_t* levels, uint16_t fftSize, uint16_t sampleRate) {
+  uint16_t bins = fftSize / 2;
+  uint16_t first = ((uint32_t)bandEdgesHz[0] * fftSize) / sampleRate;
+  if (first < 1) {
+    first = 1;  // Skip DC
+  }
+
+  uint32_t bass = 0;
+  uint32_t mid = 0;
+  uint32_t treble = 0;
+
+  for (uint8_t b = 0; b < SPECTRUM_BANDS; b++) {
+    uint16_t last = ((uint32_t)bandEdgesHz[b + 1] * fftSize) / sampleRate;
+    if (last > bins) {
+      last = bins;
+    }
+    if (last <= first) {
+      last = first + 1;  // Small FFTs: at least one bin per band
+    }
+
+    // Band energy is the mean level of its bins
+    uint32_t sum = 0;
+    for (uint16_t i = first; i < last && i < bins; i++) {
+      sum += levels[i];
+    }
+    uint16_t energy = sum / (last - first);
+    bands.energy[b] = energy;
+    first = last;
+
+    // Bars jump up and fall back slowly
+    if (energy >= bands.level[b]) {
+      bands.level[b] = energy;
+    } else {
+      bands.level[b] = bands.level[b] > energy + BAND_FALL ? bands.level[b] - BAND_FALL : energy;
+    }
+
+    // Peaks hold for a while, then fall onto the bar
+    if (bands.level[b] >= bands.peak[b]) {
+      bands.peak[b] = bands.level[b];
+      bands.peakHold[b] = BAND_PEAK_HOLD_FRAMES;
+    } else if (bands.peakHold[b] > 0) {
+      bands.peakHold[b]--;
+    } else {
+      uint16_t fallen = bands.peak[b] > BAND_PEAK_FALL ? bands.peak[b] - BAND_PEAK_FALL : 0;
+      bands.peak[b] = fallen > bands.level[b] ? fallen : bands.level[b];
+    }
+
+    if (b < BASS_BANDS) {
+      bass += bands.level[b];
+    } else if (b < TREBLE_START_BAND) {
+      mid += bands.level[b];
+    } else {
+      treble += bands.level[b];
+    }
+  }
+
+  bands.bass = bass / BASS_BANDS;
+  bands.mid = mid / (TREBLE_START_BAND - BASS_BANDS);
+  bands.treble = treble / (SPECTRUM_BANDS - TREBLE_START_BAND);
+}
+
+void levelMeterBlock(LevelMeter &meter, const int16_t* pcm, uint16_t count) {
+  if (!meter.started) {
+    meter.dc = (int32_t)pcm[0] << 8;
+    meter.started = true;
+  }
+
+  uint64_t sumSquares = 0;
+  uint16_t blockPeak = 0;
+  uint8_t crossings = 0;
+  for (uint16_t i = 0; i < count; i++) {
+    meter.dc += (((int32_t)pcm[i] << 8) - meter.dc) >> METER_DC_SHIFT;
+    int32_t ac = pcm[i] - (meter.dc >> 8);
+    if (ac > 32767) {
+      ac = 32767;
+    } else if (ac < -32767) {
+      ac = -32767;
+    }
+    if ((ac >= 0) != meter.positive) {
+      meter.positive = ac >= 0;
+      crossings++;
+    }
+    uint16_t magnitude = ac < 0 ? -ac : ac;
+    if (magnitude > blockPeak) {
+      blockPeak = magnitude;
+    }
+    sumSquares += (uint32_t)(ac * ac);
+  }
+
+  meter.crossings = crossings;
+  uint32_t meanSquare = sumSquares / count;
+  meter.rms = isqrt32(meanSquare);
+  meter.loudness = log2Q8(meanSquare) / 2;  // log2(rms) with the precision of the mean square
+
+  if (blockPeak >= meter.peak) {
+    meter.peak = blockPeak;
+  } else {
+    meter.peak -= (meter.peak - blockPeak) >> METER_PEAK_DECAY_SHIFT;
+  }
+}
+
+void micAgcBegin(MicAgc &agc, uint32_t calibration) {
+  uint16_t floor = calibration & 0xFFFF;
+  uint16_t loud = calibration >> 16;
+  if (calibration == 0 || loud < floor + MIC_MIN_RANGE) {
+    floor = MIC_DEFAULT_FLOOR;
+    loud = MIC_DEFAULT_LOUD;
+  }
+  agc.floor = (int32_t)floor << 8;
+  agc.loud = (int32_t)loud << 8;
+}
+
+uint32_t micCalibrationPack(uint16_t floor, uint16_t loud) {
+  if (loud < floor + MIC_MIN_RANGE) {
+    loud = floor + MIC_MIN_RANGE;
+  }
+  return ((uint32_t)loud << 16) | floor;
+}
+
+uint16_t micAgcUpdate(MicAgc &agc, uint16_t loudness) {
+  int32_t level = (int32_t)loudness << 8;
+
+  // Floor: falls quickly onto quiet frames, rises slowly when the room gets louder
+  if (level < agc.floor) {
+    agc.floor += (level - agc.floor) >> MIC_FLOOR_FALL_SHIFT;
+  } else {
+    agc.floor += (level - agc.floor) >> MIC_FLOOR_RISE_SHIFT;
+  }
+
+  // Loud level: jumps to louder frames, decays slowly, keeps a minimum range
+  if (level > agc.loud) {
+    agc.loud = level;
+  } else {
+    agc.loud += (level - agc.loud) >> MIC_LOUD_DECAY_SHIFT;
+  }
+  if (agc.loud < agc.floor + ((int32_t)MIC_MIN_RANGE << 8)) {
+    agc.loud = agc.floor + ((int32_t)MIC_MIN_RANGE << 8);
+  }
+
+  if (level <= agc.floor) {
+    return 0;
+  }
+  int32_t volume = ((level - agc.floor) >> 8) * SPECTRUM_LEVEL_MAX / ((agc.loud - agc.floor) >> 8);
+  return volume > SPECTRUM_LEVEL_MAX ? SPECTRUM_LEVEL_MAX : volume;
+}
+
+uint16_t micAgcThreshold(const MicAgc &agc) {
+  return (int32_t)MIC_NOISE_MARGIN * SPECTRUM_LEVEL_MAX / ((agc.loud - agc.floor) >> 8);
+}
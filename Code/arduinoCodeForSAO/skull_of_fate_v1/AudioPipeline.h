@@ -0,0 +1,190 @@
+// AudioPipeline.h
+
+#ifndef AUDIOPIPELINE_H
+#define AUDIOPIPELINE_H
+
+#include <stdint.h>
+
+// Audio processing shared by the sketch and the host test harness.
+// Nothing in here touches the Arduino core or the SAMD peripherals.
+
+// PDM decimation: 64 PDM bits (four 16-bit words, first bit in bit 0)
+// filtered down to one PCM sample
+#define PDM_DECIMATION 64
+#define PDM_WORDS_PER_SAMPLE (PDM_DECIMATION / 16)
+#define SAMPLE_RATE 16000         // PCM rate after decimation
+#define CAPTURE_BLOCK_SAMPLES 64  // PCM samples decimated per capture block (4 ms)
+
+// Original 64-tap sinc filter; the per-byte table in AudioPipeline.cpp is built from it
+extern const uint16_t sincfilter[PDM_DECIMATION];
+
+// One PCM sample from PDM_WORDS_PER_SAMPLE words.
+// Eight table lookups, bit-exact with summing sincfilter taps for every set bit.
+int16_t pdmDecimate(const uint16_t* words);
+
+// 'count' PCM samples from count * PDM_WORDS_PER_SAMPLE words
+void pdmDecimateBlock(const uint16_t* words, int16_t* pcm, int count);
+
+// Spectrum analysis: FFT frames of 64-512 samples, Hann windowed,
+// consecutive frames overlap by half (hop = N / 2)
+#define ANALYZER_MAX_FFT_SIZE 512
+#define FFT_SIZE 256  // Frame size the sketch analyzes at (62.5 Hz per bin)
+#define ANALYZER_INPUT_SHIFT 5  // Decimated PCM swings about +/-512; scale it up towards Q15
+
+// Flash tables for the largest FFT; smaller sizes step through them
+extern const int16_t hannWindow[ANALYZER_MAX_FFT_SIZE];  // Q15
+extern const int16_t sineTable[ANALYZER_MAX_FFT_SIZE];   // Q15, one full turn
+
+// In-place radix-2 fixed-point FFT; halves the data every stage (output = DFT / n)
+void fftQ15(int16_t* re, int16_t* im, uint16_t n);
+
+// Integer square root
+uint16_t isqrt32(uint32_t value);
+
+// |re + j im| by alpha-max-plus-beta-min (15/16 max + 15/32 min), within 6.2%
+static inline uint16_t magnitudeApprox(int32_t re, int32_t im) {
+  uint32_t a = re < 0 ? -re : re;
+  uint32_t b = im < 0 ? -im : im;
+  uint32_t hi = a > b ? a : b;
+  uint32_t lo = a > b ? b : a;
+  uint32_t mag = (hi * 30 + lo * 15 + 16) >> 5;
+  return mag > 65535 ? 65535 : mag;
+}
+
+// log2(value) in 8.8 fixed point from a 32-entry table (0 for 0 and 1)
+uint16_t log2Q8(uint32_t value);
+
+// Log spectrum levels, 0-15 in 8.8 fixed point, scaled against a running
+// maximum that jumps up instantly and decays back over about 20 frames
+#define SPECTRUM_LEVEL_MAX (15 << 8)
+#define SPECTRUM_AGC_START (14 << 16)  // Initial running maximum: log2 = 14, 8.16 fixed point
+#define SPECTRUM_AGC_DECAY 13           // Decay weight per frame, /256 (~0.05)
+
+// Fills levels[1..bins-1] from magnitude[1..bins-1] (bin 0 is DC and is left alone).
+// agcMax holds the running maximum between frames; start it at SPECTRUM_AGC_START.
+void spectrumLevels(const uint16_t* magnitude, uint16_t* levels, uint16_t bins, int32_t &agcMax);
+
+// Time-domain level meter on decimated PCM, cheap enough to run on every
+// capture block: tracks and removes DC, then takes the block RMS, a
+// decaying peak and the zero-crossing count. Loudness is log2 of the RMS
+// in 8.8 fixed point.
+#define METER_DC_SHIFT 8          // DC tracker time constant: 256 samples (16 ms at 16 kHz)
+#define METER_PEAK_DECAY_SHIFT 4  // Peak falls 1/16 of the way per block
+
+struct LevelMeter {
+  int32_t dc;         // DC estimate, PCM << 8
+  bool started;
+  uint16_t rms;       // Last block
+  uint16_t peak;      // Peak envelope
+  uint16_t loudness;  // log2(rms), 8.8
+  uint8_t crossings;  // Sign changes in the last block (rough brightness of the sound)
+  bool positive;      // Sign of the last sample
+};
+
+// Measures one block of PCM
+void levelMeterBlock(LevelMeter &meter, const int16_t* pcm, uint16_t count);
+
+// Microphone AGC. Follows the ambient noise floor and the loud level of the
+// meter loudness (8.8 log2) and maps loudness between the two onto 0-15,
+// so sound-reactive thresholds hold in a quiet room and on a noisy floor alike.
+// Updated once per capture block (250 per second).
+// A calibration packs the measured floor (low 16 bits) and loud level (high 16 bits).
+// The uncalibrated starting point is set from the harness: room hiss
+// measures 0-1 and loud music 5-6 on the PCM loudness scale.
+#define MIC_DEFAULT_FLOOR (1 << 8)  // Uncalibrated starting point
+#define MIC_DEFAULT_LOUD (5 << 8)
+#define MIC_MIN_RANGE 512           // Loud level stays 2 log2 steps (12 dB) above the floor
+#define MIC_NOISE_MARGIN 192        // Sound counts once it is ~4.5 dB above the floor
+#define MIC_FLOOR_FALL_SHIFT 5      // Floor drops 1/32 of the way per block onto quieter blocks
+#define MIC_FLOOR_RISE_SHIFT 12     // and creeps up 1/4096 per block (~16 s) otherwise
+#define MIC_LOUD_DECAY_SHIFT 11     // Loud level jumps up, decays 1/2048 per block (~8 s)
+
+struct MicAgc {
+  int32_t floor;  // 8.16 fixed point log2
+  int32_t loud;
+};
+
+// Starts from a packed calibration (0 = not calibrated)
+void micAgcBegin(MicAgc &agc, uint32_t calibration);
+
+// Packs a measured floor and loud level (8.8 log2) for Config.mic_calibration
+uint32_t micCalibrationPack(uint16_t floor, uint16_t loud);
+
+// Updates the floor / loud level with one block's loudness and returns its volume (0-15, 8.8)
+uint16_t micAgcUpdate(MicAgc &agc, uint16_t loudness);
+
+// Volume (0-15, 8.8) that sits MIC_NOISE_MARGIN above the current floor
+uint16_t micAgcThreshold(const MicAgc &agc);
+
+template <uint16_t N>
+class SpectrumAnalyzer {
+  static_assert(N >= 64 && N <= ANALYZER_MAX_FFT_SIZE && (N & (N - 1)) == 0,
+                "FFT size must be a power of two from 64 to 512");
+
+public:
+  static const uint16_t SIZE = N;
+  static const uint16_t BINS = N / 2;  // Bin k covers k * sampleRate / N Hz
+  static const uint16_t HOP = N / 2;   // 50% overlap between frames
+
+  // Removes DC, windows and transforms one frame of N PCM samples,
+  // then fills magnitude[] (bin 0 is DC and stays near zero)
+  void process(const int16_t* pcm) {
+    int32_t sum = 0;
+    for (uint16_t i = 0; i < N; i++) {
+      sum += pcm[i];
+    }
+    int16_t mean = sum / (int32_t)N;
+
+    const uint16_t windowStep = ANALYZER_MAX_FFT_SIZE / N;
+    for (uint16_t i = 0; i < N; i++) {
+      int32_t sample = (int32_t)(pcm[i] - mean) << ANALYZER_INPUT_SHIFT;
+      if (sample > 32767) {
+        sample = 32767;
+      } else if (sample < -32768) {
+        sample = -32768;
+      }
+      re[i] = (sample * hannWindow[i * windowStep]) >> 15;
+      im[i] = 0;
+    }
+
+    fftQ15(re, im, N);
+
+    for (uint16_t k = 0; k < BINS; k++) {
+      magnitude[k] = magnitudeApprox(re[k], im[k]);
+    }
+  }
+
+  uint16_t magnitude[BINS];
+
+private:
+  int16_t re[N];
+  int16_t im[N];
+};
+
+// Band energies: spectrum levels grouped into log-spaced bands, one per
+// column of the joined 10x5 eye canvas. All values are 0-15 in 8.8 fixed point.
+#define SPECTRUM_BANDS 10
+#define BAND_FALL 48              // Displayed level drop per frame
+#define BAND_PEAK_HOLD_FRAMES 25  // Frames a peak stays put before falling
+#define BAND_PEAK_FALL 16         // Peak drop per frame once the hold runs out
+#define BASS_BANDS 3              // Bands 0-2 (below ~250 Hz)
+#define TREBLE_START_BAND 7       // Bands 7-9 (above ~2.5 kHz); the rest are mid
+
+// Band edges in Hz, SPECTRUM_BANDS + 1 of them
+extern const uint16_t bandEdgesHz[SPECTRUM_BANDS + 1];
+
+struct BandEnergies {
+  uint16_t energy[SPECTRUM_BANDS];    // This frame, unsmoothed
+  uint16_t level[SPECTRUM_BANDS];     // Falls back by BAND_FALL per frame
+  uint16_t peak[SPECTRUM_BANDS];      // Peak hold
+  uint8_t peakHold[SPECTRUM_BANDS];   // Frames left before the peak falls
+  uint16_t bass;
+  uint16_t mid;
+  uint16_t treble;
+};
+
+// Updates bands from one frame of spectrum levels (see spectrumLevels); fftSize
+// and sampleRate place the band edges. Works straight off the levels array.
+void bandEnergiesUpdate(BandEnergies &bands, const uint16_t* levels, uint16_t fftSize, uint16_t sampleRate);
+
+#endif  // AUDIOPIPELINE_H
@@ -0,0 +1,163 @@
+// BeatClock.cpp
+
+#include "BeatClock.h"
+
+// Beat 'anchorBeat' fell at 'anchorMs'; beats follow every 'periodMs'
+static uint32_t anchorMs = 0;
+static uint32_t anchorBeat = 0;
+static uint32_t periodMs = 60000UL / BEAT_DEFAULT_BPM;
+
+static BeatSource source = BEAT_SOURCE_DEFAULT;
+static uint32_t hostSetMs = 0;
+static uint32_t lastAudioTempoMs = 0;  // Last audio tempo update (0 = none yet)
+static uint32_t lastReportedBeat = 0;
+
+static BeatCallback listeners[MAX_BEAT_LISTENERS] = { nullptr };
+
+// Beat number at 'now' and milliseconds since that beat started
+static void locate(uint32_t now, uint32_t &beat, uint32_t &frac) {
+  // A phase nudge can leave the anchor a little ahead of 'now'
+  int32_t elapsed = (int32_t)(now - anchorMs);
+  if (elapsed < 0) {
+    beat = anchorBeat - 1;
+    frac = periodMs + elapsed;
+  } else {
+    beat = anchorBeat + (uint32_t)elapsed / periodMs;
+    frac = (uint32_t)elapsed % periodMs;
+  }
+}
+
+// Changes the beat length while keeping the current beat number and phase
+static void setPeriod(uint32_t newPeriod, uint32_t now) {
+  uint32_t beat;
+  uint32_t frac;
+  locate(now, beat, frac);
+  anchorBeat = beat;
+  anchorMs = now - (uint32_t)(((uint64_t)frac * newPeriod) / periodMs);
+  periodMs = newPeriod;
+}
+
+void beatClockSetBpm(uint16_t bpm, uint32_t now) {
+  if (bpm == 0) {
+    // Release the host lock, audio takes over again
+    source = (lastAudioTempoMs != 0) ? BEAT_SOURCE_AUDIO : BEAT_SOURCE_DEFAULT;
+    return;
+  }
+  if (bpm < BEAT_MIN_BPM) {
+    bpm = BEAT_MIN_BPM;
+  } else if (bpm > BEAT_MAX_BPM) {
+    bpm = BEAT_MAX_BPM;
+  }
+
+  // Start a fresh bar right now at the new tempo
+  uint32_t beats = beatClockBeatCount(now);
+  anchorBeat = beats + (BEATS_PER_BAR - beats % BEATS_PER_BAR) % BEATS_PER_BAR;
+  anchorMs = now;
+  periodMs = 60000UL / bpm;
+  source = BEAT_SOURCE_HOST;
+  hostSetMs = now;
+}
+
+void beatClockAudioTempo(uint16_t bpm, uint32_t now) {
+  bool hostLocked = (source == BEAT_SOURCE_HOST) && (now - hostSetMs < BEAT_HOST_HOLD_MS);
+  if (hostLocked || bpm < BEAT_MIN_BPM || bpm > BEAT_MAX_BPM) {
+    return;
+  }
+
+  // Smooth towards the estimated beat length
+  uint32_t interval = 60000UL / bpm;
+  setPeriod((periodMs * (BEAT_TEMPO_SMOOTHING - 1) + interval + BEAT_TEMPO_SMOOTHING / 2) / BEAT_TEMPO_SMOOTHING, now);
+  source = BEAT_SOURCE_AUDIO;
+  lastAudioTempoMs = now;
+}
+
+void beatClockAudioBeat(uint32_t now) {
+  // Phase: nudge the grid so beats line up with what was heard
+  uint32_t beat;
+  uint32_t frac;
+  locate(now, beat, frac);
+  int32_t error = (frac < periodMs / 2) ? (int32_t)frac : (int32_t)frac - (int32_t)periodMs;
+  if (error < -(int32_t)(periodMs / 4) || error > (int32_t)(periodMs / 4)) {
+    return;  // Off-beat onset
+  }
+  anchorMs += error / BEAT_PHASE_SMOOTHING;
+}
+
+void beatClockUpdate(uint32_t now) {
+  uint32_t beat = beatClockBeatCount(now);
+  if (beat == lastReportedBeat) {
+    return;
+  }
+  // Only report the latest beat if several went by unobserved
+  lastReportedBeat = beat;
+  for (int i = 0; i < MAX_BEAT_LISTENERS; i++) {
+    if (listeners[i] != nullptr) {
+      listeners[i](beat);
+    }
+  }
+}
+
+bool beatClockAddListener(BeatCallback callback) {
+  for (int i = 0; i < MAX_BEAT_LISTENERS; i++) {
+    if (listeners[i] == callback) {
+      return true;
+    }
+  }
+  for (int i = 0; i < MAX_BEAT_LISTENERS; i++) {
+    if (listeners[i] == nullptr) {
+      listeners[i] = callback;
+      return true;
+    }
+  }
+  return false;
+}
+
+void beatClockRemoveListener(BeatCallback callback) {
+  for (int i = 0; i < MAX_BEAT_LISTENERS; i++) {
+    if (listeners[i] == callback) {
+      listeners[i] = nullptr;
+    }
+  }
+}
+
+uint16_t beatClockBpm() {
+  return (60000UL + periodMs / 2) / periodMs;
+}
+
+uint32_t beatClockPeriodMs() {
+  return periodMs;
+}
+
+BeatSource beatClockSource() {
+  return source;
+}
+
+uint32_t beatClockBeatCount(uint32_t now) {
+  uint32_t beat;
+  uint32_t frac;
+  locate(now, beat, frac);
+  return beat;
+}
+
+uint8_t beatClockBeatPhase(uint32_t now) {
+  return beatClockPhase(now, 1);
+}
+
+uint8_t beatClockBarPhase(uint32_t now) {
+  return beatClockPhase(now, BEATS_PER_BAR);
+}
+
+uint8_t beatClockPhase(uint32_t now, uint8_t beats) {
+  if (beats == 0) {
+    beats = 1;
+  }
+  uint32_t beat;
+  uint32_t frac;
+  locate(now, beat, frac);
+  uint32_t position = (beat % beats) * periodMs + frac;
+  return (uint8_t)((position * 256) / (periodMs * beats));
+}
+
+uint8_t beatClockBeatInBar(uint32_t now) {
+  return beatClockBeatCount(now) % BEATS_PER_BAR;
+}
@@ -0,0 +1,69 @@
+// BeatClock.h
+
+#ifndef BEATCLOCK_H
+#define BEATCLOCK_H
+
+#include <stdint.h>
+
+// Shared tempo clock. Tempo and onsets come from the audio pipeline
+// (beatClockAudioTempo / beatClockAudioBeat) or the I2C host (beatClockSetBpm); any animation can read the beat / bar
+// phase or subscribe to beat events. All functions take the current time in
+// milliseconds so the clock has no dependency on the Arduino core.
+
+#define BEATS_PER_BAR 4
+#define BEAT_MIN_BPM 60
+#define BEAT_MAX_BPM 180
+#define BEAT_DEFAULT_BPM 120
+
+// How long a tempo set by the host wins over the tempo heard by the microphone
+#define BEAT_HOST_HOLD_MS 30000
+
+// Audio tempo estimates move the tempo 1/BEAT_TEMPO_SMOOTHING of the way to the
+// estimate; onsets near a beat pull the phase 1/BEAT_PHASE_SMOOTHING of the way onto it
+#define BEAT_TEMPO_SMOOTHING 5
+#define BEAT_PHASE_SMOOTHING 4
+
+#define MAX_BEAT_LISTENERS 4
+
+enum BeatSource {
+  BEAT_SOURCE_DEFAULT = 0,  // Free running at BEAT_DEFAULT_BPM
+  BEAT_SOURCE_AUDIO,
+  BEAT_SOURCE_HOST
+};
+
+// Called once per beat with the running beat number
+typedef void (*BeatCallback)(uint32_t beatNumber);
+
+// Host sets the tempo; the current moment becomes a downbeat.
+// bpm 0 hands the clock back to the audio pipeline.
+void beatClockSetBpm(uint16_t bpm, uint32_t now);
+
+// Audio pipeline estimated the tempo (ignored while the host holds the clock)
+void beatClockAudioTempo(uint16_t bpm, uint32_t now);
+
+// Audio pipeline detected an onset at 'now'; only onsets within a quarter
+// beat of the grid move the phase, so off-beats leave it alone
+void beatClockAudioBeat(uint32_t now);
+
+// Fires listeners for a beat crossed since the last call; call from animation loops
+void beatClockUpdate(uint32_t now);
+
+bool beatClockAddListener(BeatCallback callback);
+void beatClockRemoveListener(BeatCallback callback);
+
+uint16_t beatClockBpm();
+uint32_t beatClockPeriodMs();
+BeatSource beatClockSource();
+
+// Beats since the clock started
+uint32_t beatClockBeatCount(uint32_t now);
+
+// 0-255 ramp across one beat / one bar / any number of beats
+uint8_t beatClockBeatPhase(uint32_t now);
+uint8_t beatClockBarPhase(uint32_t now);
+uint8_t beatClockPhase(uint32_t now, uint8_t beats);
+
+// Position of the current beat within the bar (0 = downbeat)
+uint8_t beatClockBeatInBar(uint32_t now);
+
+#endif  // BEATCLOCK_H
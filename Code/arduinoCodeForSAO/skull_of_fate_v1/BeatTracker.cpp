@@ -0,0 +1,163 @@
+// BeatTracker.cpp
+
+#include "BeatTracker.h"
+#include <string.h>
+
+void beatTrackerReset(BeatTracker &tracker) {
+  memset(&tracker, 0, sizeof(tracker));
+}
+
+// Mean and mean absolute deviation of the flux history
+static void fluxStatistics(const BeatTracker &tracker, uint32_t &mean, uint32_t &deviation) {
+  uint32_t sum = 0;
+  for (uint8_t i = 0; i < ONSET_HISTORY_FRAMES; i++) {
+    sum += tracker.fluxHistory[i];
+  }
+  mean = sum / ONSET_HISTORY_FRAMES;
+
+  uint32_t spread = 0;
+  for (uint8_t i = 0; i < ONSET_HISTORY_FRAMES; i++) {
+    uint16_t value = tracker.fluxHistory[i];
+    spread += value > mean ? value - mean : mean - value;
+  }
+  deviation = spread / ONSET_HISTORY_FRAMES;
+}
+
+// Closes the current envelope slot: pushes its strength and updates the autocorrelation
+static void pushSlot(BeatTracker &tracker, uint8_t strength) {
+  tracker.envelopeIndex = (tracker.envelopeIndex + 1) % TEMPO_ENVELOPE_SLOTS;
+  tracker.envelope[tracker.envelopeIndex] = strength;
+  if (tracker.slotsSeen < TEMPO_WARMUP_SLOTS) {
+    tracker.slotsSeen++;
+  }
+
+  for (uint8_t i = 0; i < TEMPO_LAGS; i++) {
+    uint8_t lag = TEMPO_MIN_LAG + i;
+    // Strongest of the slots one either side of the lag: frame times jitter
+    // against the slot grid, which would otherwise split a steady beat
+    // between two lags while its double stays on one
+    uint8_t past = 0;
+    for (uint8_t d = lag - 1; d <= lag + 1; d++) {
+      uint8_t value = tracker.envelope[(tracker.envelopeIndex + TEMPO_ENVELOPE_SLOTS - d) % TEMPO_ENVELOPE_SLOTS];
+      if (value > past) {
+        past = value;
+      }
+    }
+    tracker.acf[i] += (int32_t)strength * past - (tracker.acf[i] >> TEMPO_DECAY_SHIFT);
+  }
+}
+
+// Picks the autocorrelation peak, leaning towards TEMPO_PREFERRED_LAG, and
+// refines it between slots with a parabola through its neighbours
+static void estimateTempo(BeatTracker &tracker) {
+  int32_t bestWeighted = 0;
+  uint8_t best = 0;
+  int32_t sum = 0;
+  for (uint8_t i = 0; i < TEMPO_LAGS; i++) {
+    sum += tracker.acf[i] >> 8;
+    int16_t distance = (int16_t)(TEMPO_MIN_LAG + i) - TEMPO_PREFERRED_LAG;
+    if (distance < 0) {
+      distance = -distance;
+    }
+    int32_t weighted = (tracker.acf[i] >> 8) * (256 - distance * 2);
+    if (weighted > bestWeighted) {
+      bestWeighted = weighted;
+      best = i;
+    }
+  }
+
+  if (bestWeighted <= 0) {
+    tracker.bpm = 0;
+    tracker.confidence = 0;
+    return;
+  }
+
+  // Lag in 1/16 slots
+  int32_t lag16 = (int32_t)(TEMPO_MIN_LAG + best) << 4;
+  if (best > 0 && best < TEMPO_LAGS - 1) {
+    int32_t left = tracker.acf[best - 1] >> 8;
+    int32_t centre = tracker.acf[best] >> 8;
+    int32_t right = tracker.acf[best + 1] >> 8;
+    int32_t curvature = left - 2 * centre + right;
+    if (curvature < 0) {
+      lag16 += ((left - right) * 8) / curvature;
+    }
+  }
+
+  uint32_t bpm = (60000UL * 16 / TEMPO_SLOT_MS + lag16 / 2) / lag16;
+  tracker.bpm = bpm < BEAT_MIN_BPM ? BEAT_MIN_BPM : (bpm > BEAT_MAX_BPM ? BEAT_MAX_BPM : bpm);
+
+  // Confidence: how far the peak stands above the average lag. Nothing
+  // until the autocorrelation has a couple of the slowest beats behind it;
+  // a few hundred ms of history always has one lag standing out.
+  if (tracker.slotsSeen < TEMPO_WARMUP_SLOTS) {
+    tracker.confidence = 0;
+    return;
+  }
+  int32_t peak = tracker.acf[best] >> 8;
+  int32_t mean = sum / TEMPO_LAGS;
+  int32_t confidence = peak > 0 ? (peak - mean) * 255 / peak : 0;
+  tracker.confidence = confidence > 255 ? 255 : (confidence < 0 ? 0 : confidence);
+}
+
+bool beatTrackerUpdate(BeatTracker &tracker, const uint16_t* bandEnergy, uint32_t now) {
+  if (!tracker.started) {
+    memcpy(tracker.prevEnergy, bandEnergy, sizeof(tracker.prevEnergy));
+    tracker.slotMs = now;
+    tracker.lastOnsetMs = now;
+    tracker.started = true;
+    return false;
+  }
+
+  // Spectral flux: how much the bands rose since the previous frame
+  uint32_t flux = 0;
+  for (uint8_t b = 0; b < SPECTRUM_BANDS; b++) {
+    if (bandEnergy[b] > tracker.prevEnergy[b]) {
+      flux += bandEnergy[b] - tracker.prevEnergy[b];
+    }
+    tracker.prevEnergy[b] = bandEnergy[b];
+  }
+  tracker.flux = flux > 65535 ? 65535 : flux;
+
+  // Adaptive threshold from the spread of recent frames
+  uint32_t mean;
+  uint32_t deviation;
+  fluxStatistics(tracker, mean, deviation);
+  tracker.fluxHistory[tracker.fluxIndex] = tracker.flux;
+  tracker.fluxIndex = (tracker.fluxIndex + 1) % ONSET_HISTORY_FRAMES;
+
+  uint32_t threshold = mean + ONSET_DEVIATIONS * deviation + ONSET_MIN_FLUX;
+  bool onset = false;
+  if (tracker.flux > threshold && now - tracker.lastOnsetMs >= ONSET_REFRACTORY_MS) {
+    onset = true;
+    tracker.lastOnsetMs = now;
+  }
+
+  // Onset strength for the tempo envelope: flux above the usual spread
+  uint32_t floor = mean + deviation;
+  uint32_t strength = tracker.flux > floor ? (tracker.flux - floor) >> 4 : 0;
+  if (strength > 255) {
+    strength = 255;
+  }
+
+  // Close every slot that ended before this frame. Slots without a frame stay
+  // empty; a long gap (more than the envelope) only needs the envelope flushed.
+  uint32_t slots = (now - tracker.slotMs) / TEMPO_SLOT_MS;
+  if (slots > TEMPO_ENVELOPE_SLOTS) {
+    tracker.slotMs += (slots - TEMPO_ENVELOPE_SLOTS) * TEMPO_SLOT_MS;
+    slots = TEMPO_ENVELOPE_SLOTS;
+  }
+  for (uint32_t i = 0; i < slots; i++) {
+    pushSlot(tracker, tracker.slotStrength);
+    tracker.slotStrength = 0;
+    tracker.slotMs += TEMPO_SLOT_MS;
+  }
+  if (strength > tracker.slotStrength) {
+    tracker.slotStrength = strength;
+  }
+
+  if (slots > 0) {
+    estimateTempo(tracker);
+  }
+  return onset;
+}
@@ -0,0 +1,62 @@
+// BeatTracker.h
+
+#ifndef BEATTRACKER_H
+#define BEATTRACKER_H
+
+#include <stdint.h>
+#include "AudioPipeline.h"
+#include "BeatClock.h"
+
+// Onset detection and tempo estimation on the band energies of each FFT
+// frame. Spectral flux (summed rises of the band energies) is compared to
+// the mean and spread of recent frames to find onsets. The flux above the
+// usual spread is laid out on a 10 ms time grid and autocorrelated with a leaky sum
+// (a few seconds of memory) to find the beat period. Frames do not line up
+// with the grid, so each lag also takes the neighbouring slots into account.
+// Memory is fixed and each frame costs at most a couple of passes over
+// TEMPO_LAGS entries per 10 ms elapsed. No Arduino dependencies.
+
+#define ONSET_HISTORY_FRAMES 31    // Flux history for the adaptive threshold (~250 ms)
+#define ONSET_DEVIATIONS 6         // Onset flux is this many mean deviations above the mean
+#define ONSET_MIN_FLUX 256         // ...and above it by at least this much (one level)
+#define ONSET_REFRACTORY_MS 120    // Minimum gap between onsets
+
+#define TEMPO_SLOT_MS 10                                      // Onset envelope time step
+#define TEMPO_MIN_LAG (60000 / BEAT_MAX_BPM / TEMPO_SLOT_MS)  // Slots per beat at the fastest tempo
+#define TEMPO_MAX_LAG (60000 / BEAT_MIN_BPM / TEMPO_SLOT_MS)  // Slots per beat at the slowest tempo
+#define TEMPO_LAGS (TEMPO_MAX_LAG - TEMPO_MIN_LAG + 1)
+#define TEMPO_ENVELOPE_SLOTS (TEMPO_MAX_LAG + 2)              // Envelope history: longest lag plus one slot of slack
+#define TEMPO_DECAY_SHIFT 8        // Autocorrelation leaks 1/256 per slot (~2.5 s memory)
+#define TEMPO_WARMUP_SLOTS (2 * TEMPO_MAX_LAG)                // No confidence before this much history
+#define TEMPO_PREFERRED_LAG (60000 / BEAT_DEFAULT_BPM / TEMPO_SLOT_MS)  // Octave errors lean towards 120 BPM
+#define BEAT_MIN_CONFIDENCE 128    // Confidence (0-255) a tempo needs before it drives the beat clock
+
+struct BeatTracker {
+  uint16_t prevEnergy[SPECTRUM_BANDS];
+  uint16_t fluxHistory[ONSET_HISTORY_FRAMES];
+  uint8_t fluxIndex;
+
+  uint8_t envelope[TEMPO_ENVELOPE_SLOTS];  // Onset strength per slot, ring
+  uint8_t envelopeIndex;
+  uint8_t slotStrength;                 // Strongest onset so far in the current slot
+  uint32_t slotMs;                      // Start of the current slot
+  int32_t acf[TEMPO_LAGS];              // Leaky autocorrelation, lags TEMPO_MIN_LAG..TEMPO_MAX_LAG
+  uint16_t slotsSeen;                   // Slots pushed, up to TEMPO_WARMUP_SLOTS
+
+  uint32_t lastOnsetMs;
+  bool started;
+
+  // Outputs
+  uint16_t flux;        // This frame's spectral flux
+  uint16_t bpm;         // Best tempo so far, 0 until there is one
+  uint8_t confidence;   // 0-255: how far that tempo stands out from the other lags
+};
+
+// Clears all history
+void beatTrackerReset(BeatTracker &tracker);
+
+// Feeds one frame of band energies (BandEnergies::energy) heard at 'now' ms.
+// Returns true if the frame is an onset.
+bool beatTrackerUpdate(BeatTracker &tracker, const uint16_t* bandEnergy, uint32_t now);
+
+#endif  // BEATTRACKER_H
@@ -1,5 +1,6 @@
 // ConfigManager.cpp
 #include "ConfigManager.h"
+#include "MotionCapture.h"
 
 // Constructor implementation
 ConfigManager::ConfigManager(Adafruit_SPIFlash& flashRef) : flash(flashRef), fatfs() {}
@@ -30,7 +31,7 @@ bool ConfigManager::initialize() {
     Serial.println(F("Creating default config..."));
 
     // Populate config struct from JSON
-    DynamicJsonDocument doc(2048);  // Increased from 1024 to 2048
+    DynamicJsonDocument doc(2560);  // Increased from 2048 to 2560 for motion_gestures
 
     DeserializationError error = deserializeJson(doc, defaultConfig);
     if (error) {
@@ -45,6 +46,11 @@ bool ConfigManager::initialize() {
     config.accel_calibration.x = doc["accel_calibration"]["x"] | 0;
     config.accel_calibration.y = doc["accel_calibration"]["y"] | 0;
     config.accel_calibration.z = doc["accel_calibration"]["z"] | 0;
+    config.accel_calibration.scale = doc["accel_calibration"]["scale"] | 0;
+    config.motion_gestures.shake = doc["motion_gestures"]["shake"] | MOTION_DEFAULT_SHAKE;
+    config.motion_gestures.tilt = doc["motion_gestures"]["tilt"] | MOTION_DEFAULT_TILT;
+    config.motion_gestures.spin = doc["motion_gestures"]["spin"] | MOTION_DEFAULT_SPIN;
+    config.motion_gestures.flip_ms = doc["motion_gestures"]["flip_ms"] | MOTION_DEFAULT_FLIP_MS;
     config.defaultAnimation = doc["defaultAnimation"] | 0;
     config.defaulti2cAddress = doc["defaulti2cAddress"] | 18;
     config.alternatei2cAddress1 = doc["alternatei2cAddress1"] | 19;
@@ -60,6 +66,8 @@ bool ConfigManager::initialize() {
     config.extra5 = doc["extra5"] | 0;
     config.neopixelmaxbrightness = doc["neopixelmaxbrightness"] | 255;  // Newly added field
     config.watchdogmaxtimeout = doc["watchdogmaxtimeout"] | 5000;        // Newly added field
+    config.sleep_timeout = doc["sleep_timeout"] | 600;
+    config.accel_rate = doc["accel_rate"] | MOTION_DEFAULT_ODR;
 
     // Populate animation colors
     config.animation1_color = doc["animation1_color"] | 0;
@@ -114,7 +122,7 @@ bool ConfigManager::loadConfig() {
     return false;
   }
 
-  DynamicJsonDocument doc(2048);
+  DynamicJsonDocument doc(2560);
   DeserializationError error = deserializeJson(doc, configFile);
   configFile.close();
   if (error) {
@@ -136,6 +144,11 @@ void ConfigManager::updateConfigStructFromDoc(const DynamicJsonDocument& doc) {
   config.accel_calibration.x = doc["accel_calibration"]["x"] | 0;
   config.accel_calibration.y = doc["accel_calibration"]["y"] | 0;
   config.accel_calibration.z = doc["accel_calibration"]["z"] | 0;
+  config.accel_calibration.scale = doc["accel_calibration"]["scale"] | 0;
+  config.motion_gestures.shake = doc["motion_gestures"]["shake"] | MOTION_DEFAULT_SHAKE;
+  config.motion_gestures.tilt = doc["motion_gestures"]["tilt"] | MOTION_DEFAULT_TILT;
+  config.motion_gestures.spin = doc["motion_gestures"]["spin"] | MOTION_DEFAULT_SPIN;
+  config.motion_gestures.flip_ms = doc["motion_gestures"]["flip_ms"] | MOTION_DEFAULT_FLIP_MS;
   config.defaultAnimation = doc["defaultAnimation"] | 0;
   config.defaulti2cAddress = doc["defaulti2cAddress"] | 18;
   config.alternatei2cAddress1 = doc["alternatei2cAddress1"] | 19;
@@ -151,6 +164,8 @@ void ConfigManager::updateConfigStructFromDoc(const DynamicJsonDocument& doc) {
   config.extra5 = doc["extra5"] | 0;
   config.neopixelmaxbrightness = doc["neopixelmaxbrightness"] | 255;
   config.watchdogmaxtimeout = doc["watchdogmaxtimeout"] | 5000;
+  config.sleep_timeout = doc["sleep_timeout"] | 600;
+  config.accel_rate = doc["accel_rate"] | MOTION_DEFAULT_ODR;
 
   // Update animation colors
   config.animation1_color = doc["animation1_color"] | 0;
@@ -210,7 +225,7 @@ bool ConfigManager::saveConfigAtomic() {
   // Serial.println(F("Temporary file opened successfully."));
 
   // Increase the DynamicJsonDocument size
-  const size_t capacity = JSON_OBJECT_SIZE(29) + 1500;  // Adjusted for extended config
+  const size_t capacity = JSON_OBJECT_SIZE(37) + 1700;  // Adjusted for extended config
   DynamicJsonDocument doc(capacity);
 
   // Populate the JSON document with config data
@@ -222,6 +237,14 @@ bool ConfigManager::saveConfigAtomic() {
   accel_cal["x"] = config.accel_calibration.x;
   accel_cal["y"] = config.accel_calibration.y;
   accel_cal["z"] = config.accel_calibration.z;
+  accel_cal["scale"] = config.accel_calibration.scale;
+
+  // Nested motion_gestures object
+  JsonObject gestures = doc.createNestedObject("motion_gestures");
+  gestures["shake"] = config.motion_gestures.shake;
+  gestures["tilt"] = config.motion_gestures.tilt;
+  gestures["spin"] = config.motion_gestures.spin;
+  gestures["flip_ms"] = config.motion_gestures.flip_ms;
 
   doc["defaultAnimation"] = config.defaultAnimation;
   doc["defaulti2cAddress"] = config.defaulti2cAddress;
@@ -238,6 +261,8 @@ bool ConfigManager::saveConfigAtomic() {
   doc["extra5"] = config.extra5;
   doc["neopixelmaxbrightness"] = config.neopixelmaxbrightness;    // Newly added field
   doc["watchdogmaxtimeout"] = config.watchdogmaxtimeout;          // Newly added field
+  doc["sleep_timeout"] = config.sleep_timeout;
+  doc["accel_rate"] = config.accel_rate;
 
   // Add animation colors
   doc["animation1_color"] = config.animation1_color;
@@ -346,7 +371,17 @@ void ConfigManager::printConfig() {
   Serial.print(F(", y="));
   Serial.print(config.accel_calibration.y);
   Serial.print(F(", z="));
-  Serial.println(config.accel_calibration.z);
+  Serial.print(config.accel_calibration.z);
+  Serial.print(F(", scale="));
+  Serial.println(config.accel_calibration.scale);
+  Serial.print(F("Motion Gestures: shake="));
+  Serial.print(config.motion_gestures.shake);
+  Serial.print(F(", tilt="));
+  Serial.print(config.motion_gestures.tilt);
+  Serial.print(F(", spin="));
+  Serial.print(config.motion_gestures.spin);
+  Serial.print(F(", flip_ms="));
+  Serial.println(config.motion_gestures.flip_ms);
   Serial.print(F("Default Animation: "));
   Serial.println(config.defaultAnimation);
   Serial.print(F("Default I2C Address: 0x"));
@@ -377,6 +412,10 @@ void ConfigManager::printConfig() {
   Serial.println(config.neopixelmaxbrightness);  // Newly added field
   Serial.print(F("Watchdog Max Timeout: "));
   Serial.println(config.watchdogmaxtimeout);    // Newly added field
+  Serial.print(F("Sleep Timeout (s): "));
+  Serial.println(config.sleep_timeout);
+  Serial.print(F("Accel Rate (Hz): "));
+  Serial.println(config.accel_rate);
 
   // Print animation colors
   Serial.println(F("Animation Colors:"));
@@ -445,7 +484,7 @@ bool ConfigManager::updateConfig(const String& key, const JsonVariant& value) {
     return false;
   }
 
-  DynamicJsonDocument doc(2048); // Adjust size as needed
+  DynamicJsonDocument doc(2560); // Adjust size as needed
   DeserializationError error = deserializeJson(doc, configFile);
   configFile.close();
   if (error) {
@@ -18,7 +18,14 @@ struct Config {
     int x;
     int y;
     int z;
-  } accel_calibration;
+    int scale;                       // Measured counts per g, 0 = not calibrated
+  } accel_calibration;               // Accelerometer zero offsets, 12-bit counts (1024 = 1 g)
+  struct {
+    int shake;                       // High-pass peak, counts
+    int tilt;                        // Sideways gravity, counts
+    int spin;                        // Degrees of turn
+    int flip_ms;                     // Face down time
+  } motion_gestures;                 // Motion gesture thresholds
   int defaultAnimation;
   int defaulti2cAddress;
   int alternatei2cAddress1;
@@ -34,6 +41,8 @@ struct Config {
   int extra5;
   int neopixelmaxbrightness;          // Newly added field
   int watchdogmaxtimeout;            // Newly added field
+  int sleep_timeout;                 // Seconds without use before sleeping, 0 = never
+  int accel_rate;                    // Accelerometer sample rate, 100 / 200 / 400 Hz
   // Animation colors
   int animation1_color;
   int animation2_color;
@@ -99,7 +108,9 @@ private:
   Adafruit_SPIFlash& flash;  // Reference to the flash object
   FatVolume fatfs;
 
-  // Default configuration parameters as a JSON string
+  // Default configuration parameters as a JSON string. motion_gestures and
+  // accel_rate are left out: initialize() fills them from the MOTION_DEFAULT_*
+  // values and the first save writes them to the file.
   const char* defaultConfig = R"json(
     {
       "version": 1,
@@ -107,7 +118,8 @@ private:
       "accel_calibration": {
         "x": 0,
         "y": 0,
-        "z": 0
+        "z": 0,
+        "scale": 0
       },
       "defaultAnimation": 0,
       "defaulti2cAddress": 19,
@@ -124,6 +136,7 @@ private:
       "extra5": 0,
       "neopixelmaxbrightness": 10,
       "watchdogmaxtimeout": 8000,
+      "sleep_timeout": 600,
       "animation1_color": 0,
       "animation2_color": 0,
       "animation3_color": 0,
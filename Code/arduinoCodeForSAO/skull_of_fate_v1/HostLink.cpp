@@ -0,0 +1,73 @@
+// HostLink.cpp
+
+#include "HostLink.h"
+
+static HostCommand queue[HOST_QUEUE_SLOTS];
+static volatile uint8_t queueHead = 0;  // Written by the receive interrupt
+static volatile uint8_t queueTail = 0;  // Written by the main loop
+static volatile uint16_t dropped = 0;
+
+static HostRegisters registers[2];
+static volatile uint8_t published = 0;
+static uint32_t frames = 0;
+
+static HostCommandHandler commandHandler = NULL;
+static HostRegisterFiller registerFiller = NULL;
+static bool servicing = false;
+
+void hostLinkBegin(HostCommandHandler handler, HostRegisterFiller filler) {
+  commandHandler = handler;
+  registerFiller = filler;
+  memset(registers, 0, sizeof(registers));
+  for (uint8_t i = 0; i < 2; i++) {
+    registers[i].id = HOST_REGISTER_ID;
+    registers[i].version = HOST_REGISTER_VERSION;
+  }
+}
+
+HostCommand* hostLinkReserve() {
+  if ((uint8_t)(queueHead - queueTail) >= HOST_QUEUE_SLOTS) {
+    dropped++;
+    return NULL;
+  }
+  return &queue[queueHead & (HOST_QUEUE_SLOTS - 1)];
+}
+
+void hostLinkCommit() {
+  __DMB();  // Slot contents land before the loop can see the new head
+  queueHead++;
+}
+
+const HostRegisters &hostLinkRegisters() {
+  return registers[published];
+}
+
+void hostLinkService() {
+  if (servicing) {
+    return;
+  }
+  servicing = true;
+
+  while (commandHandler != NULL && queueTail != queueHead) {
+    HostCommand &slot = queue[queueTail & (HOST_QUEUE_SLOTS - 1)];
+    commandHandler(slot.command, slot.data, slot.length);
+    __DMB();  // Done with the slot before the interrupt may reuse it
+    queueTail++;
+  }
+
+  if (registerFiller != NULL) {
+    uint8_t spare = published ^ 1;
+    registerFiller(registers[spare]);
+    registers[spare].id = HOST_REGISTER_ID;
+    registers[spare].version = HOST_REGISTER_VERSION;
+    registers[spare].frame = ++frames;
+    __DMB();
+    published = spare;
+  }
+
+  servicing = false;
+}
+
+uint16_t hostLinkDropped() {
+  return dropped;
+}
@@ -0,0 +1,138 @@
+// HostLink.h
+
+#ifndef HOSTLINK_H
+#define HOSTLINK_H
+
+#include <Arduino.h>
+#include <stddef.h>
+
+// I2C client plumbing between the SERCOM1 interrupt and the main loop.
+// receiveEvent() only copies each command into a slot of a single-producer /
+// single-consumer ring; hostLinkService() (called from loop() and from every
+// animation frame) runs the commands and refreshes the reply registers.
+// requestEvent() answers from the published copy of those registers, so
+// neither callback prints, touches a sensor or waits on anything.
+// The registers are double buffered: the main loop fills the spare copy and
+// then flips which one is published, so an answer never mixes two updates.
+//
+// The registers form a read-only map at fixed addresses. Writing a single
+// byte below HOST_COMMAND_FIRST sets the read address; every read after
+// that starts there and runs on through the map, so one write of 0x00
+// followed by HOST_REGISTER_COUNT-byte reads polls the whole card with no
+// waiting in between. End the address write with a stop rather than a
+// repeated start: the SAMD Wire client only hands a write over on a stop.
+// Multi-byte values are little-endian and naturally aligned. The
+// single-character commands ('0' upwards) work as before.
+
+#define HOST_QUEUE_SLOTS 8        // Commands held between frames, power of two
+#define HOST_COMMAND_MAX_DATA 64  // Payload bytes kept per command, the rest is dropped
+
+struct HostCommand {
+  char command;
+  uint8_t length;
+  uint8_t data[HOST_COMMAND_MAX_DATA];
+};
+
+#define HOST_COMMAND_FIRST '0'  // Lowest command byte; anything below is a register address
+#define HOST_REGISTER_ID 0x53   // 'S', read back from HOST_REG_ID
+#define HOST_REGISTER_VERSION 1
+
+// Register addresses
+#define HOST_REG_ID 0x00                 // HOST_REGISTER_ID
+#define HOST_REG_VERSION 0x01            // HOST_REGISTER_VERSION
+#define HOST_REG_STATUS 0x02             // HOST_STATUS_* bits
+#define HOST_REG_ANIMATION 0x03          // Running animation index
+#define HOST_REG_FRAME 0x04              // uint32, main loop passes (one per animation frame)
+#define HOST_REG_ACCEL 0x08              // int16 x, y, z, calibrated counts (1024 = 1 g)
+#define HOST_REG_PITCH 0x0E              // int8, binary angle (64 = 90 degrees)
+#define HOST_REG_ROLL 0x0F               // int8, binary angle
+#define HOST_REG_MOTION 0x10             // uint16, motion energy, counts
+#define HOST_REG_MOTION_GESTURE 0x12     // Last MotionGesture
+#define HOST_REG_SOUND_GESTURE 0x13      // Last SoundGesture
+#define HOST_REG_VOLUME 0x14             // uint16, 0-15 in 8.8 fixed point
+#define HOST_REG_THRESHOLD 0x16          // uint16, AGC quiet / sound boundary, 8.8
+#define HOST_REG_BANDS 0x18              // Bass, mid, treble, 0-255 each
+#define HOST_REG_BPM 0x1B                // Beat clock tempo
+#define HOST_REG_BEAT_PHASE 0x1C         // Position within the beat, 0-255
+#define HOST_REG_BEAT_IN_BAR 0x1D        // Beat number within the bar
+#define HOST_REG_MOTION_GESTURES 0x1E    // Motion gestures seen, wraps at 256
+#define HOST_REG_SOUND_GESTURES 0x1F     // Sound gestures heard, wraps at 256
+#define HOST_REG_UPTIME 0x20             // uint32, milliseconds
+#define HOST_REG_I2C_ADDRESS 0x24        // Config: client address in use
+#define HOST_REG_DEFAULT_ANIMATION 0x25  // Config.defaultAnimation
+#define HOST_REG_SLEEP_TIMEOUT 0x26      // uint16, Config.sleep_timeout, seconds
+#define HOST_REG_ACCEL_RATE 0x28         // uint16, Config.accel_rate, Hz
+#define HOST_REG_BRIGHTNESS 0x2A         // Config.neopixelmaxbrightness
+#define HOST_REG_ANIMATIONS 0x2B         // Number of animations
+#define HOST_REGISTER_COUNT 0x2C
+
+// HOST_REG_STATUS bits
+#define HOST_STATUS_MAGNET 0x01
+#define HOST_STATUS_LEFT_BUTTON 0x02
+#define HOST_STATUS_RIGHT_BUTTON 0x04
+#define HOST_STATUS_SOUND 0x08         // Volume above the AGC threshold
+#define HOST_STATUS_MOVING 0x10        // Motion energy above MOTION_ACTIVITY_THRESHOLD
+#define HOST_STATUS_SPECIAL_MODE 0x20  // Full card range armed (right button)
+#define HOST_STATUS_DROPPED 0x40       // A command was lost to a full queue since boot
+
+// The register map, laid out at the addresses above (SAMD21 is little-endian)
+struct HostRegisters {
+  uint8_t id;
+  uint8_t version;
+  uint8_t status;
+  uint8_t animation;
+  uint32_t frame;
+  int16_t accel[3];
+  int8_t pitch;
+  int8_t roll;
+  uint16_t motion;
+  uint8_t motionGesture;
+  uint8_t soundGesture;
+  uint16_t volume;
+  uint16_t threshold;
+  uint8_t bands[3];
+  uint8_t bpm;
+  uint8_t beatPhase;
+  uint8_t beatInBar;
+  uint8_t motionGestures;
+  uint8_t soundGestures;
+  uint32_t uptime;
+  uint8_t i2cAddress;
+  uint8_t defaultAnimation;
+  uint16_t sleepTimeout;
+  uint16_t accelRate;
+  uint8_t brightness;
+  uint8_t animations;
+};
+
+static_assert(sizeof(HostRegisters) == HOST_REGISTER_COUNT, "HostRegisters must match the register map");
+static_assert(offsetof(HostRegisters, frame) == HOST_REG_FRAME, "HOST_REG_FRAME");
+static_assert(offsetof(HostRegisters, accel) == HOST_REG_ACCEL, "HOST_REG_ACCEL");
+static_assert(offsetof(HostRegisters, volume) == HOST_REG_VOLUME, "HOST_REG_VOLUME");
+static_assert(offsetof(HostRegisters, uptime) == HOST_REG_UPTIME, "HOST_REG_UPTIME");
+static_assert(offsetof(HostRegisters, animations) == HOST_REG_ANIMATIONS, "HOST_REG_ANIMATIONS");
+
+typedef void (*HostCommandHandler)(char command, uint8_t* data, int length);
+typedef void (*HostRegisterFiller)(HostRegisters &registers);
+
+// Sets who runs queued commands and who fills the registers. The filler
+// sets everything but id, version and frame.
+void hostLinkBegin(HostCommandHandler handler, HostRegisterFiller filler);
+
+// Receive interrupt only: the next free slot, or NULL when the queue is
+// full (the command is then dropped). Fill it and call hostLinkCommit().
+HostCommand* hostLinkReserve();
+void hostLinkCommit();
+
+// Request interrupt: the published registers
+const HostRegisters &hostLinkRegisters();
+
+// Main loop: runs queued commands, then republishes the registers.
+// Commands that start an animation may call back in here; those calls
+// return straight away.
+void hostLinkService();
+
+// Commands dropped because the queue was full
+uint16_t hostLinkDropped();
+
+#endif  // HOSTLINK_H
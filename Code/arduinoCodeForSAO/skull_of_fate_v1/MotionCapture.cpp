@@ -0,0 +1,325 @@
+// MotionCapture.cpp
+
+#include "MotionCapture.h"
+
+// LIS3DH registers used here
+#define LIS3DH_CTRL_REG1 0x20
+#define LIS3DH_CTRL_REG2 0x21
+#define LIS3DH_CTRL_REG3 0x22
+#define LIS3DH_CTRL_REG5 0x24
+#define LIS3DH_REFERENCE 0x26
+#define LIS3DH_OUT_X_L 0x28
+#define LIS3DH_FIFO_CTRL_REG 0x2E
+#define LIS3DH_FIFO_SRC_REG 0x2F
+#define LIS3DH_INT1_CFG 0x30
+#define LIS3DH_INT1_SRC 0x31
+#define LIS3DH_INT1_THS 0x32
+#define LIS3DH_INT1_DURATION 0x33
+#define LIS3DH_CLICK_CFG 0x38
+#define LIS3DH_CLICK_SRC 0x39
+#define LIS3DH_CLICK_THS 0x3A
+
+#define LIS3DH_AUTO_INCREMENT 0x80  // Register address bit for multi-byte reads
+#define LIS3DH_I1_CLICK 0x80        // CTRL_REG3: click on INT1
+#define LIS3DH_I1_WTM 0x04          // CTRL_REG3: FIFO watermark on INT1
+#define LIS3DH_I1_IA1 0x40          // CTRL_REG3: interrupt generator 1 on INT1
+#define LIS3DH_HPIS1 0x01           // CTRL_REG2: high-pass filter on interrupt generator 1
+#define LIS3DH_ODR_10_LOW_POWER 0x2F  // CTRL_REG1: 10 Hz, low-power mode, x y z on
+#define LIS3DH_ODR_MASK 0xF0        // CTRL_REG1: output data rate bits
+#define LIS3DH_ODR_100 0x50
+#define LIS3DH_ODR_200 0x60
+#define LIS3DH_ODR_400 0x70
+#define LIS3DH_INT1_HIGH_XYZ 0x2A   // INT1_CFG: XHIE | YHIE | ZHIE, any of them
+#define LIS3DH_FIFO_EN 0x40         // CTRL_REG5
+#define LIS3DH_FIFO_STREAM 0x80     // FIFO_CTRL_REG mode bits: keep the newest 32
+#define LIS3DH_FIFO_OVRN 0x40       // FIFO_SRC_REG: samples were lost
+#define LIS3DH_FIFO_FSS 0x1F        // FIFO_SRC_REG: unread sample count
+#define LIS3DH_LIR_CLICK 0x80       // CLICK_THS: hold the click interrupt until CLICK_SRC is read
+#define LIS3DH_CLICK_IA 0x40        // CLICK_SRC bits
+#define LIS3DH_CLICK_DOUBLE 0x20
+#define LIS3DH_CLICK_SINGLE 0x10
+#define LIS3DH_CLICK_SIGN 0x08
+#define LIS3DH_CLICK_Z 0x04
+#define LIS3DH_CLICK_Y 0x02
+#define LIS3DH_CLICK_X 0x01
+
+static MotionSample sampleRing[MOTION_RING_SAMPLES];
+static volatile uint32_t samplesWritten = 0;
+static volatile bool fifoReady = false;
+static MotionTapCallback tapCallback = NULL;
+static MotionGestureCallback gestureCallback = NULL;
+static bool gesturesEnabled = true;
+
+static int16_t calibration[3] = { 0, 0, 0 };
+static int16_t calibrationGain = MOTION_UNITY_GAIN;
+static MotionFilterBank filters;
+static MotionGestureThresholds gestureThresholds = {
+  MOTION_DEFAULT_SHAKE, MOTION_DEFAULT_TILT, MOTION_DEFAULT_SPIN, MOTION_DEFAULT_FLIP_MS
+};
+static MotionGestureDetector gestures;
+static MotionDecimator decimator = { { 0, 0, 0 }, 0, 1 };
+static MotionTiltEstimator tilt;
+static uint32_t lastActiveSample = 0;
+static uint8_t awakeCtrlReg1 = 0;
+static uint8_t awakeCtrlReg2 = 0;
+
+static void writeRegister(uint8_t reg, uint8_t value) {
+  Wire.beginTransmission(MOTION_I2C_ADDRESS);
+  Wire.write(reg);
+  Wire.write(value);
+  Wire.endTransmission();
+}
+
+static uint8_t readRegister(uint8_t reg) {
+  Wire.beginTransmission(MOTION_I2C_ADDRESS);
+  Wire.write(reg);
+  Wire.endTransmission(false);
+  Wire.requestFrom((uint8_t)MOTION_I2C_ADDRESS, (uint8_t)1);
+  return Wire.available() ? Wire.read() : 0;
+}
+
+// INT1 rises on a FIFO watermark or a tap; reading the chip waits for the
+// main loop so the bus is never used from interrupt context
+static void onMotionInterrupt() {
+  fifoReady = true;
+}
+
+// Reads and clears a latched tap, then hands it to the callback
+static void dispatchTap() {
+  uint8_t click = readRegister(LIS3DH_CLICK_SRC);
+  if (!(click & LIS3DH_CLICK_IA) || tapCallback == NULL || !gesturesEnabled) {
+    return;
+  }
+
+  MotionTap tap;
+  tap.type = (click & LIS3DH_CLICK_DOUBLE) ? MOTION_TAP_DOUBLE : MOTION_TAP_SINGLE;
+  tap.axis = (click & LIS3DH_CLICK_X) ? 'x' : (click & LIS3DH_CLICK_Y) ? 'y' : 'z';
+  tap.negative = (click & LIS3DH_CLICK_SIGN) != 0;
+  tap.source = click;
+  tapCallback(tap);
+}
+
+void motionCaptureSetTapCallback(MotionTapCallback callback) {
+  tapCallback = callback;
+}
+
+void motionCaptureSetGestureCallback(MotionGestureCallback callback) {
+  gestureCallback = callback;
+}
+
+void motionCaptureEnableGestures(bool enabled) {
+  gesturesEnabled = enabled;
+}
+
+void motionCaptureSetGestureThresholds(const MotionGestureThresholds &thresholds) {
+  gestureThresholds = thresholds;
+  motionGestureReset(gestures, gestureThresholds, MOTION_SAMPLE_RATE);
+}
+
+// FIFO watermark in chip samples, so a burst is the same time at any rate
+static uint8_t fifoWatermark() {
+  return MOTION_FIFO_WATERMARK * decimator.factor;
+}
+
+uint16_t motionCaptureSetDataRate(uint16_t hz) {
+  uint8_t odr = LIS3DH_ODR_100;
+  uint16_t rate = 100;
+  if (hz >= 300) {
+    odr = LIS3DH_ODR_400;
+    rate = 400;
+  } else if (hz >= 150) {
+    odr = LIS3DH_ODR_200;
+    rate = 200;
+  }
+  writeRegister(LIS3DH_CTRL_REG1, (readRegister(LIS3DH_CTRL_REG1) & ~LIS3DH_ODR_MASK) | odr);
+  motionDecimatorReset(decimator, rate / MOTION_SAMPLE_RATE);
+  return rate;
+}
+
+bool motionCaptureBegin() {
+  // Stream mode with the watermark, then enable the FIFO
+  writeRegister(LIS3DH_FIFO_CTRL_REG, LIS3DH_FIFO_STREAM | fifoWatermark());
+  writeRegister(LIS3DH_CTRL_REG5, readRegister(LIS3DH_CTRL_REG5) | LIS3DH_FIFO_EN);
+
+  // Single and double taps, latched so one still waits when the loop gets to it
+  writeRegister(LIS3DH_CLICK_CFG, MOTION_CLICK_AXES);
+  writeRegister(LIS3DH_CLICK_THS, readRegister(LIS3DH_CLICK_THS) | LIS3DH_LIR_CLICK);
+
+  // Both share INT1
+  writeRegister(LIS3DH_CTRL_REG3, LIS3DH_I1_CLICK | LIS3DH_I1_WTM);
+
+  if ((readRegister(LIS3DH_CTRL_REG5) & LIS3DH_FIFO_EN) == 0) {
+    Serial.println("Failed to enable the accelerometer FIFO!");
+    return false;
+  }
+
+  samplesWritten = 0;
+  motionDecimatorReset(decimator, decimator.factor);
+  motionFilterReset(filters);
+  motionTiltReset(tilt);
+  motionGestureReset(gestures, gestureThresholds, MOTION_SAMPLE_RATE);
+  fifoReady = true;  // Pick up whatever is already queued
+  pinMode(MOTION_INT_PIN, INPUT);
+  attachInterrupt(digitalPinToInterrupt(MOTION_INT_PIN), onMotionInterrupt, RISING);
+  return true;
+}
+
+uint8_t motionCaptureService() {
+  // The line stays high while the FIFO is at or above the watermark or a
+  // tap is latched, so a level check also catches an edge that came while
+  // we were busy
+  if (!fifoReady && digitalRead(MOTION_INT_PIN) == LOW) {
+    return 0;
+  }
+  fifoReady = false;
+
+  dispatchTap();
+
+  uint8_t fifoSource = readRegister(LIS3DH_FIFO_SRC_REG);
+  uint8_t waiting = fifoSource & LIS3DH_FIFO_FSS;
+  if (fifoSource & LIS3DH_FIFO_OVRN) {
+    waiting = MOTION_FIFO_DEPTH;  // FSS wraps to 0 when the FIFO is full
+  }
+
+  uint8_t drained = 0;
+  uint8_t produced = 0;
+  while (drained < waiting) {
+    uint8_t count = min(waiting - drained, MOTION_BURST_SAMPLES);
+
+    // With the FIFO enabled, reads past OUT_Z_H wrap back to OUT_X_L and
+    // pop the next sample, so one transaction empties the whole batch
+    Wire.beginTransmission(MOTION_I2C_ADDRESS);
+    Wire.write(LIS3DH_OUT_X_L | LIS3DH_AUTO_INCREMENT);
+    Wire.endTransmission(false);
+    uint8_t bytes = Wire.requestFrom((uint8_t)MOTION_I2C_ADDRESS, (uint8_t)(count * 6));
+    if (bytes < count * 6) {
+      break;
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+      uint8_t raw[6];
+      for (uint8_t b = 0; b < 6; b++) {
+        raw[b] = Wire.read();
+      }
+      int16_t chipCounts[3];
+      for (uint8_t axis = 0; axis < 3; axis++) {
+        int16_t value = (int16_t)(raw[axis * 2] | (raw[axis * 2 + 1] << 8));
+        chipCounts[axis] = motionCounts(value, calibration[axis], calibrationGain);
+      }
+      int16_t counts[3];
+      if (!motionDecimate(decimator, chipCounts, counts)) {
+        continue;
+      }
+
+      motionFilterUpdate(filters, counts);
+      motionTiltUpdate(tilt, counts, filters);
+      if (tilt.energy > MOTION_ACTIVITY_THRESHOLD) {
+        lastActiveSample = samplesWritten;
+      }
+      MotionGesture gesture = motionGestureUpdate(gestures, filters);
+      if (gesture != MOTION_GESTURE_NONE && gestureCallback != NULL && gesturesEnabled) {
+        gestureCallback(gesture);
+      }
+
+      MotionSample &sample = sampleRing[samplesWritten & (MOTION_RING_SAMPLES - 1)];
+      sample.x = counts[0];
+      sample.y = counts[1];
+      sample.z = counts[2];
+      samplesWritten++;  // Only after the sample is complete, for readers in interrupts
+      produced++;
+    }
+    drained += count;
+  }
+  return produced;
+}
+
+void motionCaptureSetCalibration(int16_t x, int16_t y, int16_t z, int16_t scale) {
+  calibration[0] = x;
+  calibration[1] = y;
+  calibration[2] = z;
+  calibrationGain = motionCalibrationGain(scale);
+  motionFilterReset(filters);  // Let the filters settle on the new zero
+  motionTiltReset(tilt);
+  motionGestureReset(gestures, gestureThresholds, MOTION_SAMPLE_RATE);
+}
+
+const MotionFilterBank &motionCaptureFilters() {
+  return filters;
+}
+
+const MotionTiltEstimator &motionCaptureTilt() {
+  return tilt;
+}
+
+unsigned long motionCaptureIdleMs() {
+  return (unsigned long)(samplesWritten - lastActiveSample) * 1000 / MOTION_SAMPLE_RATE;
+}
+
+void motionCaptureSleep() {
+  detachInterrupt(digitalPinToInterrupt(MOTION_INT_PIN));
+
+  // Nothing queued or latched to hold INT1 high
+  writeRegister(LIS3DH_CTRL_REG3, 0);
+  writeRegister(LIS3DH_FIFO_CTRL_REG, 0);  // Bypass: the FIFO stops collecting
+  readRegister(LIS3DH_CLICK_SRC);
+
+  awakeCtrlReg1 = readRegister(LIS3DH_CTRL_REG1);
+  awakeCtrlReg2 = readRegister(LIS3DH_CTRL_REG2);
+  writeRegister(LIS3DH_CTRL_REG1, LIS3DH_ODR_10_LOW_POWER);
+
+  // Wake-up: high-passed so the resting orientation does not count
+  writeRegister(LIS3DH_CTRL_REG2, awakeCtrlReg2 | LIS3DH_HPIS1);
+  readRegister(LIS3DH_REFERENCE);  // Settles the high-pass filter on the current reading
+  writeRegister(LIS3DH_INT1_THS, MOTION_WAKE_THRESHOLD);
+  writeRegister(LIS3DH_INT1_DURATION, 0);
+  writeRegister(LIS3DH_INT1_CFG, LIS3DH_INT1_HIGH_XYZ);
+  readRegister(LIS3DH_INT1_SRC);
+  writeRegister(LIS3DH_CTRL_REG3, LIS3DH_I1_IA1);
+}
+
+void motionCaptureWake() {
+  writeRegister(LIS3DH_CTRL_REG3, 0);
+  writeRegister(LIS3DH_INT1_CFG, 0);
+  readRegister(LIS3DH_INT1_SRC);
+  writeRegister(LIS3DH_CTRL_REG2, awakeCtrlReg2);
+  writeRegister(LIS3DH_CTRL_REG1, awakeCtrlReg1);
+
+  // Back to stream mode from empty, then the usual interrupts
+  writeRegister(LIS3DH_FIFO_CTRL_REG, LIS3DH_FIFO_STREAM | fifoWatermark());
+  readRegister(LIS3DH_CLICK_SRC);
+  writeRegister(LIS3DH_CTRL_REG3, LIS3DH_I1_CLICK | LIS3DH_I1_WTM);
+
+  motionDecimatorReset(decimator, decimator.factor);
+  motionFilterReset(filters);
+  motionTiltReset(tilt);
+  motionGestureReset(gestures, gestureThresholds, MOTION_SAMPLE_RATE);
+  lastActiveSample = samplesWritten;
+  fifoReady = true;
+  attachInterrupt(digitalPinToInterrupt(MOTION_INT_PIN), onMotionInterrupt, RISING);
+}
+
+uint32_t motionCaptureSamplesWritten() {
+  return samplesWritten;
+}
+
+bool motionCaptureLatest(MotionSample &sample) {
+  uint32_t written = samplesWritten;
+  if (written == 0) {
+    return false;
+  }
+  sample = sampleRing[(written - 1) & (MOTION_RING_SAMPLES - 1)];
+  return true;
+}
+
+bool motionCaptureRead(MotionSample &sample, uint32_t &cursor) {
+  uint32_t written = samplesWritten;
+  if ((int32_t)(written - cursor) <= 0) {
+    return false;
+  }
+  if (written - cursor > MOTION_RING_SAMPLES) {
+    cursor = written - MOTION_RING_SAMPLES;  // Fell behind; the older samples are gone
+  }
+  sample = sampleRing[cursor & (MOTION_RING_SAMPLES - 1)];
+  cursor++;
+  return true;
+}
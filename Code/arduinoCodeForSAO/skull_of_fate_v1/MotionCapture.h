@@ -0,0 +1,127 @@
+// MotionCapture.h
+
+#ifndef MOTIONCAPTURE_H
+#define MOTIONCAPTURE_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "MotionPipeline.h"
+
+// Batched accelerometer capture. The LIS3DH collects samples in its 32-deep
+// FIFO (stream mode) and raises INT1 once MOTION_FIFO_WATERMARK of them are
+// waiting; motionCaptureService() then drains the FIFO with one burst read
+// into the sample ring below. Consumers read the ring instead of the bus,
+// so the shared I2C bus sees a few transactions per burst instead of one
+// per animation frame. Each drained sample is converted to calibrated
+// 12-bit counts and run through the shared filter bank, so filters see
+// evenly spaced samples.
+// INT2 is not wired, so the click (tap) engine shares INT1; taps are read
+// from CLICK_SRC when the line rises and handed to a callback as events.
+// Motion gestures (shake, face down / up, tilt, spin) are recognized from the
+// filter bank as each sample is drained and delivered the same way.
+// The chip may sample faster than the pipeline (200 or 400 Hz); groups of
+// samples are then averaged down to MOTION_SAMPLE_RATE before anything else
+// sees them, and a shared tilt estimate (pitch, roll, motion energy) is
+// updated from each result.
+
+#define MOTION_I2C_ADDRESS 0x18  // LIS3DH, SDO high
+#define MOTION_INT_PIN 10        // LIS3DH INT1
+
+#define MOTION_SAMPLE_RATE 100     // Hz after decimation: ring, filters, gestures
+#define MOTION_DEFAULT_ODR 200     // Hz the chip samples at, Config.accel_rate (100, 200 or 400)
+#define MOTION_FIFO_DEPTH 32
+#define MOTION_FIFO_WATERMARK 5    // Pipeline samples per burst: 20 bursts a second, 50 ms latency
+#define MOTION_BURST_SAMPLES 32    // Most samples per I2C read (6 bytes each; SAMD Wire buffers 256)
+#define MOTION_RING_SAMPLES 64     // Sample history, power of two
+
+// Activity for auto-sleep: motion energy past this counts as handling
+#define MOTION_ACTIVITY_THRESHOLD 40   // Counts, |x| + |y| + |z| high-passed
+
+// While asleep the chip samples at 10 Hz in low-power mode and raises INT1
+// when high-passed acceleration on any axis passes the wake threshold
+#define MOTION_WAKE_THRESHOLD 6        // INT1_THS, 16 mg per step at +/-2 g: ~0.1 g
+
+// Click engine: single and double taps on all axes, latched until read
+#define MOTION_CLICK_AXES 0x3F  // CLICK_CFG: XS XD YS YD ZS ZD
+
+enum MotionTapType : uint8_t {
+  MOTION_TAP_SINGLE = 1,
+  MOTION_TAP_DOUBLE
+};
+
+struct MotionTap {
+  MotionTapType type;
+  char axis;       // 'x', 'y' or 'z': first axis that saw the tap
+  bool negative;   // Tap was towards -axis
+  uint8_t source;  // Raw CLICK_SRC, same bits as Adafruit_LIS3DH::getClick()
+};
+
+// Called from motionCaptureService() (main loop, never an interrupt)
+typedef void (*MotionTapCallback)(const MotionTap &tap);
+void motionCaptureSetTapCallback(MotionTapCallback callback);
+
+// Called from motionCaptureService() once a gesture completes
+typedef void (*MotionGestureCallback)(MotionGesture gesture);
+void motionCaptureSetGestureCallback(MotionGestureCallback callback);
+
+// Mutes tap and gesture callbacks, e.g. while the card is being calibrated
+void motionCaptureEnableGestures(bool enabled);
+
+// Gesture thresholds, from Config.motion_gestures
+void motionCaptureSetGestureThresholds(const MotionGestureThresholds &thresholds);
+
+// One reading, calibrated 12-bit counts (MOTION_COUNTS_PER_G per g)
+struct MotionSample {
+  int16_t x;
+  int16_t y;
+  int16_t z;
+};
+
+// Sets the chip's output data rate, rounded to 100, 200 or 400 Hz, and the
+// decimation down to MOTION_SAMPLE_RATE. Returns the rate used. Call before
+// motionCaptureBegin() (the FIFO watermark follows the rate).
+uint16_t motionCaptureSetDataRate(uint16_t hz);
+
+// Enables the FIFO, the watermark interrupt and tap interrupts; call after
+// the LIS3DH has been started and its range, data rate and click thresholds set
+bool motionCaptureBegin();
+
+// Handles a raised INT1: dispatches any tap and drains the FIFO into the ring.
+// Returns the number of new samples. Cheap to call every frame; the bus is
+// only used when the line has fired.
+uint8_t motionCaptureService();
+
+// Zero offsets in 12-bit counts and the measured counts per g (0 = nominal),
+// from Config.accel_calibration
+void motionCaptureSetCalibration(int16_t x, int16_t y, int16_t z, int16_t scale);
+
+// Low-pass / gravity / high-pass filters, updated for every captured sample
+const MotionFilterBank &motionCaptureFilters();
+
+// Smoothed gravity vector, pitch, roll and motion energy for tilt-driven effects
+const MotionTiltEstimator &motionCaptureTilt();
+
+// Milliseconds of samples since the card last moved
+unsigned long motionCaptureIdleMs();
+
+// Parks the LIS3DH for standby: FIFO and taps off, 10 Hz low-power sampling
+// and a wake-up interrupt on INT1. The INT1 pin interrupt is detached so
+// the sleep code can attach its own.
+void motionCaptureSleep();
+
+// Restores the data rate, FIFO and tap interrupts after motionCaptureSleep().
+// The filters and gestures start over, and the wake counts as movement.
+void motionCaptureWake();
+
+// Total samples written since capture started (wraps at 2^32)
+uint32_t motionCaptureSamplesWritten();
+
+// Newest sample; returns false until one has been captured
+bool motionCaptureLatest(MotionSample &sample);
+
+// Sequential reader. 'cursor' is the index of the next sample to read
+// (start it at motionCaptureSamplesWritten()). Returns false once it has
+// caught up. A reader that falls behind skips to the oldest sample still held.
+bool motionCaptureRead(MotionSample &sample, uint32_t &cursor);
+
+#endif  // MOTIONCAPTURE_H
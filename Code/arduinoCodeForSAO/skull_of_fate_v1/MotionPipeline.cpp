@@ -0,0 +1,413 @@
+// MotionPipeline.cpp
+
+#include "MotionPipeline.h"
+
+void motionFilterReset(MotionFilterBank &bank) {
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    bank.lowpassState[axis] = 0;
+    bank.gravityState[axis] = 0;
+    bank.lowpass[axis] = 0;
+    bank.gravity[axis] = 0;
+    bank.motion[axis] = 0;
+  }
+  bank.started = false;
+}
+
+void motionFilterUpdate(MotionFilterBank &bank, const int16_t* counts) {
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    int32_t sample = (int32_t)counts[axis] << 8;
+
+    // Start settled on the first sample instead of ramping up from zero
+    if (!bank.started) {
+      bank.lowpassState[axis] = sample;
+      bank.gravityState[axis] = sample;
+    }
+
+    bank.lowpassState[axis] += ((sample - bank.lowpassState[axis]) * MOTION_LOWPASS_ALPHA) >> 8;
+    bank.gravityState[axis] += ((sample - bank.gravityState[axis]) * MOTION_GRAVITY_ALPHA) >> 8;
+
+    bank.lowpass[axis] = bank.lowpassState[axis] >> 8;
+    bank.gravity[axis] = bank.gravityState[axis] >> 8;
+    bank.motion[axis] = counts[axis] - bank.gravity[axis];
+  }
+  bank.started = true;
+}
+
+void motionPoseReset(MotionPoseAverage &pose) {
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    pose.sum[axis] = 0;
+    pose.low[axis] = INT16_MAX;
+    pose.high[axis] = INT16_MIN;
+  }
+  pose.count = 0;
+}
+
+void motionPoseAdd(MotionPoseAverage &pose, const int16_t* counts) {
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    pose.sum[axis] += counts[axis];
+    if (counts[axis] < pose.low[axis]) {
+      pose.low[axis] = counts[axis];
+    }
+    if (counts[axis] > pose.high[axis]) {
+      pose.high[axis] = counts[axis];
+    }
+  }
+  pose.count++;
+}
+
+bool motionPoseSteady(const MotionPoseAverage &pose) {
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    if (pose.count > 0 && pose.high[axis] - pose.low[axis] > MOTION_POSE_SPREAD) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void motionPoseMean(const MotionPoseAverage &pose, int16_t* mean) {
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    mean[axis] = pose.count > 0 ? pose.sum[axis] / pose.count : 0;
+  }
+}
+
+static int16_t magnitude16(int16_t value) {
+  return value < 0 ? -value : value;
+}
+
+bool motionCalibrationSolve(const int16_t* flat, const int16_t* edge, MotionCalibration &calibration) {
+  const int16_t low = MOTION_COUNTS_PER_G - MOTION_POSE_TOLERANCE;
+
+  // Flat: gravity straight down through the face
+  if (flat[2] < low || magnitude16(flat[0]) > MOTION_POSE_TOLERANCE || magnitude16(flat[1]) > MOTION_POSE_TOLERANCE) {
+    return false;
+  }
+
+  // Edge: gravity along x or y, none through the face
+  uint8_t down = magnitude16(edge[0]) > magnitude16(edge[1]) ? 0 : 1;
+  uint8_t level = 1 - down;
+  if (magnitude16(edge[down]) < low || magnitude16(edge[2]) > MOTION_POSE_TOLERANCE) {
+    return false;
+  }
+
+  calibration.offset[down] = flat[down];
+  calibration.offset[level] = (flat[level] + edge[level]) / 2;  // Level in both poses
+  calibration.offset[2] = edge[2];
+
+  int16_t scaleZ = flat[2] - calibration.offset[2];
+  int16_t scaleEdge = magnitude16(edge[down] - calibration.offset[down]);
+  calibration.scale = (scaleZ + scaleEdge) / 2;
+  return calibration.scale >= low && calibration.scale <= MOTION_COUNTS_PER_G + MOTION_POSE_TOLERANCE;
+}
+
+int16_t motionCalibrationGain(int16_t scale) {
+  if (scale <= 0) {
+    return MOTION_UNITY_GAIN;
+  }
+  return ((int32_t)MOTION_COUNTS_PER_G * MOTION_UNITY_GAIN + scale / 2) / scale;
+}
+
+// First octant arctangent: atan(i / 32) in 0-255 turn units, i = 0..32
+static const uint8_t octantAngle[33] = {
+  0, 1, 3, 4, 5, 6, 8, 9, 10, 11, 12, 13, 15, 16, 17, 18,
+  19, 20, 21, 22, 23, 24, 25, 25, 26, 27, 28, 29, 29, 30, 31, 31, 32
+};
+
+uint8_t motionAngle8(int16_t x, int16_t y) {
+  int32_t ax = x < 0 ? -x : x;
+  int32_t ay = y < 0 ? -y : y;
+  if (ax == 0 && ay == 0) {
+    return 0;
+  }
+
+  // Angle from the axis the vector is closest to, then fold into the quadrant
+  uint8_t angle;
+  if (ax >= ay) {
+    angle = octantAngle[(ay * 32 + ax / 2) / ax];
+  } else {
+    angle = 64 - octantAngle[(ax * 32 + ay / 2) / ay];
+  }
+  if (x < 0) {
+    angle = 128 - angle;
+  }
+  if (y < 0) {
+    angle = -angle;
+  }
+  return angle;
+}
+
+static uint16_t samplesFor(const MotionGestureDetector &detector, uint16_t ms) {
+  return (uint32_t)ms * detector.sampleRate / 1000;
+}
+
+void motionGestureReset(MotionGestureDetector &detector, const MotionGestureThresholds &thresholds, uint16_t sampleRate) {
+  detector.thresholds = thresholds;
+  detector.sampleRate = sampleRate;
+  detector.cooldown = 0;
+  detector.shakeSign = 0;
+  detector.shakeInPeak = false;
+  detector.shakePeaks = 0;
+  detector.shakeGap = 0;
+  detector.faceDown = false;
+  detector.faceDownSamples = 0;
+  detector.tiltSide = 0;
+  detector.tiltSamples = 0;
+  detector.tiltArmed = true;
+  detector.angleValid = false;
+  detector.lastAngle = 0;
+  detector.spinTotal = 0;
+  detector.spinSamples = 0;
+  detector.spinDirection = 0;
+}
+
+// Alternating high-pass peaks on whichever axis moves most
+static bool shakeUpdate(MotionGestureDetector &detector, const MotionFilterBank &bank) {
+  uint8_t axis = 0;
+  for (uint8_t a = 1; a < 3; a++) {
+    int16_t m = bank.motion[a] < 0 ? -bank.motion[a] : bank.motion[a];
+    int16_t best = bank.motion[axis] < 0 ? -bank.motion[axis] : bank.motion[axis];
+    if (m > best) {
+      axis = a;
+    }
+  }
+  int16_t value = bank.motion[axis];
+  int16_t magnitude = value < 0 ? -value : value;
+
+  if (detector.shakeGap < 0xFFFF) {
+    detector.shakeGap++;
+  }
+  if (detector.shakeGap > samplesFor(detector, SHAKE_GAP_MS)) {
+    detector.shakePeaks = 0;
+    detector.shakeSign = 0;
+  }
+
+  if (magnitude < detector.thresholds.shake / 2) {
+    detector.shakeInPeak = false;  // Hysteresis: dropped well back before the next peak
+    return false;
+  }
+  if (magnitude < detector.thresholds.shake || detector.shakeInPeak) {
+    return false;
+  }
+
+  // A new peak; it only counts if it swings the other way
+  int8_t sign = value < 0 ? -1 : 1;
+  detector.shakeInPeak = true;
+  if (sign != detector.shakeSign) {
+    detector.shakeSign = sign;
+    detector.shakePeaks++;
+    detector.shakeGap = 0;
+  }
+  if (detector.shakePeaks >= SHAKE_PEAKS) {
+    detector.shakePeaks = 0;
+    detector.shakeSign = 0;
+    return true;
+  }
+  return false;
+}
+
+// Gravity in the x/y plane turning steadily one way
+static bool spinUpdate(MotionGestureDetector &detector, const MotionFilterBank &bank) {
+  int16_t x = bank.lowpass[0];
+  int16_t y = bank.lowpass[1];
+  int16_t ax = x < 0 ? -x : x;
+  int16_t ay = y < 0 ? -y : y;
+  if ((ax > ay ? ax : ay) < SPIN_MIN_TILT) {
+    // Lying too flat to tell which way is down in the plane
+    detector.angleValid = false;
+    detector.spinTotal = 0;
+    detector.spinSamples = 0;
+    return false;
+  }
+
+  uint8_t angle = motionAngle8(x, y);
+  if (!detector.angleValid) {
+    detector.angleValid = true;
+    detector.lastAngle = angle;
+    return false;
+  }
+
+  int8_t delta = (int8_t)(angle - detector.lastAngle);
+  detector.lastAngle = angle;
+  if (delta != 0 && detector.spinTotal != 0 && (delta > 0) != (detector.spinTotal > 0)) {
+    // Turned back: start over from here
+    detector.spinTotal = 0;
+    detector.spinSamples = 0;
+  }
+  detector.spinTotal += delta;
+  if (detector.spinTotal == 0) {
+    detector.spinSamples = 0;  // Holding still: the window starts with the turn
+  } else {
+    detector.spinSamples++;
+  }
+
+  if (detector.spinSamples > samplesFor(detector, SPIN_WINDOW_MS)) {
+    detector.spinTotal = 0;
+    detector.spinSamples = 0;
+  }
+
+  int16_t needed = (uint32_t)detector.thresholds.spin * 256 / 360;
+  if (detector.spinTotal >= needed || detector.spinTotal <= -needed) {
+    detector.spinDirection = detector.spinTotal > 0 ? 1 : -1;
+    detector.spinTotal = 0;
+    detector.spinSamples = 0;
+    return true;
+  }
+  return false;
+}
+
+MotionGesture motionGestureUpdate(MotionGestureDetector &detector, const MotionFilterBank &bank) {
+  if (!bank.started) {
+    return MOTION_GESTURE_NONE;
+  }
+
+  // Face down / up follows gravity alone and is never held back by the cooldown
+  if (!detector.faceDown) {
+    if (bank.gravity[2] < FACE_DOWN_Z) {
+      if (++detector.faceDownSamples >= samplesFor(detector, detector.thresholds.flipMs)) {
+        detector.faceDown = true;
+        return MOTION_GESTURE_FACE_DOWN;
+      }
+    } else {
+      detector.faceDownSamples = 0;
+    }
+  } else if (bank.gravity[2] > FACE_UP_Z) {
+    detector.faceDown = false;
+    detector.faceDownSamples = 0;
+    return MOTION_GESTURE_FACE_UP;
+  }
+
+  bool shaken = shakeUpdate(detector, bank);
+  bool spun = spinUpdate(detector, bank);
+
+  if (detector.cooldown > 0) {
+    detector.cooldown--;
+    return MOTION_GESTURE_NONE;
+  }
+  if (shaken) {
+    detector.cooldown = samplesFor(detector, GESTURE_COOLDOWN_MS);
+    return MOTION_GESTURE_SHAKE;
+  }
+  if (spun) {
+    detector.cooldown = samplesFor(detector, GESTURE_COOLDOWN_MS);
+    return MOTION_GESTURE_SPIN;
+  }
+
+  // Tilt: held to one side while upright and not part of a turn or a shake
+  int16_t x = bank.lowpass[0];
+  int16_t threshold = detector.thresholds.tilt;
+  int8_t side = x > threshold ? 1 : (x < -threshold ? -1 : 0);
+  bool turning = detector.spinTotal > 64 || detector.spinTotal < -64;  // A quarter turn in progress
+  if (x < threshold / 2 && x > -threshold / 2) {
+    detector.tiltArmed = true;
+  }
+  if (side == 0 || side != detector.tiltSide || detector.faceDown || turning || detector.shakePeaks > 0) {
+    detector.tiltSide = side;
+    detector.tiltSamples = 0;
+    return MOTION_GESTURE_NONE;
+  }
+  if (detector.tiltArmed && ++detector.tiltSamples >= samplesFor(detector, TILT_HOLD_MS)) {
+    detector.tiltArmed = false;
+    detector.tiltSamples = 0;
+    return side > 0 ? MOTION_GESTURE_TILT_RIGHT : MOTION_GESTURE_TILT_LEFT;
+  }
+  return MOTION_GESTURE_NONE;
+}
+
+void motionDecimatorReset(MotionDecimator &decimator, uint8_t factor) {
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    decimator.sum[axis] = 0;
+  }
+  decimator.count = 0;
+  decimator.factor = factor > 0 ? factor : 1;
+}
+
+bool motionDecimate(MotionDecimator &decimator, const int16_t* counts, int16_t* out) {
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    decimator.sum[axis] += counts[axis];
+  }
+  if (++decimator.count < decimator.factor) {
+    return false;
+  }
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    out[axis] = decimator.sum[axis] / decimator.factor;
+    decimator.sum[axis] = 0;
+  }
+  decimator.count = 0;
+  return true;
+}
+
+static uint16_t squareRoot(uint32_t value) {
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > value) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+void motionTiltReset(MotionTiltEstimator &tilt) {
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    tilt.state[axis] = 0;
+    tilt.vector[axis] = 0;
+  }
+  tilt.energyState = 0;
+  tilt.started = false;
+  tilt.pitch = 0;
+  tilt.roll = 0;
+  tilt.energy = 0;
+}
+
+void motionTiltUpdate(MotionTiltEstimator &tilt, const int16_t* counts, const MotionFilterBank &bank) {
+  // How far the reading is from the estimate decides the filter weight
+  int32_t difference = 0;
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    int32_t d = ((int32_t)counts[axis] << 8) - tilt.state[axis];
+    if (d < 0) {
+      d = -d;
+    }
+    if (d > difference) {
+      difference = d;
+    }
+  }
+  difference >>= 8;
+  if (difference > MOTION_TILT_BLEND_RANGE) {
+    difference = MOTION_TILT_BLEND_RANGE;
+  }
+  int32_t alpha = MOTION_TILT_ALPHA_MIN +
+                  (MOTION_TILT_ALPHA_MAX - MOTION_TILT_ALPHA_MIN) * difference / MOTION_TILT_BLEND_RANGE;
+
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    int32_t sample = (int32_t)counts[axis] << 8;
+    if (!tilt.started) {
+      tilt.state[axis] = sample;
+    }
+    tilt.state[axis] += ((sample - tilt.state[axis]) * alpha) >> 8;
+    tilt.vector[axis] = tilt.state[axis] >> 8;
+  }
+
+  int32_t movement = 0;
+  for (uint8_t axis = 0; axis < 3; axis++) {
+    movement += bank.motion[axis] < 0 ? -bank.motion[axis] : bank.motion[axis];
+  }
+  if (!tilt.started) {
+    tilt.energyState = movement << 8;
+  }
+  tilt.energyState += (((movement << 8) - tilt.energyState) * MOTION_ENERGY_ALPHA) >> 8;
+  tilt.energy = tilt.energyState >> 8;
+  tilt.started = true;
+
+  // Roll turns around y (x against z); pitch is y against the rest of gravity
+  int32_t x = tilt.vector[0];
+  int32_t y = tilt.vector[1];
+  int32_t z = tilt.vector[2];
+  tilt.roll = (int8_t)motionAngle8(z, x);
+  tilt.pitch = (int8_t)motionAngle8(squareRoot(x * x + z * z), y);
+}
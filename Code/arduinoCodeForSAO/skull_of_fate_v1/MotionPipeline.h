@@ -0,0 +1,199 @@
+// MotionPipeline.h
+
+#ifndef MOTIONPIPELINE_H
+#define MOTIONPIPELINE_H
+
+#include <stdint.h>
+
+// Accelerometer processing shared by every motion consumer. Works on
+// calibrated 12-bit counts (the LIS3DH high-resolution output, +/-2 g) with
+// integer one-pole filters, one update per FIFO sample. No Arduino dependencies.
+
+#define MOTION_COUNTS_PER_G 1024  // 12-bit counts per g at +/-2 g
+#define MOTION_RAW_SHIFT 4        // The LIS3DH left-justifies its 12 bits in 16
+#define MOTION_UNITY_GAIN 1024    // Scale correction, Q10
+
+// Filter coefficients, fraction of the way to the new sample per sample, /256
+#define MOTION_LOWPASS_ALPHA 51  // 0.2: smooths hand jitter, ~45 ms at 100 Hz
+#define MOTION_GRAVITY_ALPHA 8   // 0.03: slow enough to follow only gravity, ~0.3 s at 100 Hz
+
+struct MotionFilterBank {
+  int32_t lowpassState[3];  // Counts, 24.8 fixed point
+  int32_t gravityState[3];
+  bool started;
+
+  // Outputs, counts
+  int16_t lowpass[3];  // Smoothed acceleration, for tilt
+  int16_t gravity[3];  // Gravity direction
+  int16_t motion[3];   // High-passed: acceleration minus gravity, for movement
+};
+
+// 12-bit count from a raw left-justified axis reading, less its calibration
+// offset and corrected by the Q10 gain so 1 g reads MOTION_COUNTS_PER_G
+static inline int16_t motionCounts(int16_t raw, int16_t offset, int16_t gain) {
+  return ((int32_t)((raw >> MOTION_RAW_SHIFT) - offset) * gain) >> 10;
+}
+
+// Clears the filters; the next sample seeds them
+void motionFilterReset(MotionFilterBank &bank);
+
+// Feeds one calibrated sample (x, y, z counts)
+void motionFilterUpdate(MotionFilterBank &bank, const int16_t* counts);
+
+// Decimation from the chip's output rate down to the pipeline rate. The
+// LIS3DH can run at 200 or 400 Hz; averaging each group of 'factor' samples
+// filters out what the pipeline rate cannot represent and lowers the noise
+// by sqrt(factor), so everything downstream keeps its 100 Hz timing.
+struct MotionDecimator {
+  int32_t sum[3];
+  uint8_t count;
+  uint8_t factor;  // Input samples per output sample, 1 = pass through
+};
+
+void motionDecimatorReset(MotionDecimator &decimator, uint8_t factor);
+
+// Adds one sample; returns true with the average in 'out' once every 'factor' samples
+bool motionDecimate(MotionDecimator &decimator, const int16_t* counts, int16_t* out);
+
+// Tilt estimate shared by the tilt-driven effects, updated for every
+// pipeline sample. A complementary pair of one-pole filters on the gravity
+// vector: while the card is held steady the heavy filter wins and hides hand
+// jitter; when the reading moves away from the estimate the weight shifts to
+// the light filter so a real tilt is followed with almost no lag. Pitch and
+// roll come from the smoothed vector; the motion energy is the smoothed size
+// of the high-passed acceleration.
+#define MOTION_TILT_ALPHA_MIN 13      // 0.05 /256: steady
+#define MOTION_TILT_ALPHA_MAX 192     // 0.75 /256: moving
+#define MOTION_TILT_BLEND_RANGE 128   // Difference (counts) where the light filter has fully taken over
+#define MOTION_ENERGY_ALPHA 26        // 0.1 /256
+
+struct MotionTiltEstimator {
+  int32_t state[3];     // Counts, 24.8 fixed point
+  int32_t energyState;  // 24.8 fixed point
+  bool started;
+
+  // Outputs
+  int16_t vector[3];  // Smoothed gravity direction, counts
+  int8_t pitch;       // Binary angle (64 = 90 degrees): +y edge raised is positive
+  int8_t roll;        // Binary angle (-128..127): +x edge raised is positive, 0 flat face up
+  uint16_t energy;    // |x| + |y| + |z| of the high-passed acceleration, counts
+};
+
+void motionTiltReset(MotionTiltEstimator &tilt);
+
+// Feeds one calibrated sample and the filter bank it has just updated
+void motionTiltUpdate(MotionTiltEstimator &tilt, const int16_t* counts, const MotionFilterBank &bank);
+
+// Guided calibration from two held poses: flat face up (gravity on +z), then
+// standing on an edge (gravity on x or y). Each pose is averaged from raw
+// counts and only accepted while the card is held still.
+#define MOTION_POSE_SPREAD 100       // Largest swing on any axis while holding still (~0.1 g)
+#define MOTION_POSE_TOLERANCE 256    // How far off square a pose may be (0.25 g)
+
+struct MotionPoseAverage {
+  int32_t sum[3];
+  int16_t low[3];
+  int16_t high[3];
+  uint16_t count;
+};
+
+struct MotionCalibration {
+  int16_t offset[3];  // Zero offsets, counts
+  int16_t scale;      // Measured counts per g
+};
+
+void motionPoseReset(MotionPoseAverage &pose);
+void motionPoseAdd(MotionPoseAverage &pose, const int16_t* counts);
+
+// True while every axis has stayed within MOTION_POSE_SPREAD
+bool motionPoseSteady(const MotionPoseAverage &pose);
+void motionPoseMean(const MotionPoseAverage &pose, int16_t* mean);
+
+// Offsets and scale from the flat and edge averages. The flat pose gives the
+// x / y offsets and the z sensitivity, the edge pose the z offset and the
+// sensitivity of the axis it stood on. Returns false if either pose was not
+// held square or the sensitivity is implausible.
+bool motionCalibrationSolve(const int16_t* flat, const int16_t* edge, MotionCalibration &calibration);
+
+// Q10 gain that turns a measured counts-per-g scale into MOTION_COUNTS_PER_G
+int16_t motionCalibrationGain(int16_t scale);
+
+// Motion gestures, recognized one sample at a time from the filter bank
+// with a small state machine per gesture and fixed memory:
+//   shake      - SHAKE_PEAKS high-pass peaks of alternating sign in quick succession
+//   face down  - gravity on -z for flipMs; face up again once it is back on +z
+//   tilt       - sideways gravity past the tilt threshold, held, then back to level
+//   spin       - the in-plane gravity direction turning a full 'spin' degrees
+//                within SPIN_WINDOW_MS (twirling the badge like a wheel)
+// Left / right follow the accelerometer demo's grid: +x is right.
+#define MOTION_DEFAULT_SHAKE 1536    // 1.5 g
+#define MOTION_DEFAULT_TILT 512      // 0.5 g sideways, 30 degrees
+#define MOTION_DEFAULT_SPIN 360      // Degrees
+#define MOTION_DEFAULT_FLIP_MS 1000
+
+#define SHAKE_PEAKS 4                // Direction changes that make a shake
+#define SHAKE_GAP_MS 400             // Longest pause between them
+#define TILT_HOLD_MS 400             // How long a tilt must be held
+#define SPIN_WINDOW_MS 1500          // Time allowed for the turn
+#define SPIN_MIN_TILT 512            // In-plane gravity needed to see a turn (0.5 g)
+#define FACE_DOWN_Z (-3 * MOTION_COUNTS_PER_G / 4)
+#define FACE_UP_Z (MOTION_COUNTS_PER_G / 2)
+#define GESTURE_COOLDOWN_MS 1000     // Quiet time after a shake or spin
+
+enum MotionGesture : uint8_t {
+  MOTION_GESTURE_NONE = 0,
+  MOTION_GESTURE_SHAKE,
+  MOTION_GESTURE_FACE_DOWN,
+  MOTION_GESTURE_FACE_UP,
+  MOTION_GESTURE_TILT_LEFT,
+  MOTION_GESTURE_TILT_RIGHT,
+  MOTION_GESTURE_SPIN
+};
+
+struct MotionGestureThresholds {
+  int16_t shake;    // High-pass peak, counts
+  int16_t tilt;     // Sideways gravity, counts
+  uint16_t spin;    // Turn, degrees
+  uint16_t flipMs;  // Face down this long before it counts
+};
+
+struct MotionGestureDetector {
+  MotionGestureThresholds thresholds;
+  uint16_t sampleRate;
+  uint16_t cooldown;       // Samples left before shake / spin / tilt can fire again
+
+  // Shake
+  int8_t shakeSign;        // Sign of the last peak
+  bool shakeInPeak;        // Still above the threshold from that peak
+  uint8_t shakePeaks;
+  uint16_t shakeGap;       // Samples since the last peak
+
+  // Face down
+  bool faceDown;
+  uint16_t faceDownSamples;
+
+  // Tilt
+  int8_t tiltSide;         // -1 left, 1 right, 0 level
+  uint16_t tiltSamples;
+  bool tiltArmed;          // Back to level since the last tilt
+
+  // Spin
+  bool angleValid;
+  uint8_t lastAngle;       // 0-255 = one turn
+  int16_t spinTotal;       // Turn so far, 256 per revolution, signed
+  uint16_t spinSamples;
+
+  // Direction of the last spin: 1 counter-clockwise (+x towards +y), -1 clockwise
+  int8_t spinDirection;
+};
+
+// Angle of (x, y), 0-255 = one turn, 0 = +x, 64 = +y (within ~1.5 degrees)
+uint8_t motionAngle8(int16_t x, int16_t y);
+
+// Clears the detector and sets its thresholds and the sample rate in Hz
+void motionGestureReset(MotionGestureDetector &detector, const MotionGestureThresholds &thresholds, uint16_t sampleRate);
+
+// Feeds one sample's filter outputs; returns a gesture when one completes
+MotionGesture motionGestureUpdate(MotionGestureDetector &detector, const MotionFilterBank &bank);
+
+#endif  // MOTIONPIPELINE_H
@@ -96,7 +96,7 @@ void NFCWriter::writeCCFile() {
 
 }
 
-void NFCWriter::writeRandomURI(bool fullRange) {
+uint8_t NFCWriter::writeRandomURI(bool fullRange) {
     // Generate a random number based on the range
     uint8_t randomNumber;
     
@@ -180,6 +180,8 @@ void NFCWriter::writeRandomURI(bool fullRange) {
     
     // Verify the written data
     verifyWrite(memLoc);
+
+    return randomNumber;
 }
 
 void NFCWriter::verifyWrite(uint16_t totalSize) {
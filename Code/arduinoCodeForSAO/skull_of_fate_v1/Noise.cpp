@@ -0,0 +1,138 @@
+// Noise.cpp
+
+#include "Noise.h"
+
+// Ken Perlin's reference permutation
+const uint8_t noisePerm[256] PROGMEM = {
+  151, 160, 137, 91, 90, 15, 131, 13, 201, 95, 96, 53, 194, 233, 7, 225,
+  140, 36, 103, 30, 69, 142, 8, 99, 37, 240, 21, 10, 23, 190, 6, 148,
+  247, 120, 234, 75, 0, 26, 197, 62, 94, 252, 219, 203, 117, 35, 11, 32,
+  57, 177, 33, 88, 237, 149, 56, 87, 174, 20, 125, 136, 171, 168, 68, 175,
+  74, 165, 71, 134, 139, 48, 27, 166, 77, 146, 158, 231, 83, 111, 229, 122,
+  60, 211, 133, 230, 220, 105, 92, 41, 55, 46, 245, 40, 244, 102, 143, 54,
+  65, 25, 63, 161, 1, 216, 80, 73, 209, 76, 132, 187, 208, 89, 18, 169,
+  200, 196, 135, 130, 116, 188, 159, 86, 164, 100, 109, 198, 173, 186, 3, 64,
+  52, 217, 226, 250, 124, 123, 5, 202, 38, 147, 118, 126, 255, 82, 85, 212,
+  207, 206, 59, 227, 47, 16, 58, 17, 182, 189, 28, 42, 223, 183, 170, 213,
+  119, 248, 152, 2, 44, 154, 163, 70, 221, 153, 101, 155, 167, 43, 172, 9,
+  129, 22, 39, 253, 19, 98, 108, 110, 79, 113, 224, 232, 178, 185, 112, 104,
+  218, 246, 97, 228, 251, 34, 242, 193, 238, 210, 144, 12, 191, 179, 162, 241,
+  81, 51, 145, 235, 249, 14, 239, 107, 49, 192, 214, 31, 181, 199, 106, 157,
+  184, 84, 204, 176, 115, 121, 50, 45, 127, 4, 150, 254, 138, 236, 205, 93,
+  222, 114, 67, 29, 24, 72, 243, 141, 128, 195, 78, 66, 215, 61, 156, 180
+};
+
+static inline uint8_t perm(uint8_t i) {
+  return pgm_read_byte(&noisePerm[i]);
+}
+
+// Smoothstep 3t^2 - 2t^3 on a 0-255 fraction
+static inline uint8_t fade(uint8_t t) {
+  return ((uint32_t)t * t * (768 - 2 * t)) >> 16;
+}
+
+static inline int16_t lerp(int16_t a, int16_t b, uint8_t t) {
+  return a + (((int32_t)(b - a) * t) >> 8);
+}
+
+// Dot product with one of Perlin's 12 cube-edge gradients (16 cases, 4 repeated)
+static inline int16_t grad3(uint8_t hash, int16_t x, int16_t y, int16_t z) {
+  hash &= 15;
+  int16_t u = (hash < 8) ? x : y;
+  int16_t v = (hash < 4) ? y : ((hash == 12 || hash == 14) ? x : z);
+  return ((hash & 1) ? -u : u) + ((hash & 2) ? -v : v);
+}
+
+// Dot product with one of the 4 diagonal gradients
+static inline int16_t grad2(uint8_t hash, int16_t x, int16_t y) {
+  return ((hash & 1) ? -x : x) + ((hash & 2) ? -y : y);
+}
+
+// Raw results stay within about +/-256; scale to 0-255 and clamp
+static inline uint8_t toUnsigned(int16_t n) {
+  n += 128;
+  if (n < 0) {
+    return 0;
+  }
+  if (n > 255) {
+    return 255;
+  }
+  return n;
+}
+
+uint8_t noise2D(uint16_t x, uint16_t y) {
+  uint8_t X = x >> 8;
+  uint8_t Y = y >> 8;
+  int16_t fx = x & 0xFF;
+  int16_t fy = y & 0xFF;
+  uint8_t u = fade(fx);
+  uint8_t v = fade(fy);
+
+  uint8_t A = perm(X) + Y;
+  uint8_t B = perm(X + 1) + Y;
+
+  int16_t n = lerp(lerp(grad2(perm(A), fx, fy), grad2(perm(B), fx - 256, fy), u),
+                   lerp(grad2(perm(A + 1), fx, fy - 256), grad2(perm(B + 1), fx - 256, fy - 256), u),
+                   v);
+  return toUnsigned(n >> 1);
+}
+
+uint8_t noise3D(uint16_t x, uint16_t y, uint16_t z) {
+  uint8_t X = x >> 8;
+  uint8_t Y = y >> 8;
+  uint8_t Z = z >> 8;
+  int16_t fx = x & 0xFF;
+  int16_t fy = y & 0xFF;
+  int16_t fz = z & 0xFF;
+  uint8_t u = fade(fx);
+  uint8_t v = fade(fy);
+  uint8_t w = fade(fz);
+
+  // Hash the 8 corners of the cell
+  uint8_t A = perm(X) + Y;
+  uint8_t AA = perm(A) + Z;
+  uint8_t AB = perm(A + 1) + Z;
+  uint8_t B = perm(X + 1) + Y;
+  uint8_t BA = perm(B) + Z;
+  uint8_t BB = perm(B + 1) + Z;
+
+  int16_t x1 = fx - 256;
+  int16_t y1 = fy - 256;
+  int16_t z1 = fz - 256;
+
+  int16_t n0 = lerp(lerp(grad3(perm(AA), fx, fy, fz), grad3(perm(BA), x1, fy, fz), u),
+                    lerp(grad3(perm(AB), fx, y1, fz), grad3(perm(BB), x1, y1, fz), u),
+                    v);
+  int16_t n1 = lerp(lerp(grad3(perm(AA + 1), fx, fy, z1), grad3(perm(BA + 1), x1, fy, z1), u),
+                    lerp(grad3(perm(AB + 1), fx, y1, z1), grad3(perm(BB + 1), x1, y1, z1), u),
+                    v);
+  int16_t n = lerp(n0, n1, w);
+
+  // 3D output peaks around +/-230, stretch it to fill 0-255
+  return toUnsigned((n * 9) >> 4);
+}
+
+uint8_t fractalNoise2D(uint16_t x, uint16_t y, uint8_t octaves) {
+  int16_t sum = 0;
+  uint8_t shift = 0;
+  for (uint8_t i = 0; i < octaves; i++) {
+    sum += ((int16_t)noise2D(x, y) - 128) >> shift;
+    x <<= 1;
+    y <<= 1;
+    shift++;
+  }
+  return toUnsigned(sum);
+}
+
+uint8_t fractalNoise3D(uint16_t x, uint16_t y, uint16_t z, uint8_t octaves) {
+  int16_t sum = 0;
+  uint8_t shift = 0;
+  for (uint8_t i = 0; i < octaves; i++) {
+    sum += ((int16_t)noise3D(x, y, z) - 128) >> shift;
+    x <<= 1;
+    y <<= 1;
+    z <<= 1;
+    shift++;
+  }
+  return toUnsigned(sum);
+}
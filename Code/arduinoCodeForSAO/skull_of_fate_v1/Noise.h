@@ -0,0 +1,25 @@
+// Noise.h
+
+#ifndef NOISE_H
+#define NOISE_H
+
+#include <Arduino.h>
+
+// Integer Perlin gradient noise.
+// Coordinates are 8.8 fixed point: the high byte picks the lattice cell and
+// the low byte is the position inside it, so adding 256 moves one cell.
+// The lattice repeats every 256 cells, so a coordinate wrapping at 65536
+// is seamless; derive slower axes (time >> n) from a wider counter so they
+// wrap at 65536 too. Results are 0-255 centered on 128.
+
+// Single octave 2D / 3D noise
+uint8_t noise2D(uint16_t x, uint16_t y);
+uint8_t noise3D(uint16_t x, uint16_t y, uint16_t z);
+
+// Sums 'octaves' layers, each at double the frequency and half the amplitude
+// of the one before (1 octave = plain noise3D). Use 3D with z = time for
+// animated 2D fields.
+uint8_t fractalNoise2D(uint16_t x, uint16_t y, uint8_t octaves);
+uint8_t fractalNoise3D(uint16_t x, uint16_t y, uint16_t z, uint8_t octaves);
+
+#endif  // NOISE_H
@@ -0,0 +1,173 @@
+// Palette.cpp
+
+#include "Palette.h"
+#include "ConfigManager.h"
+
+extern Config currentConfig;
+extern int animationIndex;
+
+// 16-stop palettes, { r, g, b } per stop
+const uint8_t palettes[NUM_PALETTES][PALETTE_STOPS][3] PROGMEM = {
+  // Classic
+  { { 255, 0, 0 }, { 0, 255, 0 }, { 0, 0, 255 }, { 255, 255, 0 }, { 0, 255, 255 }, { 255, 0, 255 }, { 255, 165, 0 }, { 128, 0, 128 },
+    { 255, 255, 255 }, { 255, 192, 203 }, { 0, 128, 128 }, { 128, 255, 0 }, { 255, 215, 0 }, { 135, 206, 235 }, { 148, 0, 211 }, { 255, 127, 80 } },
+  // Rainbow
+  { { 255, 0, 0 }, { 255, 96, 0 }, { 255, 191, 0 }, { 223, 255, 0 }, { 128, 255, 0 }, { 32, 255, 0 }, { 0, 255, 64 }, { 0, 255, 159 },
+    { 0, 255, 255 }, { 0, 159, 255 }, { 0, 64, 255 }, { 32, 0, 255 }, { 128, 0, 255 }, { 223, 0, 255 }, { 255, 0, 191 }, { 255, 0, 96 } },
+  // Heat
+  { { 0, 0, 0 }, { 48, 0, 0 }, { 100, 0, 0 }, { 152, 0, 0 }, { 200, 0, 0 }, { 252, 0, 0 }, { 255, 48, 0 }, { 255, 100, 0 },
+    { 255, 148, 0 }, { 255, 200, 0 }, { 255, 252, 0 }, { 255, 255, 48 }, { 255, 255, 96 }, { 255, 255, 148 }, { 255, 255, 200 }, { 255, 255, 252 } },
+  // Ocean
+  { { 0, 0, 64 }, { 0, 13, 83 }, { 0, 26, 102 }, { 0, 38, 122 }, { 0, 51, 141 }, { 0, 64, 160 }, { 0, 83, 168 }, { 0, 102, 176 },
+    { 0, 122, 184 }, { 0, 141, 192 }, { 0, 160, 200 }, { 40, 183, 218 }, { 80, 207, 237 }, { 120, 230, 255 }, { 60, 131, 176 }, { 0, 32, 96 } },
+  // Forest
+  { { 0, 48, 0 }, { 7, 66, 7 }, { 14, 84, 14 }, { 20, 103, 20 }, { 27, 121, 27 }, { 34, 139, 34 }, { 52, 140, 34 }, { 70, 140, 34 },
+    { 89, 141, 35 }, { 107, 142, 35 }, { 123, 163, 40 }, { 138, 184, 45 }, { 154, 205, 50 }, { 103, 158, 39 }, { 51, 111, 27 }, { 0, 64, 16 } },
+  // Lava
+  { { 0, 0, 0 }, { 32, 0, 0 }, { 64, 0, 0 }, { 96, 0, 0 }, { 128, 0, 0 }, { 160, 8, 0 }, { 192, 16, 0 }, { 223, 24, 0 },
+    { 255, 32, 0 }, { 255, 68, 0 }, { 255, 104, 0 }, { 255, 140, 0 }, { 255, 180, 32 }, { 255, 220, 64 }, { 160, 110, 32 }, { 64, 0, 0 } },
+  // Party
+  { { 85, 0, 171 }, { 114, 0, 142 }, { 142, 0, 114 }, { 171, 0, 85 }, { 199, 0, 57 }, { 227, 0, 28 }, { 255, 0, 0 }, { 255, 53, 0 },
+    { 255, 107, 0 }, { 255, 160, 0 }, { 170, 149, 85 }, { 85, 139, 170 }, { 0, 128, 255 }, { 28, 85, 227 }, { 57, 43, 199 }, { 85, 0, 171 } },
+  // Cyberpunk
+  { { 0, 255, 255 }, { 0, 207, 255 }, { 0, 160, 255 }, { 0, 112, 255 }, { 0, 64, 255 }, { 64, 48, 241 }, { 128, 32, 228 }, { 191, 16, 214 },
+    { 255, 0, 200 }, { 255, 0, 166 }, { 255, 0, 132 }, { 255, 0, 98 }, { 255, 0, 64 }, { 170, 85, 128 }, { 85, 170, 191 }, { 0, 255, 255 } },
+  // Plasma
+  { { 0, 0, 255 }, { 17, 0, 238 }, { 34, 0, 221 }, { 51, 0, 204 }, { 68, 0, 187 }, { 85, 0, 170 }, { 102, 0, 153 }, { 119, 0, 136 },
+    { 136, 0, 119 }, { 153, 0, 102 }, { 170, 0, 85 }, { 187, 0, 68 }, { 204, 0, 51 }, { 221, 0, 34 }, { 238, 0, 17 }, { 255, 0, 0 } },
+  // Aurora
+  { { 0, 16, 16 }, { 0, 64, 32 }, { 0, 112, 48 }, { 0, 160, 64 }, { 0, 192, 89 }, { 0, 223, 115 }, { 0, 255, 140 }, { 0, 217, 160 },
+    { 0, 178, 180 }, { 0, 140, 200 }, { 33, 93, 200 }, { 67, 47, 200 }, { 100, 0, 200 }, { 152, 13, 187 }, { 203, 27, 173 }, { 255, 40, 160 } },
+};
+
+Palette16 currentPalette;
+Palette16 targetPalette;
+static unsigned long lastBlendMillis = 0;
+static int16_t selectedPaletteId = -1;  // Picked at runtime (host or spin), -1 = none
+
+void loadPalette(Palette16 &palette, uint8_t paletteId) {
+  if (paletteId >= NUM_PALETTES) {
+    paletteId = PALETTE_CLASSIC;
+  }
+  memcpy_P(palette.rgb, palettes[paletteId], sizeof(palette.rgb));
+}
+
+static inline uint8_t scaleChannel(uint8_t value, uint8_t brightness) {
+  return (uint16_t(value) * (uint16_t(brightness) + 1)) >> 8;
+}
+
+uint32_t paletteColor(const Palette16 &palette, uint8_t index, uint8_t brightness, bool wrap) {
+  uint8_t stop;
+  uint8_t frac;  // 0-15 position between 'stop' and the next one
+
+  if (wrap) {
+    stop = index >> 4;
+    frac = index & 0x0F;
+  } else {
+    // Spread 0-255 over the 15 gaps in 1/16 steps so index 255 lands on the last stop
+    uint16_t scaled = (uint16_t(index) * ((PALETTE_STOPS - 1) * 16) + 127) / 255;
+    stop = scaled >> 4;
+    frac = scaled & 0x0F;
+  }
+  uint8_t next = (stop + 1) % PALETTE_STOPS;
+
+  const uint8_t* a = palette.rgb[stop];
+  const uint8_t* b = palette.rgb[next];
+  uint8_t rgb[3];
+  for (int c = 0; c < 3; c++) {
+    int16_t delta = int16_t(b[c]) - int16_t(a[c]);
+    rgb[c] = scaleChannel(a[c] + ((delta * frac) >> 4), brightness);
+  }
+  return Adafruit_NeoPixel::Color(rgb[0], rgb[1], rgb[2]);
+}
+
+uint32_t paletteStopColor(const Palette16 &palette, uint8_t stop, uint8_t brightness) {
+  const uint8_t* rgb = palette.rgb[stop % PALETTE_STOPS];
+  return Adafruit_NeoPixel::Color(scaleChannel(rgb[0], brightness),
+                                  scaleChannel(rgb[1], brightness),
+                                  scaleChannel(rgb[2], brightness));
+}
+
+bool blendPaletteTowards(Palette16 &current, const Palette16 &target, uint8_t maxChange) {
+  bool changed = false;
+  for (int i = 0; i < PALETTE_STOPS; i++) {
+    for (int c = 0; c < 3; c++) {
+      int16_t delta = int16_t(target.rgb[i][c]) - int16_t(current.rgb[i][c]);
+      if (delta == 0) {
+        continue;
+      }
+      if (delta > maxChange) {
+        delta = maxChange;
+      } else if (delta < -maxChange) {
+        delta = -maxChange;
+      }
+      current.rgb[i][c] += delta;
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+// Reads the animationN_color setting for an animation (0 = not set)
+static int getAnimationColorSetting(int index) {
+  switch (index + 1) {
+    case 1:  return currentConfig.animation1_color;
+    case 2:  return currentConfig.animation2_color;
+    case 3:  return currentConfig.animation3_color;
+    case 4:  return currentConfig.animation4_color;
+    case 5:  return currentConfig.animation5_color;
+    case 6:  return currentConfig.animation6_color;
+    case 7:  return currentConfig.animation7_color;
+    case 8:  return currentConfig.animation8_color;
+    case 9:  return currentConfig.animation9_color;
+    case 10: return currentConfig.animation10_color;
+    case 11: return currentConfig.animation11_color;
+    case 12: return currentConfig.animation12_color;
+    case 13: return currentConfig.animation13_color;
+    case 14: return currentConfig.animation14_color;
+    case 15: return currentConfig.animation15_color;
+    case 16: return currentConfig.animation16_color;
+    case 17: return currentConfig.animation17_color;
+    case 18: return currentConfig.animation18_color;
+    case 19: return currentConfig.animation19_color;
+    case 20: return currentConfig.animation20_color;
+    case 21: return currentConfig.animation21_color;
+    case 22: return currentConfig.animation22_color;
+    case 23: return currentConfig.animation23_color;
+    case 24: return currentConfig.animation24_color;
+    case 25: return currentConfig.animation25_color;
+    default: return 0;
+  }
+}
+
+void setAnimationPalette(uint8_t defaultPaletteId) {
+  // animationN_color: 0 keeps the animation's default (or the palette picked
+  // at runtime), 1..NUM_PALETTES picks a palette
+  int setting = getAnimationColorSetting(animationIndex);
+  uint8_t paletteId = defaultPaletteId;
+  if (setting > 0 && setting <= NUM_PALETTES) {
+    paletteId = setting - 1;
+  } else if (selectedPaletteId >= 0) {
+    paletteId = selectedPaletteId;
+  }
+
+  // A new animation starts on its palette straight away, no blend
+  loadPalette(targetPalette, paletteId);
+  currentPalette = targetPalette;
+}
+
+void selectPalette(uint8_t paletteId) {
+  if (paletteId < NUM_PALETTES) {
+    selectedPaletteId = paletteId;
+  }
+  loadPalette(targetPalette, paletteId);
+}
+
+void paletteTick() {
+  unsigned long now = millis();
+  if (now - lastBlendMillis < PALETTE_BLEND_INTERVAL_MS) {
+    return;
+  }
+  lastBlendMillis = now;
+  blendPaletteTowards(currentPalette, targetPalette, PALETTE_BLEND_STEP);
+}
@@ -0,0 +1,68 @@
+// Palette.h
+
+#ifndef PALETTE_H
+#define PALETTE_H
+
+#include <Arduino.h>
+#include <Adafruit_NeoPixel.h>
+
+// Every palette is 16 RGB color stops; lookups interpolate between them
+#define PALETTE_STOPS 16
+
+// Built-in palettes (stored in flash, see Palette.cpp)
+enum PaletteId {
+  PALETTE_CLASSIC = 0,   // The original ten fixed colors plus six extras
+  PALETTE_RAINBOW,       // Full hue wheel, replaces Wheel() and ColorHSV()
+  PALETTE_HEAT,          // Black -> red -> yellow -> white, replaces HeatColor()
+  PALETTE_OCEAN,
+  PALETTE_FOREST,
+  PALETTE_LAVA,
+  PALETTE_PARTY,
+  PALETTE_CYBERPUNK,
+  PALETTE_PLASMA,        // Blue -> red, the original plasma colors
+  PALETTE_AURORA,        // Dark teal -> green -> blue -> violet
+  NUM_PALETTES
+};
+
+// Milliseconds between blend steps and the largest per-channel change per step
+#define PALETTE_BLEND_INTERVAL_MS 10
+#define PALETTE_BLEND_STEP 8
+
+// RAM copy of a palette so it can be blended towards another one
+struct Palette16 {
+  uint8_t rgb[PALETTE_STOPS][3];
+};
+
+// Palette every animation draws from, and the one it is blending towards
+extern Palette16 currentPalette;
+extern Palette16 targetPalette;
+
+// Copies a built-in palette out of flash
+void loadPalette(Palette16 &palette, uint8_t paletteId);
+
+// Interpolated lookup. index 0-255 walks the 16 stops; with wrap the last
+// stop blends back into the first (hue wheels), without it 0-255 is spread
+// over the 15 gaps so 255 is exactly the last stop (heat ramps).
+// brightness scales the result (255 = full).
+uint32_t paletteColor(const Palette16 &palette, uint8_t index, uint8_t brightness = 255, bool wrap = true);
+
+// Un-interpolated color of a single stop (stop is taken modulo PALETTE_STOPS)
+uint32_t paletteStopColor(const Palette16 &palette, uint8_t stop, uint8_t brightness = 255);
+
+// Moves 'current' towards 'target' by at most maxChange per channel.
+// Returns true while the two palettes still differ.
+bool blendPaletteTowards(Palette16 &current, const Palette16 &target, uint8_t maxChange);
+
+// Called when an animation starts. Uses the animationN_color config value
+// for the running animation when set, otherwise the palette last picked with
+// selectPalette(), otherwise the animation's own default.
+void setAnimationPalette(uint8_t defaultPaletteId);
+
+// Switches to a palette at runtime; the colors blend over rather than jump.
+// The choice carries over to the animations started after it.
+void selectPalette(uint8_t paletteId);
+
+// Advances any running blend; call once per animation frame
+void paletteTick();
+
+#endif  // PALETTE_H
@@ -0,0 +1,137 @@
+// PitchTracker.cpp
+
+#include "PitchTracker.h"
+
+// 2^(k/12) for k = 0..12, 1.15 fixed point (one octave of semitones)
+static const uint16_t semitoneRatio[13] = {
+  32768, 34716, 36781, 38968, 41285, 43740, 46341,
+  49097, 52016, 55109, 58386, 61858, 65535
+};
+
+void pitchTrackerReset(PitchTracker &tracker) {
+  tracker.voiced = false;
+  tracker.frequency = 0;
+  tracker.pitch = 0;
+  tracker.note = 0;
+  tracker.octave = 0;
+  tracker.clarity = 0;
+}
+
+// Semitones above C0 in 8.8 fixed point for a frequency in Hz, 8.8 fixed point
+static uint16_t pitchFromFrequency(uint32_t frequencyQ8) {
+  // Whole octaves above C0
+  uint32_t reference = PITCH_C0_Q8;
+  uint8_t octave = 0;
+  while (frequencyQ8 >= reference * 2) {
+    reference <<= 1;
+    octave++;
+  }
+  if (frequencyQ8 < reference) {
+    return 0;
+  }
+
+  // Position inside the octave, 1.15, then the semitone below it
+  uint32_t ratio = (uint32_t)(((uint64_t)frequencyQ8 << 15) / reference);
+  uint8_t semitone = 0;
+  while (semitone < 11 && ratio >= semitoneRatio[semitone + 1]) {
+    semitone++;
+  }
+
+  // Straight line between neighbouring semitones (under a cent off)
+  uint32_t fraction = ((ratio - semitoneRatio[semitone]) << 8) /
+                      (semitoneRatio[semitone + 1] - semitoneRatio[semitone]);
+  if (fraction > 255) {
+    fraction = 255;
+  }
+  return ((octave * 12 + semitone) << 8) + fraction;
+}
+
+bool pitchTrackerUpdate(PitchTracker &tracker, const int16_t* pcm) {
+  // Remove DC and average down to 4 kHz. Each output sums 8 inputs (twice
+  // the step), which puts the filter's first null at 2 kHz and keeps upper
+  // harmonics from folding back onto the fundamental. Sums are quartered so
+  // a full-scale difference squared times PITCH_WINDOW still fits in 32 bits.
+  int32_t sum = 0;
+  for (uint16_t i = 0; i < PITCH_FRAME_SAMPLES; i++) {
+    sum += pcm[i];
+  }
+  int32_t mean = sum / PITCH_FRAME_SAMPLES;
+
+  for (uint16_t i = 0; i < PITCH_DECIMATED; i++) {
+    const int16_t* p = &pcm[i * PITCH_DECIMATION];
+    int32_t block = 0;
+    for (uint8_t j = 0; j < PITCH_FILTER_TAPS; j++) {
+      block += p[j] - mean;
+    }
+    tracker.decimated[i] = block >> 2;
+  }
+
+  // Difference function, normalized by its running mean so lag 0 is not
+  // the trivial winner: d'(tau) = d(tau) * tau / sum(d(1..tau))
+  tracker.difference[0] = 0;
+  tracker.normalized[0] = 1 << 12;
+  uint32_t running = 0;
+  for (uint8_t lag = 1; lag <= PITCH_MAX_LAG; lag++) {
+    uint32_t d = 0;
+    for (uint8_t j = 0; j < PITCH_WINDOW; j++) {
+      int32_t delta = tracker.decimated[j] - tracker.decimated[j + lag];
+      d += delta * delta;
+    }
+    running += d;
+    uint32_t normalized = running ? (uint32_t)(((uint64_t)d * lag << 12) / running) : (1 << 12);
+    tracker.difference[lag] = d;
+    tracker.normalized[lag] = normalized > 0xFFFF ? 0xFFFF : normalized;
+  }
+
+  // First dip that reaches under the threshold. Short periods fall between
+  // lags, so each dip is judged by the bottom of a parabola through it.
+  uint8_t best = 0;
+  int32_t depth = 0;
+  for (uint8_t lag = PITCH_MIN_LAG; lag < PITCH_MAX_LAG; lag++) {
+    int32_t before = tracker.normalized[lag - 1];
+    int32_t center = tracker.normalized[lag];
+    int32_t after = tracker.normalized[lag + 1];
+    if (center >= before || center > after) {
+      continue;
+    }
+    int32_t curve = before - 2 * center + after;
+    depth = center - (before - after) * (before - after) / (8 * curve);
+    if (depth < PITCH_YIN_THRESHOLD) {
+      best = lag;
+      break;
+    }
+  }
+
+  if (best == 0) {
+    // Noise or silence: report how periodic the best lag was, keep the last pitch
+    uint16_t lowest = 0xFFFF;
+    for (uint8_t lag = PITCH_MIN_LAG; lag <= PITCH_MAX_LAG; lag++) {
+      if (tracker.normalized[lag] < lowest) {
+        lowest = tracker.normalized[lag];
+      }
+    }
+    tracker.clarity = lowest >= (1 << 12) ? 0 : 255 - (lowest >> 4);
+    tracker.voiced = false;
+    return false;
+  }
+
+  // Parabola through the raw differences around the dip, lag in 8.8 fixed point
+  int64_t before = tracker.difference[best - 1];
+  int64_t center = tracker.difference[best];
+  int64_t after = tracker.difference[best + 1];
+  int64_t curve = before - 2 * center + after;
+  int32_t lagQ8 = best << 8;
+  if (curve > 0) {
+    lagQ8 += (int32_t)(((before - after) << 7) / curve);
+  }
+
+  uint32_t frequencyQ8 = ((uint32_t)(PITCH_SAMPLE_RATE / PITCH_DECIMATION) << 16) / lagQ8;
+  tracker.frequency = (frequencyQ8 + 128) >> 8;
+  tracker.pitch = pitchFromFrequency(frequencyQ8);
+  uint16_t nearest = (tracker.pitch + 128) >> 8;
+  tracker.note = nearest % 12;
+  tracker.octave = nearest / 12;
+  tracker.clarity = depth <= 0 ? 255 : 255 - (depth >> 4);
+  tracker.voiced = true;
+  return true;
+}
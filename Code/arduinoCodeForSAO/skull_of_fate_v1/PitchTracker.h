@@ -0,0 +1,48 @@
+// PitchTracker.h
+
+#ifndef PITCHTRACKER_H
+#define PITCHTRACKER_H
+
+#include <stdint.h>
+
+// Dominant pitch by the YIN method. Each frame of PCM is low-passed and
+// decimated to 4 kHz, then the cumulative-mean-normalized difference
+// function is taken over lags PITCH_MIN_LAG..PITCH_MAX_LAG (63 Hz - 1.3 kHz)
+// and the first dip below PITCH_YIN_THRESHOLD picks the period, refined
+// between samples with a parabola. One frame is PITCH_WINDOW * PITCH_MAX_LAG
+// multiply-adds, about the work of one 256-point FFT. Integer only, no
+// Arduino dependencies.
+
+#define PITCH_SAMPLE_RATE 16000
+#define PITCH_DECIMATION 4                                        // 16 kHz -> 4 kHz
+#define PITCH_FRAME_SAMPLES 512                                   // PCM samples per estimate (32 ms)
+#define PITCH_FILTER_TAPS (2 * PITCH_DECIMATION)                  // Moving sum ahead of the decimation
+#define PITCH_DECIMATED ((PITCH_FRAME_SAMPLES - PITCH_FILTER_TAPS) / PITCH_DECIMATION + 1)  // 127 samples
+#define PITCH_WINDOW 64                                           // Decimated samples compared at each lag
+#define PITCH_MIN_LAG 3                                           // 1.33 kHz
+#define PITCH_MAX_LAG (PITCH_DECIMATED - PITCH_WINDOW)            // 63 = 63.5 Hz
+#define PITCH_YIN_THRESHOLD 614                                   // 0.15 in 4.12 fixed point
+#define PITCH_C0_Q8 4186                                          // C0 = 16.35 Hz, 8.8 fixed point
+
+struct PitchTracker {
+  int16_t decimated[PITCH_DECIMATED];
+  uint32_t difference[PITCH_MAX_LAG + 1];  // Squared difference per lag
+  uint16_t normalized[PITCH_MAX_LAG + 1];  // Same, over its running mean, 4.12 fixed point
+
+  // Outputs, from the last frame
+  bool voiced;          // A clear period was found; frequency to octave keep their last value otherwise
+  uint16_t frequency;   // Hz
+  uint16_t pitch;       // Semitones above C0, 8.8 fixed point (A4 = 57 << 8)
+  uint8_t note;         // Pitch class, 0 = C ... 11 = B
+  uint8_t octave;       // Scientific octave number (A4 -> 4)
+  uint8_t clarity;      // 0-255: how periodic the frame is
+};
+
+// Clears all outputs
+void pitchTrackerReset(PitchTracker &tracker);
+
+// Estimates the pitch of PITCH_FRAME_SAMPLES PCM samples at PITCH_SAMPLE_RATE.
+// Returns true if the frame is voiced.
+bool pitchTrackerUpdate(PitchTracker &tracker, const int16_t* pcm);
+
+#endif  // PITCHTRACKER_H
@@ -0,0 +1,51 @@
+// PixelLayout.cpp
+
+#include "PixelLayout.h"
+
+// Generated from the leftGrid / rightGrid maps and the board drawing:
+// pixels sit on a 1.6 mm pitch and the eye centers are 13.6 mm apart.
+//  x,    y,   eye, distance,     angle,        neighbours
+const PixelLayout pixelLayout[LAYOUT_NUM_PIXELS] = {
+  {  -84,  -32, 0, {  36, 155 }, { 173, 136 }, { 1, 4, 5, 3, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 0
+  {  -68,  -32, 0, {  32, 140 }, { 192, 137 }, { 2, 5, 0, 6, 4, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 1
+  {  -52,  -32, 0, {  36, 124 }, { 211, 139 }, { 6, 1, 7, 5, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 2
+  { -100,  -16, 0, {  36, 169 }, { 147, 132 }, { 4, 8, 0, 9, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 3
+  {  -84,  -16, 0, {  23, 153 }, { 160, 132 }, { 0, 5, 9, 3, 1, 10, 8, NO_NEIGHBOUR } },  // 4
+  {  -68,  -16, 0, {  16, 137 }, { 192, 133 }, { 1, 6, 10, 4, 2, 11, 9, 0 } },  // 5
+  {  -52,  -16, 0, {  23, 121 }, { 224, 133 }, { 2, 7, 11, 5, 12, 10, 1, NO_NEIGHBOUR } },  // 6
+  {  -36,  -16, 0, {  36, 105 }, { 237, 134 }, { 12, 6, 11, 2, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 7
+  { -100,    0, 0, {  32, 168 }, { 128, 128 }, { 3, 9, 13, 4, 14, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 8
+  {  -84,    0, 0, {  16, 152 }, { 128, 128 }, { 4, 10, 14, 8, 5, 15, 13, 3 } },  // 9
+  {  -68,    0, 0, {   0, 136 }, {   0, 128 }, { 5, 11, 15, 9, 6, 16, 14, 4 } },  // 10
+  {  -52,    0, 0, {  16, 120 }, {   0, 128 }, { 6, 12, 16, 10, 7, 17, 15, 5 } },  // 11
+  {  -36,    0, 0, {  32, 104 }, {   0, 128 }, { 7, 17, 11, 16, 6, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 12
+  { -100,   16, 0, {  36, 169 }, { 109, 124 }, { 8, 14, 9, 18, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 13
+  {  -84,   16, 0, {  23, 153 }, {  96, 124 }, { 9, 15, 18, 13, 10, 19, 8, NO_NEIGHBOUR } },  // 14
+  {  -68,   16, 0, {  16, 137 }, {  64, 123 }, { 10, 16, 19, 14, 11, 20, 18, 9 } },  // 15
+  {  -52,   16, 0, {  23, 121 }, {  32, 123 }, { 11, 17, 20, 15, 12, 19, 10, NO_NEIGHBOUR } },  // 16
+  {  -36,   16, 0, {  36, 105 }, {  19, 122 }, { 12, 16, 20, 11, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 17
+  {  -84,   32, 0, {  36, 155 }, {  83, 120 }, { 14, 19, 15, 13, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 18
+  {  -68,   32, 0, {  32, 140 }, {  64, 119 }, { 15, 20, 18, 16, 14, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 19
+  {  -52,   32, 0, {  36, 124 }, {  45, 117 }, { 16, 19, 17, 15, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 20
+  {   52,  -32, 1, { 124,  36 }, { 245, 173 }, { 22, 25, 26, 24, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 21
+  {   68,  -32, 1, { 140,  32 }, { 247, 192 }, { 23, 26, 21, 27, 25, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 22
+  {   84,  -32, 1, { 155,  36 }, { 248, 211 }, { 27, 22, 28, 26, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 23
+  {   36,  -16, 1, { 105,  36 }, { 250, 147 }, { 25, 29, 21, 30, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 24
+  {   52,  -16, 1, { 121,  23 }, { 251, 160 }, { 21, 26, 30, 24, 22, 31, 29, NO_NEIGHBOUR } },  // 25
+  {   68,  -16, 1, { 137,  16 }, { 251, 192 }, { 22, 27, 31, 25, 23, 32, 30, 21 } },  // 26
+  {   84,  -16, 1, { 153,  23 }, { 252, 224 }, { 23, 28, 32, 26, 33, 31, 22, NO_NEIGHBOUR } },  // 27
+  {  100,  -16, 1, { 169,  36 }, { 252, 237 }, { 33, 27, 32, 23, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 28
+  {   36,    0, 1, { 104,  32 }, {   0, 128 }, { 24, 30, 34, 25, 35, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 29
+  {   52,    0, 1, { 120,  16 }, {   0, 128 }, { 25, 31, 35, 29, 26, 36, 34, 24 } },  // 30
+  {   68,    0, 1, { 136,   0 }, {   0,   0 }, { 26, 32, 36, 30, 27, 37, 35, 25 } },  // 31
+  {   84,    0, 1, { 152,  16 }, {   0,   0 }, { 27, 33, 37, 31, 28, 38, 36, 26 } },  // 32
+  {  100,    0, 1, { 168,  32 }, {   0,   0 }, { 28, 38, 32, 37, 27, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 33
+  {   36,   16, 1, { 105,  36 }, {   6, 109 }, { 29, 35, 30, 39, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 34
+  {   52,   16, 1, { 121,  23 }, {   5,  96 }, { 30, 36, 39, 34, 31, 40, 29, NO_NEIGHBOUR } },  // 35
+  {   68,   16, 1, { 137,  16 }, {   5,  64 }, { 31, 37, 40, 35, 32, 41, 39, 30 } },  // 36
+  {   84,   16, 1, { 153,  23 }, {   4,  32 }, { 32, 38, 41, 36, 33, 40, 31, NO_NEIGHBOUR } },  // 37
+  {  100,   16, 1, { 169,  36 }, {   4,  19 }, { 33, 37, 41, 32, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 38
+  {   52,   32, 1, { 124,  36 }, {  11,  83 }, { 35, 40, 36, 34, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 39
+  {   68,   32, 1, { 140,  32 }, {   9,  64 }, { 36, 41, 39, 37, 35, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 40
+  {   84,   32, 1, { 155,  36 }, {   8,  45 }, { 37, 40, 38, 36, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR, NO_NEIGHBOUR } },  // 41
+};
@@ -0,0 +1,48 @@
+// PixelLayout.h
+
+#ifndef PIXELLAYOUT_H
+#define PIXELLAYOUT_H
+
+#include <Arduino.h>
+
+// Physical position of every NeoPixel on the board.
+// Units are 0.1 mm ("PCB units"), origin half way between the two eye
+// centers, +x to the right and +y down (same direction as the grid rows).
+#define LAYOUT_NUM_PIXELS 42
+#define LAYOUT_PIXEL_PITCH 16      // Spacing between neighbouring pixels
+#define LAYOUT_EYE_OFFSET_X 68     // Each eye center sits this far left/right of the origin
+
+#define LAYOUT_LEFT_EYE 0
+#define LAYOUT_RIGHT_EYE 1
+
+// Up to 8 neighbours (4 sides, then 4 diagonals); unused slots hold NO_NEIGHBOUR
+#define MAX_NEIGHBOURS 8
+#define NO_NEIGHBOUR 0xFF
+
+struct PixelLayout {
+  int16_t x;                          // PCB units
+  int16_t y;                          // PCB units
+  uint8_t eye;                        // LAYOUT_LEFT_EYE or LAYOUT_RIGHT_EYE
+  uint8_t distance[2];                // Distance from the left / right eye center (PCB units)
+  uint8_t angle[2];                   // Angle around the left / right eye center, 0-255 = one turn, 0 = +x, 64 = down
+  uint8_t neighbours[MAX_NEIGHBOURS]; // Adjacent pixels on the same eye
+};
+
+extern const PixelLayout pixelLayout[LAYOUT_NUM_PIXELS];
+
+// Distance / angle of a pixel from the center of the eye it belongs to
+inline uint8_t pixelDistance(int i) { return pixelLayout[i].distance[pixelLayout[i].eye]; }
+inline uint8_t pixelAngle(int i) { return pixelLayout[i].angle[pixelLayout[i].eye]; }
+
+// Same angle, but turning the other way on the right eye so both eyes mirror each other
+inline uint8_t pixelMirroredAngle(int i) {
+  uint8_t a = pixelAngle(i);
+  return pixelLayout[i].eye == LAYOUT_RIGHT_EYE ? (uint8_t)(128 - a) : a;
+}
+
+// 0 -> 255 -> 0 triangle over one 0-255 phase
+inline uint8_t triangleWave8(uint8_t phase) {
+  return (phase < 128) ? (phase << 1) : ((255 - phase) << 1);
+}
+
+#endif  // PIXELLAYOUT_H
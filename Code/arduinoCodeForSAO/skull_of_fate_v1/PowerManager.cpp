@@ -0,0 +1,99 @@
+// PowerManager.cpp
+
+#include "PowerManager.h"
+#include <Adafruit_SleepyDog.h>
+
+static unsigned long sleepTimeout = 0;
+static volatile unsigned long lastActivity = 0;
+static volatile PowerWakeSource wakeSource = POWER_WAKE_NONE;
+static volatile bool sleeping = false;
+
+void powerSetSleepTimeout(unsigned long timeoutMs) {
+  sleepTimeout = timeoutMs;
+  lastActivity = millis();
+}
+
+void powerNoteActivity() {
+  lastActivity = millis();
+  powerNoteHostWake();
+}
+
+void powerNoteHostWake() {
+  if (sleeping && wakeSource == POWER_WAKE_NONE) {
+    wakeSource = POWER_WAKE_I2C;  // Only the host bus calls this while asleep
+  }
+}
+
+bool powerSleepDue(unsigned long motionIdleMs) {
+  if (sleepTimeout == 0 || motionIdleMs < sleepTimeout) {
+    return false;
+  }
+  if (millis() - lastActivity < sleepTimeout) {
+    return false;
+  }
+  return !USBDevice.configured();
+}
+
+static void onWakeMotion() {
+  if (wakeSource == POWER_WAKE_NONE) {
+    wakeSource = POWER_WAKE_MOTION;
+  }
+}
+
+static void onWakeButton() {
+  if (wakeSource == POWER_WAKE_NONE) {
+    wakeSource = POWER_WAKE_BUTTON;
+  }
+}
+
+// The EIC normally runs from GCLK0, which stops in standby. Pin edges are
+// only seen while it has a clock, so give it the 32 kHz ultra low power
+// oscillator for the duration of the sleep.
+static void clockEicForStandby() {
+  GCLK->GENCTRL.reg = GCLK_GENCTRL_ID(POWER_WAKE_GCLK) | GCLK_GENCTRL_SRC_OSCULP32K |
+                      GCLK_GENCTRL_GENEN | GCLK_GENCTRL_RUNSTDBY;
+  while (GCLK->STATUS.bit.SYNCBUSY);
+  GCLK->CLKCTRL.reg = GCLK_CLKCTRL_ID_EIC | GCLK_CLKCTRL_GEN(POWER_WAKE_GCLK) | GCLK_CLKCTRL_CLKEN;
+  while (GCLK->STATUS.bit.SYNCBUSY);
+}
+
+static void clockEicFromMain() {
+  GCLK->CLKCTRL.reg = GCLK_CLKCTRL_ID_EIC | GCLK_CLKCTRL_GEN_GCLK0 | GCLK_CLKCTRL_CLKEN;
+  while (GCLK->STATUS.bit.SYNCBUSY);
+}
+
+// The host bus client may only change RUNSTDBY while disabled; with it set an
+// address match wakes the chip and holds SCL until the receive handler runs
+static void setI2cRunInStandby(bool enabled) {
+  SERCOM1->I2CS.CTRLA.bit.ENABLE = 0;
+  while (SERCOM1->I2CS.SYNCBUSY.bit.ENABLE);
+  SERCOM1->I2CS.CTRLA.bit.RUNSTDBY = enabled ? 1 : 0;
+  SERCOM1->I2CS.CTRLA.bit.ENABLE = 1;
+  while (SERCOM1->I2CS.SYNCBUSY.bit.ENABLE);
+}
+
+PowerWakeSource powerStandby(uint8_t motionPin, uint8_t leftButtonPin, uint8_t rightButtonPin) {
+  wakeSource = POWER_WAKE_NONE;
+  sleeping = true;
+
+  clockEicForStandby();
+  setI2cRunInStandby(true);
+  attachInterrupt(digitalPinToInterrupt(motionPin), onWakeMotion, RISING);
+  attachInterrupt(digitalPinToInterrupt(leftButtonPin), onWakeButton, FALLING);
+  attachInterrupt(digitalPinToInterrupt(rightButtonPin), onWakeButton, FALLING);
+
+  while (wakeSource == POWER_WAKE_NONE) {
+    Watchdog.sleep(POWER_WATCHDOG_SLEEP_MS);  // Standby; any interrupt returns here
+  }
+  Watchdog.disable();
+
+  detachInterrupt(digitalPinToInterrupt(leftButtonPin));
+  detachInterrupt(digitalPinToInterrupt(rightButtonPin));
+  detachInterrupt(digitalPinToInterrupt(motionPin));
+  setI2cRunInStandby(false);
+  clockEicFromMain();
+
+  sleeping = false;
+  lastActivity = millis();
+  return wakeSource;
+}
@@ -0,0 +1,49 @@
+// PowerManager.h
+
+#ifndef POWERMANAGER_H
+#define POWERMANAGER_H
+
+#include <Arduino.h>
+
+// Auto-sleep. Anything that counts as use (a button, an I2C command, sound
+// above the AGC threshold) calls powerNoteActivity(); motion is tracked by
+// the accelerometer capture. Once neither has happened for the sleep timeout
+// the sketch blanks the LEDs, parks the microphone and accelerometer and
+// calls powerStandby(), which puts the SAMD21 into standby until a wake
+// source fires:
+//   motion  - LIS3DH INT1 (the capture switches it to a wake-up interrupt)
+//   button  - either button pin, through the EIC
+//   I2C     - an address match on the host bus (SERCOM1 runs in standby)
+// The watchdog wakes the chip every POWER_WATCHDOG_SLEEP_MS on the way; that
+// alone goes straight back to sleep.
+
+#define POWER_WAKE_GCLK 6                // Clock generator the EIC runs from in standby
+#define POWER_WATCHDOG_SLEEP_MS 8000     // Longest standby between watchdog wakes
+
+enum PowerWakeSource : uint8_t {
+  POWER_WAKE_NONE = 0,
+  POWER_WAKE_MOTION,
+  POWER_WAKE_BUTTON,
+  POWER_WAKE_I2C
+};
+
+// Idle time before sleeping, from Config.sleep_timeout (0 = never sleep)
+void powerSetSleepTimeout(unsigned long timeoutMs);
+
+// Resets the idle timer; safe to call from interrupts (I2C receive)
+void powerNoteActivity();
+
+// Wakes a sleeping card without counting as use, for host traffic that
+// only reads (a poller must not keep the card awake); safe in interrupts
+void powerNoteHostWake();
+
+// True once the sleep timeout has passed with no activity and no motion
+// for at least that long. Never while USB is connected to a computer, so
+// the serial monitor keeps working.
+bool powerSleepDue(unsigned long motionIdleMs);
+
+// Standby until motion, a button or the host wakes the chip. Leaves the
+// watchdog disabled; the caller enables it again.
+PowerWakeSource powerStandby(uint8_t motionPin, uint8_t leftButtonPin, uint8_t rightButtonPin);
+
+#endif  // POWERMANAGER_H
@@ -0,0 +1,110 @@
+// SoundGestures.cpp
+
+#include "SoundGestures.h"
+
+// Ends the current sequence and reports it if it matched a gesture
+static SoundGesture finishSequence(SoundGestureDetector &detector) {
+  SoundGesture gesture = SOUND_GESTURE_NONE;
+  if (!detector.quietLeadIn) {
+    // Came straight out of other transients (a beat), not a gesture
+  } else if (detector.kind == TRANSIENT_CLAP && detector.count == GESTURE_DOUBLE_CLAP_COUNT) {
+    gesture = SOUND_GESTURE_DOUBLE_CLAP;
+  } else if (detector.kind == TRANSIENT_KNOCK && detector.count == GESTURE_KNOCK_COUNT) {
+    gesture = SOUND_GESTURE_KNOCK;
+  }
+  detector.count = 0;
+  detector.kind = TRANSIENT_NONE;
+  return gesture;
+}
+
+SoundGesture soundGestureBlock(SoundGestureDetector &detector, uint16_t loudness, uint8_t crossings) {
+  if (!detector.started) {
+    detector.started = true;
+    detector.background = loudness;
+  }
+
+  if (!detector.inTransient) {
+    if (detector.ringing) {
+      // Wait for the tail of the last transient to die down before re-arming
+      if (loudness < detector.background + GESTURE_TRANSIENT_RISE / 2) {
+        detector.ringing = false;
+      }
+    } else if (loudness > detector.background + GESTURE_TRANSIENT_RISE) {
+      // Sudden jump: start timing a transient
+      detector.inTransient = true;
+      detector.peak = loudness;
+      detector.blocks = 1;
+      detector.crossings = crossings;
+      return SOUND_GESTURE_NONE;
+    } else {
+      // A block above the quiet level is the leading edge of a transient if
+      // one starts on the next block, otherwise something sounded that was
+      // not sharp enough to count
+      if (detector.rising) {
+        detector.gapNoisy = true;
+      }
+      detector.rising = loudness > detector.background + GESTURE_QUIET_RISE;
+      detector.background += ((int32_t)loudness - detector.background) >> GESTURE_BACKGROUND_SHIFT;
+    }
+    if (detector.gapBlocks < 0xFFFF) {
+      detector.gapBlocks++;
+    }
+    if (detector.count > 0 && detector.gapBlocks > GESTURE_GAP_MAX_BLOCKS) {
+      return finishSequence(detector);
+    }
+    return SOUND_GESTURE_NONE;
+  }
+
+  // Inside a transient
+  detector.blocks++;
+  if (loudness > detector.peak) {
+    detector.peak = loudness;
+  }
+  if (detector.blocks <= GESTURE_ATTACK_BLOCKS) {
+    detector.crossings += crossings;
+  }
+
+  if (detector.blocks > GESTURE_TRANSIENT_MAX_BLOCKS) {
+    // Sustained sound: not a gesture, forget the sequence
+    detector.inTransient = false;
+    detector.count = 0;
+    detector.kind = TRANSIENT_NONE;
+    detector.gapBlocks = 0;
+    detector.gapNoisy = false;
+    detector.rising = false;
+    detector.background = loudness;
+    return SOUND_GESTURE_NONE;
+  }
+
+  if (loudness + GESTURE_TRANSIENT_DECAY > detector.peak) {
+    return SOUND_GESTURE_NONE;  // Still ringing
+  }
+
+  // Transient over: classify it by its attack and add it to the sequence
+  detector.inTransient = false;
+  detector.ringing = true;
+  uint8_t attackBlocks = detector.blocks < GESTURE_ATTACK_BLOCKS ? detector.blocks : GESTURE_ATTACK_BLOCKS;
+  TransientKind kind = (detector.crossings / attackBlocks >= GESTURE_CLAP_CROSSINGS) ? TRANSIENT_CLAP : TRANSIENT_KNOCK;
+
+  uint16_t gap = detector.gapBlocks;
+  bool evenGap = gap >= GESTURE_GAP_MIN_BLOCKS && gap <= GESTURE_GAP_MAX_BLOCKS;
+  if (evenGap && detector.count > 1) {
+    // Every later gap has to match the first one
+    uint16_t difference = gap > detector.firstGap ? gap - detector.firstGap : detector.firstGap - gap;
+    evenGap = difference <= (detector.firstGap >> GESTURE_GAP_TOLERANCE_SHIFT);
+  }
+  if (detector.count > 0 && kind == detector.kind && evenGap && detector.count < 0xFF) {
+    if (detector.count == 1) {
+      detector.firstGap = gap;
+    }
+    detector.count++;
+  } else {
+    detector.count = 1;
+    detector.kind = kind;
+    detector.quietLeadIn = gap >= GESTURE_LEAD_IN_BLOCKS && !detector.gapNoisy;
+  }
+  detector.gapBlocks = 0;
+  detector.gapNoisy = false;
+  detector.rising = false;
+  return SOUND_GESTURE_NONE;
+}
@@ -0,0 +1,65 @@
+// SoundGestures.h
+
+#ifndef SOUNDGESTURES_H
+#define SOUNDGESTURES_H
+
+#include <stdint.h>
+
+// Acoustic gestures from the level meter, one capture block (4 ms) at a time.
+// A transient is a block that jumps well above the background level and
+// dies away again within 100 ms; sustained sound never qualifies. Claps are
+// broadband (many zero crossings per block), knocks are low thuds (few).
+// A run of transients is a gesture (two claps or three knocks) when it
+// starts out of at least GESTURE_LEAD_IN_BLOCKS of quiet, every gap is
+// within a quarter of the first one, and silence follows. A beat keeps
+// sounding through that lead-in (even beats too weak to count as a
+// transient), so music does not qualify.
+
+#define GESTURE_TRANSIENT_RISE 640    // Jump above background to start a transient (2.5 log2, 15 dB)
+#define GESTURE_TRANSIENT_DECAY 384   // Drop below its peak that ends it (1.5 log2, 9 dB)
+#define GESTURE_TRANSIENT_MAX_BLOCKS 25   // Longer than 100 ms is not a transient
+#define GESTURE_ATTACK_BLOCKS 3       // Blocks of the attack used to classify it
+#define GESTURE_CLAP_CROSSINGS 12     // Mean zero crossings per block for a clap (~1.5 kHz)
+#define GESTURE_GAP_MIN_BLOCKS 30     // 120 ms between transients
+#define GESTURE_GAP_MAX_BLOCKS 150    // 600 ms; longer ends the sequence
+#define GESTURE_GAP_TOLERANCE_SHIFT 2 // Later gaps within 1/4 of the first
+#define GESTURE_LEAD_IN_BLOCKS 150    // 600 ms of quiet before the first transient
+#define GESTURE_QUIET_RISE 320        // Quiet: no block this far above the background (1.25 log2)
+#define GESTURE_BACKGROUND_SHIFT 4    // Background follows quiet blocks over ~64 ms
+#define GESTURE_DOUBLE_CLAP_COUNT 2
+#define GESTURE_KNOCK_COUNT 3
+
+enum SoundGesture {
+  SOUND_GESTURE_NONE = 0,
+  SOUND_GESTURE_DOUBLE_CLAP,
+  SOUND_GESTURE_KNOCK
+};
+
+enum TransientKind {
+  TRANSIENT_NONE = 0,
+  TRANSIENT_CLAP,
+  TRANSIENT_KNOCK
+};
+
+struct SoundGestureDetector {
+  uint16_t background;   // Slow loudness of the non-transient blocks (8.8 log2)
+  bool started;          // background holds a level (0 is a real level in a quiet room)
+  bool inTransient;
+  bool ringing;          // Transient over but its tail is still above the background
+  uint16_t peak;         // Loudest block of the current transient
+  uint8_t blocks;        // Blocks into the current transient
+  uint16_t crossings;    // Zero crossings over its attack
+  uint16_t gapBlocks;    // Blocks since the last transient ended
+  bool gapNoisy;         // A block in that gap rose GESTURE_QUIET_RISE above the background
+  bool rising;           // The last block did; it counts unless a transient starts next
+  uint16_t firstGap;     // Gap between the first two transients of the sequence
+  uint8_t count;         // Transients in the current sequence
+  TransientKind kind;    // and what they were
+  bool quietLeadIn;      // The sequence started after GESTURE_LEAD_IN_BLOCKS of quiet
+};
+
+// Feeds one block's loudness (LevelMeter::loudness) and zero crossings.
+// Returns a gesture when a sequence completes.
+SoundGesture soundGestureBlock(SoundGestureDetector &detector, uint16_t loudness, uint8_t crossings);
+
+#endif  // SOUNDGESTURES_H
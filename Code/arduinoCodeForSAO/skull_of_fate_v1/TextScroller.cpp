@@ -0,0 +1,193 @@
+// TextScroller.cpp
+
+#include "TextScroller.h"
+#include "UtilityFunctions.h"
+#include <Adafruit_SleepyDog.h>
+
+// ---------------------------
+// Font
+// ---------------------------
+
+// 3x5 font stored column by column, bit 0 is the top row.
+// Covers ' ' through 'Z'; lowercase letters are drawn as uppercase.
+static const uint8_t font3x5[(FONT_LAST_CHAR - FONT_FIRST_CHAR + 1) * FONT_WIDTH] PROGMEM = {
+  0x00, 0x00, 0x00,  // ' '
+  0x00, 0x17, 0x00,  // '!'
+  0x03, 0x00, 0x03,  // '"'
+  0x1F, 0x0A, 0x1F,  // '#'
+  0x12, 0x1F, 0x09,  // '$'
+  0x19, 0x04, 0x13,  // '%'
+  0x0A, 0x15, 0x1A,  // '&'
+  0x00, 0x03, 0x00,  // '''
+  0x00, 0x0E, 0x11,  // '('
+  0x11, 0x0E, 0x00,  // ')'
+  0x0A, 0x04, 0x0A,  // '*'
+  0x04, 0x0E, 0x04,  // '+'
+  0x10, 0x08, 0x00,  // ','
+  0x04, 0x04, 0x04,  // '-'
+  0x00, 0x10, 0x00,  // '.'
+  0x18, 0x04, 0x03,  // '/'
+  0x1F, 0x11, 0x1F,  // '0'
+  0x12, 0x1F, 0x10,  // '1'
+  0x1D, 0x15, 0x17,  // '2'
+  0x11, 0x15, 0x1F,  // '3'
+  0x07, 0x04, 0x1F,  // '4'
+  0x17, 0x15, 0x1D,  // '5'
+  0x1F, 0x15, 0x1D,  // '6'
+  0x01, 0x1D, 0x03,  // '7'
+  0x1F, 0x15, 0x1F,  // '8'
+  0x17, 0x15, 0x1F,  // '9'
+  0x00, 0x0A, 0x00,  // ':'
+  0x10, 0x0A, 0x00,  // ';'
+  0x04, 0x0A, 0x11,  // '<'
+  0x0A, 0x0A, 0x0A,  // '='
+  0x11, 0x0A, 0x04,  // '>'
+  0x01, 0x15, 0x07,  // '?'
+  0x1F, 0x15, 0x17,  // '@'
+  0x1E, 0x05, 0x1E,  // 'A'
+  0x1F, 0x15, 0x0A,  // 'B'
+  0x0E, 0x11, 0x11,  // 'C'
+  0x1F, 0x11, 0x0E,  // 'D'
+  0x1F, 0x15, 0x11,  // 'E'
+  0x1F, 0x05, 0x01,  // 'F'
+  0x0E, 0x11, 0x1D,  // 'G'
+  0x1F, 0x04, 0x1F,  // 'H'
+  0x11, 0x1F, 0x11,  // 'I'
+  0x08, 0x10, 0x0F,  // 'J'
+  0x1F, 0x04, 0x1B,  // 'K'
+  0x1F, 0x10, 0x10,  // 'L'
+  0x1F, 0x06, 0x1F,  // 'M'
+  0x1F, 0x01, 0x1E,  // 'N'
+  0x0E, 0x11, 0x0E,  // 'O'
+  0x1F, 0x05, 0x02,  // 'P'
+  0x0E, 0x19, 0x16,  // 'Q'
+  0x1F, 0x05, 0x1A,  // 'R'
+  0x12, 0x15, 0x09,  // 'S'
+  0x01, 0x1F, 0x01,  // 'T'
+  0x1F, 0x10, 0x1F,  // 'U'
+  0x0F, 0x10, 0x0F,  // 'V'
+  0x1F, 0x0C, 0x1F,  // 'W'
+  0x1B, 0x04, 0x1B,  // 'X'
+  0x03, 0x1C, 0x03,  // 'Y'
+  0x19, 0x15, 0x13,  // 'Z'
+};
+
+// ---------------------------
+// Scroller State
+// ---------------------------
+
+static char scrollText[MAX_SCROLL_TEXT_LENGTH + 1];
+static uint32_t glyphColors[MAX_SCROLL_TEXT_LENGTH];
+static uint8_t scrollTextLength = 0;
+
+// Colors currently on the canvas, one per cell
+static uint32_t canvas[CANVAS_HEIGHT][CANVAS_WIDTH];
+
+// Position of the next column to feed in
+static uint8_t nextGlyph = 0;        // Index into scrollText
+static uint8_t nextGlyphColumn = 0;  // 0..FONT_WIDTH+FONT_SPACING-1
+static uint8_t trailingColumns = 0;  // Blank columns fed after the last glyph
+
+// Returns the column bitmap of 'c' at column 'column' (0..FONT_WIDTH-1)
+static uint8_t glyphColumn(char c, uint8_t column) {
+  if (c >= 'a' && c <= 'z') {
+    c = c - 'a' + 'A';
+  }
+  if (c < FONT_FIRST_CHAR || c > FONT_LAST_CHAR) {
+    c = '?';
+  }
+  return pgm_read_byte(&font3x5[(c - FONT_FIRST_CHAR) * FONT_WIDTH + column]);
+}
+
+void scrollerSetText(const char* text, uint32_t color) {
+  scrollTextLength = 0;
+  while (text[scrollTextLength] != '\0' && scrollTextLength < MAX_SCROLL_TEXT_LENGTH) {
+    scrollText[scrollTextLength] = text[scrollTextLength];
+    glyphColors[scrollTextLength] = color;
+    scrollTextLength++;
+  }
+  scrollText[scrollTextLength] = '\0';
+
+  for (int row = 0; row < CANVAS_HEIGHT; row++) {
+    for (int col = 0; col < CANVAS_WIDTH; col++) {
+      canvas[row][col] = 0;
+    }
+  }
+
+  nextGlyph = 0;
+  nextGlyphColumn = 0;
+  trailingColumns = 0;
+}
+
+void scrollerSetGlyphColor(uint8_t glyphIndex, uint32_t color) {
+  if (glyphIndex < scrollTextLength) {
+    glyphColors[glyphIndex] = color;
+  }
+}
+
+void scrollerSetGlyphColors(const uint32_t* colors, uint8_t numColors) {
+  if (numColors == 0) return;
+  for (uint8_t i = 0; i < scrollTextLength; i++) {
+    glyphColors[i] = colors[i % numColors];
+  }
+}
+
+bool scrollerIsFinished() {
+  return nextGlyph >= scrollTextLength && trailingColumns >= CANVAS_WIDTH;
+}
+
+bool scrollerStep(Adafruit_NeoPixel &pixels) {
+  if (scrollerIsFinished()) {
+    return false;
+  }
+
+  // Work out the bitmap and color of the incoming column
+  uint8_t bits = 0;
+  uint32_t color = 0;
+  if (nextGlyph < scrollTextLength) {
+    if (nextGlyphColumn < FONT_WIDTH) {
+      bits = glyphColumn(scrollText[nextGlyph], nextGlyphColumn);
+      color = glyphColors[nextGlyph];
+    }
+    nextGlyphColumn++;
+    if (nextGlyphColumn >= FONT_WIDTH + FONT_SPACING) {
+      nextGlyphColumn = 0;
+      nextGlyph++;
+    }
+  } else {
+    trailingColumns++;
+  }
+
+  // Shift every row one column left and append the new column on the right
+  for (int row = 0; row < CANVAS_HEIGHT; row++) {
+    for (int col = 0; col < CANVAS_WIDTH - 1; col++) {
+      canvas[row][col] = canvas[row][col + 1];
+    }
+    canvas[row][CANVAS_WIDTH - 1] = (bits & (1 << row)) ? color : 0;
+  }
+
+  // Push the canvas to the pixels that exist on the board
+  for (int row = 0; row < CANVAS_HEIGHT; row++) {
+    for (int col = 0; col < CANVAS_WIDTH; col++) {
+      int pixelIndex = canvasPixelIndex(row, col);
+      if (pixelIndex != -1) {
+        pixels.setPixelColor(pixelIndex, canvas[row][col]);
+      }
+    }
+  }
+  pixels.show();
+
+  return true;
+}
+
+void scrollerRunBlocking(Adafruit_NeoPixel &pixels, unsigned long stepMs) {
+  while (scrollerStep(pixels)) {
+    Watchdog.reset();
+    delay(stepMs);
+  }
+}
+
+void scrollTextBlocking(Adafruit_NeoPixel &pixels, const char* text, uint32_t color, unsigned long stepMs) {
+  scrollerSetText(text, color);
+  scrollerRunBlocking(pixels, stepMs);
+}
@@ -0,0 +1,47 @@
+// TextScroller.h
+
+#ifndef TEXTSCROLLER_H
+#define TEXTSCROLLER_H
+
+#include <Arduino.h>
+#include <Adafruit_NeoPixel.h>
+
+// Joined eye canvas (left eye columns 0-4, right eye columns 5-9)
+#define CANVAS_WIDTH 10
+#define CANVAS_HEIGHT 5
+
+// Font configuration (3x5 glyphs, one blank column between glyphs)
+#define FONT_WIDTH 3
+#define FONT_SPACING 1
+#define FONT_FIRST_CHAR ' '
+#define FONT_LAST_CHAR 'Z'
+
+// Longest message the scroller will hold (longer text is truncated)
+#define MAX_SCROLL_TEXT_LENGTH 64
+
+// Default time between column shifts in milliseconds
+#define SCROLL_STEP_MS 80
+
+// Loads a new message and clears the canvas; every glyph gets 'color'
+void scrollerSetText(const char* text, uint32_t color);
+
+// Overrides the color of a single glyph of the current message
+void scrollerSetGlyphColor(uint8_t glyphIndex, uint32_t color);
+
+// Cycles the given colors across the glyphs of the current message
+void scrollerSetGlyphColors(const uint32_t* colors, uint8_t numColors);
+
+// Shifts the canvas one column left, appends the next text column and shows it.
+// Returns false once the whole message has scrolled off the canvas.
+bool scrollerStep(Adafruit_NeoPixel &pixels);
+
+// True when the current message has scrolled off the canvas
+bool scrollerIsFinished();
+
+// Scrolls the current message to completion (blocking, keeps the watchdog fed)
+void scrollerRunBlocking(Adafruit_NeoPixel &pixels, unsigned long stepMs = SCROLL_STEP_MS);
+
+// Convenience wrapper: load 'text' in a single color and scroll it once
+void scrollTextBlocking(Adafruit_NeoPixel &pixels, const char* text, uint32_t color, unsigned long stepMs = SCROLL_STEP_MS);
+
+#endif  // TEXTSCROLLER_H
@@ -29,11 +29,33 @@ unsigned long rightLongPressStart = 0;
 
 static DoubleTapCallback doubleTapCallback = NULL;
 
+// Last tap seen, CLICK_SRC bits, for getAccelerometerTap()
+static uint8_t lastTapSource = 0;
+
 // Function to set the double tap callback
 void setDoubleTapCallback(DoubleTapCallback callback) {
   doubleTapCallback = callback;
 }
 
+// Tap events from the accelerometer's click interrupt; double taps go to
+// the registered callback (with a cooldown so one knock is not two taps)
+static void onMotionTap(const MotionTap &tap) {
+  lastTapSource = tap.source;
+
+  Serial.print(tap.type == MOTION_TAP_DOUBLE ? "Double tap" : "Single tap");
+  Serial.print(" on ");
+  Serial.print(tap.negative ? '-' : '+');
+  Serial.println(tap.axis);
+
+  if (tap.type == MOTION_TAP_DOUBLE && doubleTapCallback != NULL) {
+    unsigned long now = millis();
+    if (now - lastDoubleTapTime_global >= DOUBLE_TAP_COOLDOWN_GLOBAL) {
+      lastDoubleTapTime_global = now;
+      doubleTapCallback();
+    }
+  }
+}
+
 /**
  * @brief Updates an integer configuration parameter.
  * 
@@ -190,16 +212,7 @@ const unsigned long FADE_STEP_DELAY_MS = 20;        // Delay between fade steps
 const unsigned long RESET_DELAY_MS = 2000;          // Delay before resetting after conditions met
 const uint32_t DEAD_CELL_COLOR = 0x000000;          // Black/off for dead cells
 
-// Live Cell Colors (Cycle through these on each restart)
-const uint32_t colorList[] = {
-  0x00FF00,  // Green
-  0xFF0000,  // Red
-  0x0000FF,  // Blue
-  0xFFFF00,  // Yellow
-  0xFF00FF,  // Magenta
-  0x00FFFF   // Cyan
-};
-const int numColors2 = sizeof(colorList) / sizeof(colorList[0]);
+// Live cell color cycles through the palette stops on each restart
 int currentColorIndex = 0;
 uint32_t LIVE_CELL_COLOR;
 
@@ -372,10 +385,22 @@ struct Droplet {
 };
 
 
+// ---------------------------
+// Ripple / Radar Settings
+// ---------------------------
+const int RIPPLE_WIDTH = 24;        // Ring thickness in PCB units
+const int RIPPLE_MAX_RADIUS = 200;  // Past the far edge of the other eye
+const uint8_t RADAR_TRAIL = 96;     // Trail length behind the sweep (0-255 = one turn)
+
+// ---------------------------
+// Noise Animation Settings
+// ---------------------------
+const unsigned long NOISE_FRAME_MS = 20;  // 50 FPS for lava, fog and aurora
+
 // ---------------------------
 // Color Selection Variables
 // ---------------------------
-int colorMode = 0;  // 0 = Random, 1-10 = colorArray[0-9]
+int colorMode = 0;  // 0 = Random, 1-16 = palette stops 0-15
 // ---------------------------
 // Function Prototypes
 // ---------------------------
@@ -383,7 +408,6 @@ void createDroplet(Droplet droplets[], int &dropletCount, const int grid[5][5]);
 void updateDroplets(Droplet droplets[], int &dropletCount, const int grid[5][5]);
 void displayDroplets(Droplet droplets[], int dropletCount, const int grid[5][5]);
 uint32_t getColor();
-uint32_t ColorHSV(long hue, uint8_t sat, uint8_t val);
 
 
 ////////////////////////////////////////////////
@@ -395,39 +419,21 @@ extern void (*currentAnimation)(Adafruit_NeoPixel &);
 extern void (*previousAnimation)(Adafruit_NeoPixel &);
 extern Adafruit_LIS3DH lis;
 
-// Define the array of colors globally
-const int numColors = 10;  // Number of colors in the array
-
-const uint8_t colorArray[numColors][3] = {
-  { 255, 0, 0 },      // Red
-  { 0, 255, 0 },      // Green
-  { 0, 0, 255 },      // Blue
-  { 255, 255, 0 },    // Yellow
-  { 0, 255, 255 },    // Cyan
-  { 255, 0, 255 },    // Magenta
-  { 255, 165, 0 },    // Orange
-  { 128, 0, 128 },    // Purple
-  { 255, 255, 255 },  // White
-  { 255, 192, 203 }   // Pink
-};
+// Colors the right button cycles through (one per stop of the current palette)
+const int numColors = PALETTE_STOPS;
 
 Adafruit_ZeroPDM pdm(PIN_PDM_CLK, PIN_PDM_DATA);
 
-const uint16_t sincfilter[DECIMATION] = {
-  0, 2, 9, 21, 39, 63, 94, 132,
-  179, 236, 302, 379, 467, 565, 674, 792,
-  920, 1055, 1196, 1341, 1487, 1633, 1776, 1913,
-  2042, 2159, 2263, 2352, 2422, 2474, 2506, 2516,
-  2506, 2474, 2422, 2352, 2263, 2159, 2042, 1913,
-  1776, 1633, 1487, 1341, 1196, 1055, 920, 792,
-  674, 565, 467, 379, 302, 236, 179, 132,
-  94, 63, 39, 21, 9, 2, 0
-};
-
 // GLOBAL VARIABLES
 int16_t pcm_buffer[FFT_SIZE];
-float spectrum[SPECTRUM_SIZE];
-float max_all = 10.0;  // For dynamic scaling
+SpectrumAnalyzer<FFT_SIZE> analyzer;  // Hann windowed fixed-point FFT
+uint32_t audioFrameCursor = 0;        // Capture position of the next overlapped frame
+uint16_t spectrum[SPECTRUM_SIZE];          // 0-15 per bin, 8.8 fixed point
+int32_t spectrumMax = SPECTRUM_AGC_START;  // For dynamic scaling
+BandEnergies bandEnergies;                 // Per-column bands plus bass/mid/treble
+int16_t pitch_buffer[PITCH_FRAME_SAMPLES];
+PitchTracker pitchTracker;                 // Dominant pitch, updated by processPitch()
+uint32_t pitchFrameCursor = 0;             // Capture position of the next pitch frame
 
 // Define the grid mappings
 // Left grid pixel indices (5x5 grid)
@@ -448,27 +454,44 @@ const int rightGrid[5][5] = {
   { -1, 39, 40, 41, -1 }
 };
 
+// Map a cell of the joined 10x5 canvas (left eye columns 0-4, right eye 5-9)
+// to its pixel index, or -1 where there is no LED
+int canvasPixelIndex(int row, int col) {
+  if (row < 0 || row >= 5 || col < 0 || col >= 10) {
+    return -1;
+  }
+  if (col < 5) {
+    return leftGrid[row][col];
+  }
+  return rightGrid[row][col - 5];
+}
+
 // Brightness scaling variable
 float brightnessFactor = 0.0;  // Start at 0%
 
-// Volume threshold to determine when LEDs should light up
-const float VOLUME_THRESHOLD = 3.0;  // Adjust based on testing
+// Microphone calibration: seconds of quiet, then seconds of loud sound
+const unsigned long MIC_CALIBRATION_PHASE_MS = 3000;
+
+// Accelerometer calibration: how long each pose is held, how long to wait for
+// it, and how long both buttons are held to start it
+const unsigned long ACCEL_CALIBRATION_HOLD_MS = 2000;
+const unsigned long ACCEL_CALIBRATION_TIMEOUT_MS = 30000;
+const unsigned long ACCEL_CALIBRATION_CHORD_MS = 3000;
+
+// Longest wait for the next audio frame (two hops at FFT_SIZE 256) before
+// handing the loop back, e.g. while the microphone is stopped
+const unsigned long AUDIO_FRAME_WAIT_MS = 20;
 
 // Variables for rainbow animation
 uint16_t globalHue = 0;  // Global hue offset for rainbow cycling
 
-// Tempo (BPM) related variables
-unsigned long lastBeatTime = 0;  // Timestamp of the last detected beat
-float currentBPM = 120.0;        // Initial BPM estimate
-const float MIN_BPM = 60.0;
-const float MAX_BPM = 180.0;
-
-// Hue increment range based on BPM
+// Hue increment range based on BPM (tempo comes from the shared beat clock)
 const uint16_t MIN_HUE_INCREMENT = 128;   // Slower cycle
 const uint16_t MAX_HUE_INCREMENT = 1024;  // Faster cycle
 
-// Smoothing factor for BPM updates
-const float BPM_SMOOTHING = 0.8;
+// Onset detection and tempo estimation; a tempo needs BEAT_MIN_CONFIDENCE
+// before it drives the shared beat clock
+BeatTracker beatTracker;
 
 
 // Define thresholds for press duration (in milliseconds)
@@ -489,8 +512,6 @@ void handleLongPress(int animationIndex) {
 
 
 // Function declarations (prototypes) for functions used before their definitions
-uint32_t HeatColor(uint8_t temperature, Adafruit_NeoPixel &pixels);
-uint32_t Wheel(byte WheelPos, Adafruit_NeoPixel &pixels);
 
 // Function definitions
 
@@ -557,8 +578,19 @@ void initializeAccelerometer(Adafruit_LIS3DH &lis) {
     while (1) yield();
   }
   lis.setRange(LIS3DH_RANGE_2_G);  // Set range to 2G
-  lis.setDataRate(LIS3DH_DATARATE_50_HZ);
-  lis.setClick(2, 80);  // Enable double-tap detection
+
+  // Sample at 100, 200 or 400 Hz (accel_rate); the capture decimates to MOTION_SAMPLE_RATE
+  uint16_t rate = motionCaptureSetDataRate(currentConfig.accel_rate);
+  uint8_t ticks = rate / MOTION_SAMPLE_RATE;
+  // Enable double-tap detection with the same timing at any rate. The
+  // 0.6 s double-tap window is the longest that fits in 8 bits at 400 Hz.
+  lis.setClick(2, 80, 10 * ticks, 20 * ticks, 60 * ticks);
+
+  // Batch samples in the LIS3DH FIFO and drain them in bursts; taps arrive as events
+  motionCaptureSetTapCallback(onMotionTap);
+  if (!motionCaptureBegin()) {
+    Serial.println("Accelerometer FIFO unavailable.");
+  }
 }
 
 void initializeMicrophone() {
@@ -575,6 +607,13 @@ void initializeMicrophone() {
     while (1)
       ;
   }
+
+  // Stream the microphone into the capture ring buffer in the background
+  if (!audioCaptureBegin()) {
+    Serial.println("Failed to start microphone capture!");
+    while (1)
+      ;
+  }
 }
 
 // Magnetic sensor function
@@ -584,11 +623,14 @@ bool isMagneticFieldDetected() {
 
 
 // Accelerometer functions
+// Newest calibrated sample from the FIFO ring in g; only touches the bus when a batch is waiting
 void getAccelerometerValues(Adafruit_LIS3DH &lis, float &x, float &y, float &z) {
-  lis.read();  // Read accelerometer data
-  x = lis.x_g;
-  y = lis.y_g;
-  z = lis.z_g;
+  motionCaptureService();
+  MotionSample sample = { 0, 0, 0 };
+  motionCaptureLatest(sample);
+  x = (float)sample.x / MOTION_COUNTS_PER_G;
+  y = (float)sample.y / MOTION_COUNTS_PER_G;
+  z = (float)sample.z / MOTION_COUNTS_PER_G;
 }
 
 
@@ -600,8 +642,12 @@ void getAccelerometerValues(Adafruit_LIS3DH &lis, float &x, float &y, float &z)
   z = lis.z;
 }
 */
+// Last tap since the previous call (CLICK_SRC bits as lis.getClick()), 0 if none
 uint8_t getAccelerometerTap(Adafruit_LIS3DH &lis) {
-  return lis.getClick();
+  motionCaptureService();
+  uint8_t tap = lastTapSource;
+  lastTapSource = 0;
+  return tap;
 }
 
 // LED control functions
@@ -683,7 +729,59 @@ void setAllNeoPixelsColor(Adafruit_NeoPixel &pixels, uint32_t color) {
 
 // Button functions
 bool isLeftButtonPressed() {
-  return digitalRead(LEFT_BUTTON_PIN) == LOW;
+  bool pressed = digitalRead(LEFT_BUTTON_PIN) == LOW;
+  if (pressed) {
+    powerNoteActivity();
+  }
+  return pressed;
+}
+
+// Loop condition of every animation, checked once per frame. Services the
+// accelerometer (FIFO batches and tap events) and queued I2C commands on the
+// way, then keeps the animation going until the left button is pressed,
+// something interrupts it or it is time to sleep.
+bool animationRunning() {
+  motionCaptureService();
+  hostLinkService();
+  return !isLeftButtonPressed() && !animationInterrupted && !sleepDue();
+}
+
+// Keeps the beat clock following the music in the beat-locked animations
+// that do no audio work of their own (circuit, vortex, marquee): analyzes
+// the next overlapped frame if it has been captured, without waiting.
+// Everything else leaves the FFT alone.
+void beatTrackerService() {
+  if (audioCaptureFrame(pcm_buffer, FFT_SIZE, analyzer.HOP, audioFrameCursor)) {
+    processFFT();
+  }
+}
+
+// Sound above the AGC threshold counts as use, so music keeps the card awake
+bool sleepDue() {
+  if (audioCaptureVolume() > audioCaptureThreshold()) {
+    powerNoteActivity();
+  }
+  return powerSleepDue(motionCaptureIdleMs());
+}
+
+// Blanks everything, parks the microphone and accelerometer and stands the
+// MCU by until it is moved, a button is pressed or the host addresses it.
+// The caller's animation carries on afterwards.
+void sleepUntilWoken(Adafruit_NeoPixel &pixels) {
+  Serial.println("Nothing happening, going to sleep.");
+  setAllNeoPixelsColor(pixels, 0);
+  turnOffAllLEDs();
+  audioCaptureStop();
+  motionCaptureSleep();
+
+  PowerWakeSource source = powerStandby(MOTION_INT_PIN, LEFT_BUTTON_PIN, RIGHT_BUTTON_PIN);
+
+  Watchdog.enable(currentConfig.watchdogmaxtimeout);
+  motionCaptureWake();
+  audioCaptureResume();
+
+  Serial.print("Woken by ");
+  Serial.println(source == POWER_WAKE_MOTION ? "motion" : source == POWER_WAKE_BUTTON ? "a button" : "the host");
 }
 
 bool isSpecialModeActive() {
@@ -696,6 +794,9 @@ bool isSpecialModeActive() {
 
 bool isRightButtonPressed() {
   bool currentState = (digitalRead(RIGHT_BUTTON_PIN) == LOW);
+  if (currentState) {
+    powerNoteActivity();
+  }
   
   if (currentState && lastRightState == HIGH) {
     // Button was just pressed
@@ -722,28 +823,10 @@ void waitForButtonPress(bool (*buttonFunction)()) {
   delay(50);
 }
 
-// Function to map heat values to colors
-uint32_t HeatColor(uint8_t temperature, Adafruit_NeoPixel &pixels) {
-  uint8_t t192 = (temperature * 191) / 255;  // Scale 'heat' down from 0-255 to 0-191
-
-  uint8_t heatramp = t192 & 0x3F;  // 0..63
-  heatramp <<= 2;                  // Scale up to 0..252
-
-  if (t192 > 128) {
-    // Hot
-    return pixels.Color(255, 255, heatramp);
-  } else if (t192 > 64) {
-    // Medium
-    return pixels.Color(255, heatramp, 0);
-  } else {
-    // Cool
-    return pixels.Color(heatramp, 0, 0);
-  }
-}
-
 // Flame effect with grid mapping
 void flameEffect(Adafruit_NeoPixel &pixels) {
   Serial.println("Flame Effect. Press LEFT button to exit.");
+  setAnimationPalette(PALETTE_HEAT);
 
   // Flame effect parameters
   const uint8_t cooling = 50;    // Less cooling to allow higher flames
@@ -763,8 +846,9 @@ void flameEffect(Adafruit_NeoPixel &pixels) {
 
   bool rightButtonLastState = HIGH;  // Assume button not pressed (pull-up resistor)
 
-  while (!isLeftButtonPressed() && !animationInterrupted) {
+  while (animationRunning()) {
     Watchdog.reset();
+    paletteTick();
     unsigned long currentMillis = millis();
 
     // Check for both buttons pressed
@@ -878,7 +962,7 @@ void flameEffect(Adafruit_NeoPixel &pixels) {
           int pixelIndex = leftGrid[y][x];
           if (pixelIndex != -1) {
             uint8_t colorIndex = heatGrid[y][x];
-            uint32_t color = HeatColor(colorIndex, pixels);
+            uint32_t color = paletteColor(currentPalette, colorIndex, 255, false);
             pixels.setPixelColor(pixelIndex, color);
           }
         }
@@ -890,7 +974,7 @@ void flameEffect(Adafruit_NeoPixel &pixels) {
           int pixelIndex = rightGrid[y][x];
           if (pixelIndex != -1) {
             uint8_t colorIndex = heatGrid[y][x];
-            uint32_t color = HeatColor(colorIndex, pixels);
+            uint32_t color = paletteColor(currentPalette, colorIndex, 255, false);
             pixels.setPixelColor(pixelIndex, color);
           }
         }
@@ -907,20 +991,6 @@ void flameEffect(Adafruit_NeoPixel &pixels) {
   delay(50);  // Debounce delay
 }
 
-// Wheel function for rainbow colors
-uint32_t Wheel(byte WheelPos, Adafruit_NeoPixel &pixels) {
-  WheelPos = 255 - WheelPos;
-  if (WheelPos < 85) {
-    return pixels.Color(255 - WheelPos * 3, 0, WheelPos * 3);
-  } else if (WheelPos < 170) {
-    WheelPos -= 85;
-    return pixels.Color(0, WheelPos * 3, 255 - WheelPos * 3);
-  } else {
-    WheelPos -= 170;
-    return pixels.Color(WheelPos * 3, 255 - WheelPos * 3, 0);
-  }
-}
-
 /*
 // Rainbow Cycle NeoPixel Demo
 void rainbowCycleNeoPixelDemo(Adafruit_NeoPixel &pixels) {
@@ -930,7 +1000,7 @@ void rainbowCycleNeoPixelDemo(Adafruit_NeoPixel &pixels) {
   unsigned long previousMillis = 0;
   const unsigned long interval = 20;
 
-  while (!isLeftButtonPressed() && !animationInterrupted) {
+  while (animationRunning()) {
     Watchdog.reset();
     unsigned long currentMillis = millis();
 
@@ -943,7 +1013,7 @@ void rainbowCycleNeoPixelDemo(Adafruit_NeoPixel &pixels) {
       previousMillis = currentMillis;
 
       for (int i = 0; i < pixels.numPixels(); i++) {
-        pixels.setPixelColor(i, Wheel((i * 256 / pixels.numPixels() + j) & 255, pixels));
+        pixels.setPixelColor(i, paletteColor(currentPalette, (i * 256 / pixels.numPixels() + j) & 255));
       }
       pixels.show();
       j++;
@@ -959,6 +1029,7 @@ void rainbowCycleNeoPixelDemo(Adafruit_NeoPixel &pixels) {
 // Rainbow Cycle NeoPixel Demo with Short Press, Double Tap, and Long Press Detection
 void rainbowCycleNeoPixelDemo(Adafruit_NeoPixel &pixels) {
   Serial.println("Rainbow Cycle NeoPixel Demo. Press LEFT button to exit.");
+  setAnimationPalette(PALETTE_RAINBOW);
 
   uint16_t j = 0;
   unsigned long previousMillis = 0;
@@ -971,8 +1042,9 @@ void rainbowCycleNeoPixelDemo(Adafruit_NeoPixel &pixels) {
 
   bool rightButtonLastState = HIGH;  // Assume button not pressed (pull-up resistor)
 
-  while (!isLeftButtonPressed() && !animationInterrupted) {
+  while (animationRunning()) {
     Watchdog.reset();
+    paletteTick();
     unsigned long currentMillis = millis();
 
     // Check for both buttons pressed
@@ -1030,7 +1102,7 @@ void rainbowCycleNeoPixelDemo(Adafruit_NeoPixel &pixels) {
       previousMillis = currentMillis;
 
       for (int i = 0; i < pixels.numPixels(); i++) {
-        pixels.setPixelColor(i, Wheel((i * 256 / pixels.numPixels() + j) & 255, pixels));
+        pixels.setPixelColor(i, paletteColor(currentPalette, (i * 256 / pixels.numPixels() + j) & 255));
       }
       pixels.show();
       j++;
@@ -1067,7 +1139,7 @@ void bouncingBallNeoPixelDemo(Adafruit_NeoPixel &pixels) {
   unsigned long pressStartTime = 0;
   bool longPressHandled = false;
 
-  while (!isLeftButtonPressed() && !animationInterrupted) {
+  while (animationRunning()) {
     Watchdog.reset();
     unsigned long currentMillis = millis();
 
@@ -1126,9 +1198,9 @@ void bouncingBallNeoPixelDemo(Adafruit_NeoPixel &pixels) {
       previousMillis = currentMillis;
 
       setAllNeoPixelsColor(pixels, 0);
-      uint8_t red = colorArray[selectedColorIndex][0];
-      uint8_t green = colorArray[selectedColorIndex][1];
-      uint8_t blue = colorArray[selectedColorIndex][2];
+      uint8_t red = currentPalette.rgb[selectedColorIndex][0];
+      uint8_t green = currentPalette.rgb[selectedColorIndex][1];
+      uint8_t blue = currentPalette.rgb[selectedColorIndex][2];
       pixels.setPixelColor(position, pixels.Color(red, green, blue));
       pixels.show();
       position += velocity;
@@ -1155,6 +1227,7 @@ void bouncingBallNeoPixelDemo(Adafruit_NeoPixel &pixels) {
 // Bouncing Ball NeoPixel Demo with Double Tap Detection
 void bouncingBallNeoPixelDemo(Adafruit_NeoPixel &pixels) {
   Serial.println("Bouncing Ball NeoPixel Demo. Press LEFT button to exit.");
+  setAnimationPalette(PALETTE_CLASSIC);
 
   int position = 0;
   int velocity = 1;
@@ -1165,8 +1238,9 @@ void bouncingBallNeoPixelDemo(Adafruit_NeoPixel &pixels) {
   unsigned long previousMillis = 0;
   const unsigned long interval = 20;
 
-  while (!isLeftButtonPressed() && !animationInterrupted) {
+  while (animationRunning()) {
     Watchdog.reset();
+    paletteTick();
     unsigned long currentMillis = millis();
 
     // Check for both buttons pressed
@@ -1188,32 +1262,13 @@ void bouncingBallNeoPixelDemo(Adafruit_NeoPixel &pixels) {
     }
     rightButtonLastState = rightButtonCurrentState;
 
-    // Tap Detection from Accelerometer
-    //uint8_t tap = getAccelerometerTap(lis); // Ensure 'lis' is properly defined and initialized
-
-    uint8_t click = lis.getClick();
-  
-    if (click & 0x30) { // Check if any tap is detected
-      Serial.print("click detected: ");
-      if (click & 0x10) {
-        Serial.print("Single click");
-        // If you want to handle single taps, you can add logic here
-      }
-      if (click & 0x20) {
-        Serial.print("Double click");
-        //saveanimationindex(); // Call your desired function on double tap
-        Serial.println(" - saveanimationindex called.");
-      }
-      Serial.println();
-    }
-
     if (currentMillis - previousMillis >= interval) {
       previousMillis = currentMillis;
 
       setAllNeoPixelsColor(pixels, 0);
-      uint8_t red = colorArray[selectedColorIndex][0];
-      uint8_t green = colorArray[selectedColorIndex][1];
-      uint8_t blue = colorArray[selectedColorIndex][2];
+      uint8_t red = currentPalette.rgb[selectedColorIndex][0];
+      uint8_t green = currentPalette.rgb[selectedColorIndex][1];
+      uint8_t blue = currentPalette.rgb[selectedColorIndex][2];
       pixels.setPixelColor(position, pixels.Color(red, green, blue));
       pixels.show();
       position += velocity;
@@ -1233,6 +1288,7 @@ void bouncingBallNeoPixelDemo(Adafruit_NeoPixel &pixels) {
 // Plasma Effect NeoPixel Demo
 void plasmaEffectNeoPixelDemo(Adafruit_NeoPixel &pixels) {
   Serial.println("Plasma Effect NeoPixel Demo. Press LEFT button to exit.");
+  setAnimationPalette(PALETTE_PLASMA);
 
   int t = 0;
   unsigned long previousMillis = 0;
@@ -1245,8 +1301,9 @@ void plasmaEffectNeoPixelDemo(Adafruit_NeoPixel &pixels) {
 
   bool rightButtonLastState = HIGH;  // Assume button not pressed (pull-up resistor)
 
-  while (!isLeftButtonPressed() && !animationInterrupted) {
+  while (animationRunning()) {
     Watchdog.reset();
+    paletteTick();
     unsigned long currentMillis = millis();
 
     // Check for both buttons pressed
@@ -1304,10 +1361,13 @@ void plasmaEffectNeoPixelDemo(Adafruit_NeoPixel &pixels) {
       previousMillis = currentMillis;
 
       for (int i = 0; i < pixels.numPixels(); i++) {
-        int x = i % 5;
-        int y = i / 5;
-        uint8_t color = (uint8_t)(128.0 + (128.0 * sin(i + t / 7.0)));
-        pixels.setPixelColor(i, pixels.Color(color, 0, 255 - color));
+        // Sum of waves across the board plus rings around each eye center
+        float x = pixelLayout[i].x;
+        float y = pixelLayout[i].y;
+        float value = sin(x * 0.04 + t / 7.0) + sin(y * 0.06 - t / 5.0) +
+                      sin((x + y) * 0.03 + t / 9.0) + sin(pixelDistance(i) * 0.12 - t / 4.0);
+        uint8_t color = (uint8_t)constrain(128.0 + 32.0 * value, 0.0, 255.0);
+        pixels.setPixelColor(i, paletteColor(currentPalette, color, 255, false));
       }
       pixels.show();
       t++;
@@ -1323,6 +1383,7 @@ void plasmaEffectNeoPixelDemo(Adafruit_NeoPixel &pixels) {
 // Cyberpunk Glitch NeoPixel Demo
 void cyberpunkGlitchNeoPixelDemo(Adafruit_NeoPixel &pixels) {
   Serial.println("Cyberpunk Glitch NeoPixel Demo. Press LEFT button to exit.");
+  setAnimationPalette(PALETTE_CLASSIC);
 
   int selectedColorIndex = 0;  // Start with the first color
   // Variables for right button press detection
@@ -1332,8 +1393,9 @@ void cyberpunkGlitchNeoPixelDemo(Adafruit_NeoPixel &pixels) {
 
   bool rightButtonLastState = HIGH;  // Assume button not pressed (pull-up resistor)
 
-  while (!isLeftButtonPressed() && !animationInterrupted) {
+  while (animationRunning()) {
     Watchdog.reset();
+    paletteTick();
     unsigned long currentMillis = millis();
 
     // Check for both buttons pressed
@@ -1388,9 +1450,9 @@ void cyberpunkGlitchNeoPixelDemo(Adafruit_NeoPixel &pixels) {
     rightButtonLastState = rightButtonCurrentState;
 
     int glitchPixel = random(0, pixels.numPixels());
-    uint8_t red = colorArray[selectedColorIndex][0];
-    uint8_t green = colorArray[selectedColorIndex][1];
-    uint8_t blue = colorArray[selectedColorIndex][2];
+    uint8_t red = currentPalette.rgb[selectedColorIndex][0];
+    uint8_t green = currentPalette.rgb[selectedColorIndex][1];
+    uint8_t blue = currentPalette.rgb[selectedColorIndex][2];
     uint32_t glitchColor = pixels.Color(red, green, blue);
     pixels.setPixelColor(glitchPixel, glitchColor);
     pixels.show();
@@ -1406,9 +1468,18 @@ void cyberpunkGlitchNeoPixelDemo(Adafruit_NeoPixel &pixels) {
   delay(50);
 }
 
+// Set on every beat while the circuit animation runs
+uint8_t circuitBeatFlash = 0;
+
+void onCircuitBeat(uint32_t beatNumber) {
+  // Downbeats flash harder than the other beats of the bar
+  circuitBeatFlash = (beatNumber % BEATS_PER_BAR == 0) ? 3 : 2;
+}
+
 // Cyberpunk Circuit NeoPixel Demo
 void cyberpunkCircuitNeoPixelDemo(Adafruit_NeoPixel &pixels) {
   Serial.println("Cyberpunk Circuit NeoPixel Demo. Press LEFT button to exit.");
+  setAnimationPalette(PALETTE_CLASSIC);
 
   int index = 0;
 
@@ -1416,8 +1487,9 @@ void cyberpunkCircuitNeoPixelDemo(Adafruit_NeoPixel &pixels) {
   int selectedColorIndex2 = 1;  // Start with the second color
   //bool rightButtonLastState = HIGH; // Assume button not pressed (pull-up resistor)
 
-  unsigned long previousMillis = 0;
-  const unsigned long interval = 100;
+  uint32_t lastStep = 0;  // Last sixteenth-note step drawn
+  circuitBeatFlash = 0;
+  beatClockAddListener(onCircuitBeat);
   // Variables for right button press detection
 
   bool rightButtonPressed = false;
@@ -1426,8 +1498,9 @@ void cyberpunkCircuitNeoPixelDemo(Adafruit_NeoPixel &pixels) {
 
   bool rightButtonLastState = HIGH;  // Assume button not pressed (pull-up resistor)
 
-  while (!isLeftButtonPressed() && !animationInterrupted) {
+  while (animationRunning()) {
     Watchdog.reset();
+    paletteTick();
     unsigned long currentMillis = millis();
 
     // Check for both buttons pressed
@@ -1485,18 +1558,27 @@ void cyberpunkCircuitNeoPixelDemo(Adafruit_NeoPixel &pixels) {
 
     rightButtonLastState = rightButtonCurrentState;
 
-    if (currentMillis - previousMillis >= interval) {
-      previousMillis = currentMillis;
-
-      uint8_t bgRed = colorArray[selectedColorIndex1][0];
-      uint8_t bgGreen = colorArray[selectedColorIndex1][1];
-      uint8_t bgBlue = colorArray[selectedColorIndex1][2];
-
-      uint8_t lineRed = colorArray[selectedColorIndex2][0];
-      uint8_t lineGreen = colorArray[selectedColorIndex2][1];
-      uint8_t lineBlue = colorArray[selectedColorIndex2][2];
-
-      setAllNeoPixelsColor(pixels, pixels.Color(bgRed / 5, bgGreen / 5, bgBlue / 5));  // Dim background
+    // Move the lines every sixteenth note of the beat clock
+    beatTrackerService();
+    beatClockUpdate(currentMillis);
+    uint32_t step = beatClockBeatCount(currentMillis) * 4 + beatClockBeatPhase(currentMillis) / 64;
+    if (step != lastStep) {
+      lastStep = step;
+
+      uint8_t bgRed = currentPalette.rgb[selectedColorIndex1][0];
+      uint8_t bgGreen = currentPalette.rgb[selectedColorIndex1][1];
+      uint8_t bgBlue = currentPalette.rgb[selectedColorIndex1][2];
+
+      uint8_t lineRed = currentPalette.rgb[selectedColorIndex2][0];
+      uint8_t lineGreen = currentPalette.rgb[selectedColorIndex2][1];
+      uint8_t lineBlue = currentPalette.rgb[selectedColorIndex2][2];
+
+      // Dim background, brighter for a moment on each beat
+      uint8_t bgDivider = 5 - circuitBeatFlash;
+      setAllNeoPixelsColor(pixels, pixels.Color(bgRed / bgDivider, bgGreen / bgDivider, bgBlue / bgDivider));
+      if (circuitBeatFlash > 0) {
+        circuitBeatFlash--;
+      }
 
       for (int i = 0; i < 5; i++) {
         int pixel = (index + i * 10) % pixels.numPixels();
@@ -1508,6 +1590,8 @@ void cyberpunkCircuitNeoPixelDemo(Adafruit_NeoPixel &pixels) {
     delay(1);
   }
 
+  beatClockRemoveListener(onCircuitBeat);
+
   // Turn off all pixels after exiting
   setAllNeoPixelsColor(pixels, 0);
   delay(50);
@@ -1520,6 +1604,7 @@ void accelerometerNeoPixelDemo(Adafruit_NeoPixel &pixels) {
   const uint8_t gridHeight = 5;
 
   Serial.println("Accelerometer NeoPixel Demo. Press LEFT button to exit.");
+  setAnimationPalette(PALETTE_CLASSIC);
 
   int selectedColorIndex = 0;  // Start with the first color
   // Variables for right button press detection
@@ -1529,8 +1614,9 @@ void accelerometerNeoPixelDemo(Adafruit_NeoPixel &pixels) {
 
   bool rightButtonLastState = HIGH;  // Assume button not pressed (pull-up resistor)
 
-  while (!isLeftButtonPressed() && !animationInterrupted) {
+  while (animationRunning()) {
     Watchdog.reset();
+    paletteTick();
     unsigned long currentMillis = millis();
 
     // Check for both buttons pressed
@@ -1584,12 +1670,12 @@ void accelerometerNeoPixelDemo(Adafruit_NeoPixel &pixels) {
 
     rightButtonLastState = rightButtonCurrentState;
 
-    float x, y, z;
-    getAccelerometerValues(lis, x, y, z);
+    // Shared tilt estimate: roll and pitch as binary angles (32 = 45 degrees)
+    const MotionTiltEstimator &tilt = motionCaptureTilt();
 
-    // Map x and y values to grid positions (0 to 4)
-    int gridX = map(x * 100, -100, 100, 0, 4);
-    int gridY = map(y * 100, -100, 100, 0, 4);  // Inverted Y mapping
+    // Map roll and pitch (-45 to 45 degrees) to grid positions (0 to 4)
+    int gridX = map(tilt.roll, -32, 32, 0, 4);
+    int gridY = map(tilt.pitch, -32, 32, 0, 4);  // Inverted Y mapping
 
     // Constrain to grid
     gridX = constrain(gridX, 0, 4);
@@ -1604,15 +1690,15 @@ void accelerometerNeoPixelDemo(Adafruit_NeoPixel &pixels) {
 
     // Set the pixels
     if (leftPixel != -1) {
-      uint8_t red = colorArray[selectedColorIndex][0];
-      uint8_t green = colorArray[selectedColorIndex][1];
-      uint8_t blue = colorArray[selectedColorIndex][2];
+      uint8_t red = currentPalette.rgb[selectedColorIndex][0];
+      uint8_t green = currentPalette.rgb[selectedColorIndex][1];
+      uint8_t blue = currentPalette.rgb[selectedColorIndex][2];
       pixels.setPixelColor(leftPixel, pixels.Color(red, green, blue));
     }
     if (rightPixel != -1) {
-      uint8_t red = colorArray[selectedColorIndex][0];
-      uint8_t green = colorArray[selectedColorIndex][1];
-      uint8_t blue = colorArray[selectedColorIndex][2];
+      uint8_t red = currentPalette.rgb[selectedColorIndex][0];
+      uint8_t green = currentPalette.rgb[selectedColorIndex][1];
+      uint8_t blue = currentPalette.rgb[selectedColorIndex][2];
       pixels.setPixelColor(rightPixel, pixels.Color(red, green, blue));
     }
 
@@ -1657,7 +1743,7 @@ void eyeballNeoPixelDemo(Adafruit_NeoPixel &pixels) {
 
   bool rightButtonLastState = HIGH;  // Assume button not pressed (pull-up resistor)
 
-  while (!isLeftButtonPressed() && !animationInterrupted) {
+  while (animationRunning()) {
     Watchdog.reset();
     unsigned long currentMillis = millis();
 
@@ -1815,6 +1901,7 @@ void drawSingleDot(Adafruit_NeoPixel &pixels, int x, int y) {
 // Color Swirl NeoPixel Demo
 void colorSwirlNeoPixelDemo(Adafruit_NeoPixel &pixels) {
   Serial.println("Color Swirl NeoPixel Demo. Press LEFT button to exit.");
+  setAnimationPalette(PALETTE_RAINBOW);
 
   int hue = 0;
   unsigned long previousMillis = 0;
@@ -1827,8 +1914,9 @@ void colorSwirlNeoPixelDemo(Adafruit_NeoPixel &pixels) {
 
   bool rightButtonLastState = HIGH;  // Assume button not pressed (pull-up resistor)
 
-  while (!isLeftButtonPressed() && !animationInterrupted) {
+  while (animationRunning()) {
     Watchdog.reset();
+    paletteTick();
     unsigned long currentMillis = millis();
 
     // Check for both buttons pressed
@@ -1886,7 +1974,7 @@ void colorSwirlNeoPixelDemo(Adafruit_NeoPixel &pixels) {
       previousMillis = currentMillis;
 
       for (int i = 0; i < pixels.numPixels(); i++) {
-        pixels.setPixelColor(i, pixels.gamma32(pixels.ColorHSV((hue + i * 65536 / pixels.numPixels()) % 65536)));
+        pixels.setPixelColor(i, pixels.gamma32(paletteColor(currentPalette, ((hue + i * 65536 / pixels.numPixels()) % 65536) >> 8)));
       }
       pixels.show();
       hue += 256;  // Adjust for speed
@@ -1965,114 +2053,107 @@ void testNeoPixels(Adafruit_NeoPixel &pixels) {
   Serial.println("NeoPixels turned off.");
 }
 
-// Function to record audio from the PDM microphone
-void recordAudio() {
-  for (int i = 0; i < FFT_SIZE; i++) {
-    uint32_t runningsum = 0;
-    const uint16_t *sinc_ptr = sincfilter;
-
-    // Read DECIMATION bits and perform convolution
-    for (uint8_t samplenum = 0; samplenum < (DECIMATION / 16); samplenum++) {
-      uint16_t sample = pdm.read() & 0xFFFF;  // Read 16 bits
-
-      // Process each bit
-      for (int b = 0; b < 16; b++) {
-        if (sample & 0x1) {
-          runningsum += *sinc_ptr;
-        }
-        sinc_ptr++;
-        sample >>= 1;
-      }
-    }
-
-    // Normalize the running sum
-    runningsum /= DECIMATION;
-
-    // Store the PCM sample
-    pcm_buffer[i] = (int16_t)runningsum - 32768;  // Center around zero
+// Copies the next FFT_SIZE PCM frame from the DMA capture ring; frames overlap
+// by half, so one is normally ready within 8 ms at 256. Returns false if none
+// arrives within AUDIO_FRAME_WAIT_MS, or with checkButton when the left
+// button is pressed.
+static bool recordAudioSamples(bool checkButton) {
+  // Check for left button press
+  if (checkButton && isLeftButtonPressed()) {
+    return false;
   }
-}
 
-bool recordAudioWithButtonCheck() {
-  for (int i = 0; i < FFT_SIZE; i++) {
-    // Check for left button press
-    if (isLeftButtonPressed()) {
-      return false;  // Exit recording early
+  unsigned long waitStart = millis();
+  while (!audioCaptureFrame(pcm_buffer, FFT_SIZE, analyzer.HOP, audioFrameCursor)) {
+    if (checkButton && isLeftButtonPressed()) {
+      return false;
     }
-    uint32_t runningsum = 0;
-    const uint16_t *sinc_ptr = sincfilter;
-
-    // Read DECIMATION bits and perform convolution
-    for (uint8_t samplenum = 0; samplenum < (DECIMATION / 16); samplenum++) {
-      uint16_t sample = pdm.read() & 0xFFFF;  // Read 16 bits
-
-      // Process each bit
-      for (int b = 0; b < 16; b++) {
-        if (sample & 0x1) {
-          runningsum += *sinc_ptr;
-        }
-        sinc_ptr++;
-        sample >>= 1;
-      }
+    if (millis() - waitStart >= AUDIO_FRAME_WAIT_MS) {
+      return false;
     }
-
-    // Normalize the running sum
-    runningsum /= DECIMATION;
-
-    // Store the PCM sample
-    pcm_buffer[i] = (int16_t)runningsum - 32768;  // Center around zero
   }
   return true;
 }
 
+// Function to record audio from the PDM microphone
+void recordAudio() {
+  recordAudioSamples(false);
+}
+
+bool recordAudioWithButtonCheck() {
+  return recordAudioSamples(true);
+}
+
 
 // Function to perform FFT on the recorded audio
 void processFFT() {
-  // Perform FFT on the PCM data
-  ZeroFFT(pcm_buffer, FFT_SIZE);
-
-  // Compute magnitude spectrum (log scale)
-  for (int i = 1; i < SPECTRUM_SIZE - 1; i++) {  // Start from 1 to exclude DC component
-    float real = pcm_buffer[i * 2];
-    float imag = pcm_buffer[i * 2 + 1];
-    float mag = sqrt(real * real + imag * imag);
-    spectrum[i] = log(mag + 1e-7);  // Add a small value to prevent log(0)
+  // Window, transform and take fixed-point magnitudes of the PCM frame
+  analyzer.process(pcm_buffer);
+
+  // Log2 levels scaled 0-15 against the decaying loudest bin (integer only)
+  spectrumLevels(analyzer.magnitude, spectrum, SPECTRUM_SIZE, spectrumMax);
+
+  // Fold the frame into the band energies
+  bandEnergiesUpdate(bandEnergies, spectrum, FFT_SIZE, SAMPLE_RATE);
+
+  // Onsets line up the shared beat clock; a confident tempo sets its speed.
+  // Frames are timed by when their last sample was captured, not when they
+  // get analyzed, so the tempo grid does not pick up the loop's jitter.
+  uint32_t frameAge = audioCaptureSamplesWritten() - (audioFrameCursor - analyzer.HOP);
+  unsigned long now = millis() - frameAge * 1000 / SAMPLE_RATE;
+  if (beatTrackerUpdate(beatTracker, bandEnergies.energy, now)) {
+    beatClockAudioBeat(now);
   }
-
-  // Find min and max values in the spectrum
-  float min_curr = spectrum[1];
-  float max_curr = spectrum[1];
-  for (int i = 1; i < SPECTRUM_SIZE - 1; i++) {
-    if (spectrum[i] < min_curr) min_curr = spectrum[i];
-    if (spectrum[i] > max_curr) max_curr = spectrum[i];
+  if (beatTracker.confidence >= BEAT_MIN_CONFIDENCE) {
+    beatClockAudioTempo(beatTracker.bpm, now);
   }
+}
 
-  // Update max_all for dynamic scaling
-  if (max_curr > max_all) {
-    max_all = max_curr;
-  } else {
-    max_all = max_all * 0.95 + max_curr * 0.05;  // Smoother decay
+// Estimate the dominant pitch of the newest PITCH_FRAME_SAMPLES of audio.
+// Frames step by the FFT hop, so pitch updates at the same rate as the
+// spectrum. Returns false if the left button is pressed while waiting or
+// no frame arrives within AUDIO_FRAME_WAIT_MS.
+bool processPitch() {
+  unsigned long waitStart = millis();
+  while (!audioCaptureFrame(pitch_buffer, PITCH_FRAME_SAMPLES, analyzer.HOP, pitchFrameCursor)) {
+    if (isLeftButtonPressed() || millis() - waitStart >= AUDIO_FRAME_WAIT_MS) {
+      return false;
+    }
   }
+  pitchTrackerUpdate(pitchTracker, pitch_buffer);
+  return true;
+}
+
+// Function to get the overall volume (0-15). The capture interrupt keeps it
+// current from the time-domain level meter and AGC, so no FFT is needed.
+float calculateVolume() {
+  return audioCaptureVolume() / 256.0;
+}
 
-  // Optionally, lower the min_curr threshold to allow for more sensitivity
-  min_curr = 0.0;  // Removed the previous threshold of 3.0
+// Volume below which the music animations treat the room as quiet
+float volumeThreshold() {
+  return audioCaptureThreshold() / 256.0;
+}
 
-  // Normalize and scale the spectrum data
-  for (int i = 1; i < SPECTRUM_SIZE - 1; i++) {
-    spectrum[i] = (spectrum[i] - min_curr) * (15.0 / (max_all - min_curr));
-    if (spectrum[i] < 0) spectrum[i] = 0;
-    if (spectrum[i] > 15.0) spectrum[i] = 15.0;  // Cap at 15
-  }
+// Seed the AGC from a stored calibration (0 = not calibrated)
+void applyMicCalibration(int calibration) {
+  audioCaptureSetCalibration(calibration);
 }
 
-// Function to calculate overall volume from the spectrum
-float calculateVolume() {
-  float volume = 0.0;
-  for (int i = 1; i < SPECTRUM_SIZE - 1; i++) {
-    volume += spectrum[i];
-  }
-  volume /= (SPECTRUM_SIZE - 2);  // Average magnitude
-  return volume;
+// Zero offsets (12-bit counts) subtracted from every accelerometer sample,
+// and the measured counts per g they are scaled by (0 = nominal)
+void applyAccelCalibration(int x, int y, int z, int scale) {
+  motionCaptureSetCalibration(x, y, z, scale);
+}
+
+// Shake / tilt in 12-bit counts, spin in degrees, flip in milliseconds
+void applyMotionGestureThresholds(int shake, int tilt, int spin, int flipMs) {
+  MotionGestureThresholds thresholds;
+  thresholds.shake = constrain(shake, 256, 4095);
+  thresholds.tilt = constrain(tilt, 128, MOTION_COUNTS_PER_G);
+  thresholds.spin = constrain(spin, 90, 1080);
+  thresholds.flipMs = constrain(flipMs, 100, 10000);
+  motionCaptureSetGestureThresholds(thresholds);
 }
 
 // Function to display the solid color animation with brightness scaling
@@ -2104,8 +2185,8 @@ void displayRainbow(Adafruit_NeoPixel &pixels) {
   // Determine hue increment based on current BPM
   // Map BPM to hue increment: slower BPM -> lower increment, faster BPM -> higher increment
   // Assuming BPM ranges from 60 to 180
-  float bpmClamped = constrain(currentBPM, MIN_BPM, MAX_BPM);
-  float bpmRatio = (bpmClamped - MIN_BPM) / (MAX_BPM - MIN_BPM);  // 0.0 to 1.0
+  float bpmClamped = constrain((float)beatClockBpm(), (float)BEAT_MIN_BPM, (float)BEAT_MAX_BPM);
+  float bpmRatio = (bpmClamped - BEAT_MIN_BPM) / (float)(BEAT_MAX_BPM - BEAT_MIN_BPM);  // 0.0 to 1.0
   uint16_t hueIncrement = MIN_HUE_INCREMENT + bpmRatio * (MAX_HUE_INCREMENT - MIN_HUE_INCREMENT);
 
   // Increment the global hue based on the calculated hue increment
@@ -2119,12 +2200,11 @@ void displayRainbow(Adafruit_NeoPixel &pixels) {
     // Calculate hue for this pixel
     uint16_t hue = (globalHue + (i * 65535UL / NUMPIXELS)) % 65536;
 
-    // Define saturation and value based on brightnessFactor
-    uint8_t saturation = 255;
-    uint8_t value = brightnessFactor * 255;  // Scale brightness
+    // Scale brightness with brightnessFactor
+    uint8_t value = brightnessFactor * 255;
 
-    // Convert HSV to RGB
-    uint32_t color = pixels.ColorHSV(hue, saturation, value);
+    // Look the hue up in the palette
+    uint32_t color = paletteColor(currentPalette, hue >> 8, value);
 
     // Set the pixel color
     pixels.setPixelColor(i, color);
@@ -2134,9 +2214,9 @@ void displayRainbow(Adafruit_NeoPixel &pixels) {
   pixels.show();
 }
 
-
 void solidColorMusic(Adafruit_NeoPixel &pixels) {
   Serial.println("Sound Effect NeoPixel Demo. Press LEFT button to exit.");
+  setAnimationPalette(PALETTE_CLASSIC);
 
   int selectedColorIndex = 0;
   int fadeColorIndex = random(numColors);
@@ -2149,8 +2229,9 @@ void solidColorMusic(Adafruit_NeoPixel &pixels) {
   bool longPressHandled = false;
   bool rightButtonLastState = HIGH;
 
-  while (!isLeftButtonPressed() && !animationInterrupted) {
+  while (animationRunning()) {
     Watchdog.reset();
+    paletteTick();
 
     // Check for buttons
     if (isBothButtonsPressed()) {
@@ -2158,11 +2239,12 @@ void solidColorMusic(Adafruit_NeoPixel &pixels) {
     }
 
     // Read audio & process FFT
-    if (!recordAudioWithButtonCheck()) break;
+    if (!recordAudioWithButtonCheck()) continue;  // animationRunning() sees the button
     processFFT();
     float volume = calculateVolume();
+    float threshold = volumeThreshold();
 
-    if (volume < VOLUME_THRESHOLD) {
+    if (volume < threshold) {
       fadeActive = true;
       if (fadingUp) {
         fadeBrightness = min(fadeBrightness + 5, 255);
@@ -2175,16 +2257,16 @@ void solidColorMusic(Adafruit_NeoPixel &pixels) {
         }
       }
 
-      uint8_t red = (colorArray[fadeColorIndex][0] * fadeBrightness) / 255;
-      uint8_t green = (colorArray[fadeColorIndex][1] * fadeBrightness) / 255;
-      uint8_t blue = (colorArray[fadeColorIndex][2] * fadeBrightness) / 255;
+      uint8_t red = (currentPalette.rgb[fadeColorIndex][0] * fadeBrightness) / 255;
+      uint8_t green = (currentPalette.rgb[fadeColorIndex][1] * fadeBrightness) / 255;
+      uint8_t blue = (currentPalette.rgb[fadeColorIndex][2] * fadeBrightness) / 255;
       setAllNeoPixelsColor(pixels, pixels.Color(red, green, blue));
     } else {
       fadeActive = false;
-      float brightnessFactor = constrain((volume - VOLUME_THRESHOLD) / (15.0 - VOLUME_THRESHOLD), 0.0, 1.0);
-      uint8_t red = colorArray[selectedColorIndex][0] * brightnessFactor;
-      uint8_t green = colorArray[selectedColorIndex][1] * brightnessFactor;
-      uint8_t blue = colorArray[selectedColorIndex][2] * brightnessFactor;
+      float brightnessFactor = constrain((volume - threshold) / (15.0 - threshold), 0.0, 1.0);
+      uint8_t red = currentPalette.rgb[selectedColorIndex][0] * brightnessFactor;
+      uint8_t green = currentPalette.rgb[selectedColorIndex][1] * brightnessFactor;
+      uint8_t blue = currentPalette.rgb[selectedColorIndex][2] * brightnessFactor;
       displaySolidColor(pixels, pixels.Color(red, green, blue));
     }
     delay(20);
@@ -2197,14 +2279,16 @@ void solidColorMusic(Adafruit_NeoPixel &pixels) {
 
 void rainbowBeatMusic(Adafruit_NeoPixel &pixels) {
   Serial.println("Rainbow Beat NeoPixel Demo. Press LEFT button to exit.");
+  setAnimationPalette(PALETTE_RAINBOW);
 
   int fadeColorIndex = random(numColors);
   bool fadingUp = true;
   uint8_t fadeBrightness = 0;
   bool fadeActive = true;
 
-  while (!isLeftButtonPressed() && !animationInterrupted) {
+  while (animationRunning()) {
     Watchdog.reset();
+    paletteTick();
 
     // Check for button presses
     if (isBothButtonsPressed()) {
@@ -2212,11 +2296,12 @@ void rainbowBeatMusic(Adafruit_NeoPixel &pixels) {
     }
 
     // Read audio & process FFT
-    if (!recordAudioWithButtonCheck()) break;
+    if (!recordAudioWithButtonCheck()) continue;  // animationRunning() sees the button
     processFFT();
     float volume = calculateVolume();
+    float threshold = volumeThreshold();
 
-    if (volume < VOLUME_THRESHOLD) {
+    if (volume < threshold) {
       fadeActive = true;
       if (fadingUp) {
         fadeBrightness = min(fadeBrightness + 5, 255);
@@ -2229,25 +2314,13 @@ void rainbowBeatMusic(Adafruit_NeoPixel &pixels) {
         }
       }
 
-      uint8_t red = (colorArray[fadeColorIndex][0] * fadeBrightness) / 255;
-      uint8_t green = (colorArray[fadeColorIndex][1] * fadeBrightness) / 255;
-      uint8_t blue = (colorArray[fadeColorIndex][2] * fadeBrightness) / 255;
+      uint8_t red = (currentPalette.rgb[fadeColorIndex][0] * fadeBrightness) / 255;
+      uint8_t green = (currentPalette.rgb[fadeColorIndex][1] * fadeBrightness) / 255;
+      uint8_t blue = (currentPalette.rgb[fadeColorIndex][2] * fadeBrightness) / 255;
       setAllNeoPixelsColor(pixels, pixels.Color(red, green, blue));
     } else {
       fadeActive = false;
-      float brightnessFactor = constrain((volume - VOLUME_THRESHOLD) / (15.0 - VOLUME_THRESHOLD), 0.0, 1.0);
-
-      if (volume > VOLUME_THRESHOLD * 1.5) {
-        unsigned long currentTime = millis();
-        if (lastBeatTime != 0) {
-          unsigned long timeSinceLastBeat = currentTime - lastBeatTime;
-          float bpm = 60000.0 / timeSinceLastBeat;
-          if (bpm >= MIN_BPM && bpm <= MAX_BPM) {
-            currentBPM = BPM_SMOOTHING * currentBPM + (1.0 - BPM_SMOOTHING) * bpm;
-          }
-        }
-        lastBeatTime = millis();
-      }
+      float brightnessFactor = constrain((volume - threshold) / (15.0 - threshold), 0.0, 1.0);
 
       displayRainbow(pixels);
     }
@@ -2260,123 +2333,9 @@ void rainbowBeatMusic(Adafruit_NeoPixel &pixels) {
 }
 
 
-void handleBothButtonsPressed() {
-  static bool bothButtonsLock = false;
-  static bool specialMode = false;
-  
-  // Handle both buttons being pressed
-  if (!bothButtonsLock && isBothButtonsPressed()) {
-    bothButtonsLock = true;
-    
-    // Store the current animation
-    previousAnimation = currentAnimation;
-    currentAnimation = NULL;
-    
-    // Use the appropriate range based on special mode
-    bool useFullRange = specialMode;
-    
-    if (useFullRange) {
-      Serial.println("BOTH BUTTONS PRESSED IN SPECIAL MODE!");
-      Serial.println("Using full card range (1-78)");
-    } else {
-      Serial.println("BOTH BUTTONS PRESSED!");
-      Serial.println("Using limited card range (1-38)");
-    }
-    
-    // Reset special mode after use
-    specialMode = false;
-    
-    // Visual feedback
-    turnOnAllLEDs();
-    setAllNeoPixelsColor(pixels, pixels.Color(255, 255, 255));
-    pixels.show();
-    
-    // NFC operations
-    nfcWriter.wipeEEPROM();
-    nfcWriter.writeCCFile();
-    nfcWriter.writeRandomURI(useFullRange);
-    
-    Serial.println("NFC tag written.");
-    
-    // Wait for feedback
-    delay(2000);
-    
-    // Clean up
-    turnOffAllLEDs();
-    setAllNeoPixelsColor(pixels, 0);
-    pixels.show();
-    
-    // Resume animation
-    currentAnimation = previousAnimation;
-  } 
-  else if (bothButtonsLock && !isBothButtonsPressed()) {
-    // Buttons released
-    bothButtonsLock = false;
-  }
-  
-  // Replace long press right button detection with special mode activation
-  if (isRightButtonPressed()) {
-    static unsigned long rightPressStart = 0;
-    static bool rightLongPressActive = false;
-    
-    if (!rightLongPressActive) {
-      rightLongPressStart = millis();
-      rightLongPressActive = true;
-    }
-    
-    // Detect long press (1 second)
-    if (rightLongPressActive && (millis() - rightPressStart > 1000) && !specialMode) {
-      // Activate special mode with beautiful LED pattern
-      specialMode = true;
-      
-      // Beautiful LED sequence for special mode indication
-      for (int i = 0; i < 3; i++) {
-        // Flash cups
-        setLEDGroup("cups", HIGH);
-        delay(100);
-        setLEDGroup("cups", LOW);
-        
-        // Flash swords
-        setLEDGroup("swords", HIGH);
-        delay(100);
-        setLEDGroup("swords", LOW);
-        
-        // Flash wands
-        setLEDGroup("wands", HIGH);
-        delay(100);
-        setLEDGroup("wands", LOW);
-      }
-      
-      // Final confirmation flash
-      turnOnAllLEDs();
-      delay(200);
-      turnOffAllLEDs();
-      
-      Serial.println("SPECIAL MODE ACTIVATED! Full card range (1-78) available.");
-    }
-  } else {
-    // Reset right button tracking when released
-    rightLongPressActive = false;
-  }
-}
-
-void accelerometerNeoPixelDemoSmoother(Adafruit_NeoPixel &pixels) {
-  Serial.println("Accelerometer NeoPixel Demo Smoother. Press LEFT button to exit.");
-
-  // Define the grid dimensions
-  const uint8_t gridWidth = 5;
-  const uint8_t gridHeight = 5;
-
-  // Smoothing factor for low-pass filter
-  const float alpha = 0.2;  // Adjust between 0 (no new data) and 1 (no filtering)
-
-  // Variables to hold smoothed accelerometer values
-  float filteredX = 0;
-  float filteredY = 0;
-  float filteredZ = 0;
-
-  int selectedColorIndex = 0;  // Start with the first color
-                               // bool rightButtonLastState = HIGH; // Assume button not pressed (pull-up resistor)
+void spectrumAnalyzerMusic(Adafruit_NeoPixel &pixels) {
+  Serial.println("Spectrum Analyzer NeoPixel Demo. Press LEFT button to exit.");
+  setAnimationPalette(PALETTE_RAINBOW);
 
   // Variables for right button press detection
   bool rightButtonPressed = false;
@@ -2385,8 +2344,9 @@ void accelerometerNeoPixelDemoSmoother(Adafruit_NeoPixel &pixels) {
 
   bool rightButtonLastState = HIGH;  // Assume button not pressed (pull-up resistor)
 
-  while (!isLeftButtonPressed() && !animationInterrupted) {
+  while (animationRunning()) {
     Watchdog.reset();
+    paletteTick();
     unsigned long currentMillis = millis();
 
     // Check for both buttons pressed
@@ -2416,9 +2376,6 @@ void accelerometerNeoPixelDemoSmoother(Adafruit_NeoPixel &pixels) {
         if (pressDuration < SHORT_PRESS_THRESHOLD) {
           // Short press detected
           Serial.println("Short press detected. No change for this animation");
-          selectedColorIndex = (selectedColorIndex + 1) % numColors;
-          Serial.print("Color changed to index ");
-          Serial.println(selectedColorIndex);
         } else if (pressDuration >= LONG_PRESS_THRESHOLD && !longPressHandled) {
           // Long press detected upon release, only if not handled during holding
           Serial.println("Long press detected.");
@@ -2440,101 +2397,66 @@ void accelerometerNeoPixelDemoSmoother(Adafruit_NeoPixel &pixels) {
 
     rightButtonLastState = rightButtonCurrentState;
 
-    float x, y, z;
-    getAccelerometerValues(lis, x, y, z);
-
-    // Apply low-pass filter
-    filteredX = alpha * x + (1 - alpha) * filteredX;
-    filteredY = alpha * y + (1 - alpha) * filteredY;
-    filteredZ = alpha * z + (1 - alpha) * filteredZ;
-
-    // Map filtered x and y values to grid positions (0 to 4)
-    int gridX = map(filteredX * 100, -100, 100, 0, 4);
-    int gridY = map(filteredY * 100, -100, 100, 0, 4);  // Inverted Y mapping
-
-    // Constrain to grid
-    gridX = constrain(gridX, 0, 4);
-    gridY = constrain(gridY, 0, 4);
+    // Read audio & process FFT (also updates the band energies)
+    if (!recordAudioWithButtonCheck()) continue;  // animationRunning() sees the button
+    processFFT();
 
-    // Get pixel indices
-    int leftPixel = leftGrid[gridY][gridX];
-    int rightPixel = rightGrid[gridY][gridX];
+    // One band per canvas column, bars growing up from the bottom row
+    // with the peak hold drawn as a single brighter pixel
+    for (int col = 0; col < SPECTRUM_BANDS; col++) {
+      uint16_t height = bandEnergies.level[col] / 3;  // 0-15 levels to 0-5 rows, 8.8 fixed point
+      int peakRow = min(bandEnergies.peak[col] / 3 >> 8, 4);
+      uint8_t hue = col * 25;
 
-    // Clear all pixels
-    setAllNeoPixelsColor(pixels, pixels.Color(0, 0, 0));
+      for (int row = 0; row < 5; row++) {
+        int index = canvasPixelIndex(row, col);
+        if (index < 0) {
+          continue;
+        }
 
-    // Set the pixels
-    if (leftPixel != -1) {
-      uint8_t red = colorArray[selectedColorIndex][0];
-      uint8_t green = colorArray[selectedColorIndex][1];
-      uint8_t blue = colorArray[selectedColorIndex][2];
-      pixels.setPixelColor(leftPixel, pixels.Color(red, green, blue));
-    }
-    if (rightPixel != -1) {
-      uint8_t red = colorArray[selectedColorIndex][0];
-      uint8_t green = colorArray[selectedColorIndex][1];
-      uint8_t blue = colorArray[selectedColorIndex][2];
-      pixels.setPixelColor(rightPixel, pixels.Color(red, green, blue));
+        int fromBottom = 4 - row;
+        uint8_t level = 0;
+        if (height >= (fromBottom + 1) * 256) {
+          level = 160;
+        } else if (height > fromBottom * 256) {
+          level = (height - fromBottom * 256) * 160 / 256;  // Partly filled top of the bar
+        }
+        if (fromBottom == peakRow && bandEnergies.peak[col] > 0) {
+          level = 255;
+        }
+        pixels.setPixelColor(index, paletteColor(currentPalette, hue, level, false));
+      }
     }
-
     pixels.show();
-
-    // Small delay to allow for button checking
-    // delay(10);
+    delay(10);
   }
 
-  // Turn off all pixels after exiting
-  setAllNeoPixelsColor(pixels, pixels.Color(0, 0, 0));
-  delay(50);  // Debounce delay
+  setAllNeoPixelsColor(pixels, 0);
+  delay(50);
 }
 
+// Pitch to color: the hue walks the color wheel once per octave (C is red),
+// so each note has its own color in every octave. Loudness sets how bright
+// and how far out from each eye center the color reaches. Unpitched sound
+// keeps the last hue and fades out.
+void pitchColorMusic(Adafruit_NeoPixel &pixels) {
+  Serial.println("Pitch Color NeoPixel Demo. Press LEFT button to exit.");
+  setAnimationPalette(PALETTE_RAINBOW);
 
-void gameOfLifeNeoPixelDemo(Adafruit_NeoPixel &pixels) {
-  Serial.println("Game of Life Animation. Press LEFT button to exit.");
-
-  // Initialize grid mappings
-  copyGridsToCombinedGrid();
-
-  // Initialize live cell color
-  LIVE_CELL_COLOR = colorList[currentColorIndex];
-
-  // Initialize random seed from A3
-  randomSeed(analogRead(A3));  // Use A3 for random seed
-
-  // Initialize grid state
-  randomizeGrid();
-  displayGrid();
-  // printGridToSerial();
-
-  // Initialize previous states
-  for (int row = 0; row < 5; row++) {
-    for (int col = 0; col < 10; col++) {
-      previousState[row][col] = currentState[row][col];
-      secondPreviousState[row][col] = currentState[row][col];
-    }
-  }
-
-  // Variables for button debouncing
-  // bool rightButtonReading;
-  // bool rightButtonState = HIGH;       // Debounced button state
-  // bool lastRightButtonState = HIGH;   // Previous debounced button state
-
-
-  unsigned long lastDebounceTime = 0;
-  const unsigned long debounceDelay = 50;
-
-  unsigned long previousMillis = 0;
-  const unsigned long interval = 20;  // Update interval for animation
-  // Variables for right button press detection
-  bool rightButtonPressed = false;
-  unsigned long pressStartTime = 0;
-  bool longPressHandled = false;
+  // Variables for right button press detection
+  bool rightButtonPressed = false;
+  unsigned long pressStartTime = 0;
+  bool longPressHandled = false;
 
   bool rightButtonLastState = HIGH;  // Assume button not pressed (pull-up resistor)
 
-  while (!isLeftButtonPressed() && !animationInterrupted) {
+  uint16_t hue = 0;  // 8.8 fixed point, one full turn per 65536
+  uint8_t glow = 0;  // Smoothed brightness
+  uint8_t lastNote = 0xFF;
+
+  while (animationRunning()) {
     Watchdog.reset();
-    unsigned long currentMillis = millis();
+    paletteTick();
 
     // Check for both buttons pressed
     if (isBothButtonsPressed()) {
@@ -2562,9 +2484,7 @@ void gameOfLifeNeoPixelDemo(Adafruit_NeoPixel &pixels) {
         unsigned long pressDuration = millis() - pressStartTime;
         if (pressDuration < SHORT_PRESS_THRESHOLD) {
           // Short press detected
-          Serial.println("Short press detected.");
-          randomizeGrid();
-          displayGrid();
+          Serial.println("Short press detected. No change for this animation");
         } else if (pressDuration >= LONG_PRESS_THRESHOLD && !longPressHandled) {
           // Long press detected upon release, only if not handled during holding
           Serial.println("Long press detected.");
@@ -2586,317 +2506,325 @@ void gameOfLifeNeoPixelDemo(Adafruit_NeoPixel &pixels) {
 
     rightButtonLastState = rightButtonCurrentState;
 
-    if (currentMillis - lastGenerationTime >= GENERATION_INTERVAL_MS) {
-      lastGenerationTime = currentMillis;
-
-      // Perform fade out of current state
-      fadeTransition(true, false);
-
-      // Update grid to next generation
-      updateGrid();
+    // Next pitch frame (paced by the capture, one per FFT hop)
+    if (!processPitch()) continue;  // animationRunning() sees the button
 
-      // Check for restart conditions
-      bool allOff = true;
-      for (int row = 0; row < 5; row++) {
-        for (int col = 0; col < 10; col++) {
-          if (grid[row][col] != -1 && currentState[row][col]) {
-            allOff = false;
-            break;
-          }
-        }
-        if (!allOff) break;
+    float volume = calculateVolume();
+    float threshold = volumeThreshold();
+    uint8_t targetGlow = 0;
+
+    if (pitchTracker.voiced && volume > threshold) {
+      // Pitch class around the wheel, easing the short way round
+      uint16_t targetHue = (uint32_t)(pitchTracker.pitch % (12 << 8)) * 256 / 12;
+      hue += (int16_t)(targetHue - hue) / 4;
+      targetGlow = constrain((volume - threshold) / (15.0 - threshold) * 255, 0, 255);
+
+      if (pitchTracker.note != lastNote) {
+        lastNote = pitchTracker.note;
+        Serial.print("Pitch: ");
+        Serial.print(pitchTracker.frequency);
+        Serial.print(" Hz, note ");
+        Serial.print(pitchTracker.note);
+        Serial.print(" octave ");
+        Serial.println(pitchTracker.octave);
       }
+    }
 
-      if (allOff) {
-        restartSimulation();
-        continue;  // Skip further processing after restart
-      }
+    // Jump up to a louder note, fade out over a few dozen frames
+    if (targetGlow > glow) {
+      glow = targetGlow;
+    } else {
+      glow -= (glow - targetGlow + 7) / 8;
+    }
 
-      // Check if current state is same as previous state
-      if (areGridsEqual(currentState, previousState)) {
-        stableCounter++;
-        if (stableCounter >= STABLE_THRESHOLD) {
-          restartSimulation();
-          continue;  // Skip further processing after restart
-        }
-      } else {
-        stableCounter = 0;  // Reset counter if state changes
+    // Lit disc around each eye center, radius growing with the glow
+    uint16_t radius = LAYOUT_PIXEL_PITCH + glow * (2 * LAYOUT_PIXEL_PITCH) / 255;
+    for (int i = 0; i < NUMPIXELS; i++) {
+      uint16_t distance = pixelDistance(i);
+      uint8_t level = glow;
+      if (distance > radius) {
+        uint16_t fade = (distance - radius) * 16;
+        level = fade >= glow ? 0 : glow - fade;
       }
+      pixels.setPixelColor(i, paletteColor(currentPalette, hue >> 8, level));
+    }
+    pixels.show();
+  }
 
-      // Check for oscillation between two states
-      if (checkOscillation()) {
-        restartSimulation();
-        continue;  // Skip further processing after restart
-      }
+  setAllNeoPixelsColor(pixels, 0);
+  delay(50);
+}
 
-      // Save current state to previousState and secondPreviousState for next comparison
-      for (int row = 0; row < 5; row++) {
-        for (int col = 0; col < 10; col++) {
-          secondPreviousState[row][col] = previousState[row][col];
-          previousState[row][col] = currentState[row][col];
-        }
-      }
+// Draw a tarot card: write a random card URL to the NFC tag and scroll its
+// number across the eyes. The caller restores the running animation.
+void drawCard(bool useFullRange) {
+  if (useFullRange) {
+    Serial.println("Using full card range (1-78)");
+  } else {
+    Serial.println("Using limited card range (1-38)");
+  }
 
-      // Perform fade in of new state
-      fadeTransition(false, true);
+  // Visual feedback
+  turnOnAllLEDs();
+  setAllNeoPixelsColor(pixels, pixels.Color(255, 255, 255));
+  pixels.show();
 
-      // Display and print the updated grid
-      displayGrid();
-      // printGridToSerial();
-    }
+  // NFC operations
+  nfcWriter.wipeEEPROM();
+  nfcWriter.writeCCFile();
+  uint8_t card = nfcWriter.writeRandomURI(useFullRange);
 
-    // Small delay to prevent CPU hogging
-    delay(1);
-  }
+  Serial.println("NFC tag written.");
 
-  // Turn off all pixels after exiting
+  // Scroll the drawn card number across both eyes
+  char cardText[8];
+  snprintf(cardText, sizeof(cardText), "#%u", card);
+  setAllNeoPixelsColor(pixels, 0);
+  scrollerSetText(cardText, pixels.Color(255, 0, 0));
+  scrollerSetGlyphColor(0, pixels.Color(255, 255, 255));
+  scrollerRunBlocking(pixels);
+
+  // Clean up
+  turnOffAllLEDs();
   setAllNeoPixelsColor(pixels, 0);
   pixels.show();
-  delay(50);  // Debounce delay
 }
 
-
-// ---------------------------
-// Function Definitions
-// ---------------------------
-
-// Copy left and right grids into combined grid
-void copyGridsToCombinedGrid() {
-  // Copy left grid
-  for (int row = 0; row < 5; row++) {
-    for (int col = 0; col < 5; col++) {
-      grid[row][col] = leftGrid[row][col];
+void handleBothButtonsPressed() {
+  static bool bothButtonsLock = false;
+  static bool specialMode = false;
+  static unsigned long bothPressStart = 0;
+  static bool calibrationChordHandled = false;
+  static bool drawFullRange = false;
+  
+  // Handle both buttons being pressed. The card is drawn once they are let
+  // go, unless they were held long enough for the calibration chord.
+  if (!bothButtonsLock && isBothButtonsPressed()) {
+    bothButtonsLock = true;
+    bothPressStart = millis();
+    calibrationChordHandled = false;
+    
+    // Use the appropriate range based on special mode
+    drawFullRange = specialMode;
+    
+    if (drawFullRange) {
+      Serial.println("BOTH BUTTONS PRESSED IN SPECIAL MODE!");
+    } else {
+      Serial.println("BOTH BUTTONS PRESSED!");
     }
-  }
-  // Copy right grid
-  for (int row = 0; row < 5; row++) {
-    for (int col = 0; col < 5; col++) {
-      grid[row][col + 5] = rightGrid[row][col];
+    
+    // Reset special mode after use
+    specialMode = false;
+  } 
+  else if (bothButtonsLock && !isBothButtonsPressed()) {
+    // Buttons released
+    bothButtonsLock = false;
+    
+    if (!calibrationChordHandled) {
+      // Store the current animation
+      previousAnimation = currentAnimation;
+      currentAnimation = NULL;
+      
+      drawCard(drawFullRange);
+      
+      // Resume animation
+      currentAnimation = previousAnimation;
     }
   }
-}
-
-// Initialize the grid with a random pattern
-void randomizeGrid() {
-  clearGrid();  // Start with all cells dead
-
-  for (int row = 0; row < 5; row++) {
-    for (int col = 0; col < 10; col++) {
-      if (grid[row][col] != -1 && !isEdgeCell(row, col)) {
-        currentState[row][col] = random(0, 2);  // Randomly set to true (live) or false (dead)
-      } else {
-        currentState[row][col] = false;  // Edges are dead
+  else if (bothButtonsLock && !calibrationChordHandled &&
+           millis() - bothPressStart >= ACCEL_CALIBRATION_CHORD_MS) {
+    // Still holding both: calibrate the accelerometer once they are let go
+    calibrationChordHandled = true;
+    specialMode = false;  // A long right press on the way does not carry over
+    startAccelCalibration();
+    animationInterrupted = false;  // Nothing is running to stop
+  }
+  
+  // Replace long press right button detection with special mode activation
+  if (isRightButtonPressed()) {
+    static unsigned long rightPressStart = 0;
+    static bool rightLongPressActive = false;
+    
+    if (!rightLongPressActive) {
+      rightLongPressStart = millis();
+      rightLongPressActive = true;
+    }
+    
+    // Detect long press (1 second)
+    if (rightLongPressActive && (millis() - rightPressStart > 1000) && !specialMode) {
+      // Activate special mode with beautiful LED pattern
+      specialMode = true;
+      
+      // Beautiful LED sequence for special mode indication
+      for (int i = 0; i < 3; i++) {
+        // Flash cups
+        setLEDGroup("cups", HIGH);
+        delay(100);
+        setLEDGroup("cups", LOW);
+        
+        // Flash swords
+        setLEDGroup("swords", HIGH);
+        delay(100);
+        setLEDGroup("swords", LOW);
+        
+        // Flash wands
+        setLEDGroup("wands", HIGH);
+        delay(100);
+        setLEDGroup("wands", LOW);
       }
+      
+      // Final confirmation flash
+      turnOnAllLEDs();
+      delay(200);
+      turnOffAllLEDs();
+      
+      Serial.println("SPECIAL MODE ACTIVATED! Full card range (1-78) available.");
     }
+  } else {
+    // Reset right button tracking when released
+    rightLongPressActive = false;
   }
-
-  // Serial.println("Grid randomized.");
 }
 
-// Initialize the grid with a predefined pattern (e.g., Glider)
-void setPredefinedPattern() {
-  clearGrid();  // Start with all cells dead
+void accelerometerNeoPixelDemoSmoother(Adafruit_NeoPixel &pixels) {
+  Serial.println("Accelerometer NeoPixel Demo Smoother. Press LEFT button to exit.");
+  setAnimationPalette(PALETTE_CLASSIC);
 
-  // Example: Glider pattern
-  /*
-    . O .
-    . . O
-    O O O
-  */
+  // Define the grid dimensions
+  const uint8_t gridWidth = 5;
+  const uint8_t gridHeight = 5;
 
-  // Coordinates for the glider in the grid
-  // Assuming grid[5][10], placing glider somewhere not on the edge
-  int baseRow = 1;  // Starting at row 1
-  int baseCol = 3;  // Starting at column 3 (left grid)
+  // Smoothing is the shared low-pass (MOTION_LOWPASS_ALPHA, 0.2 per sample)
 
-  currentState[baseRow][baseCol + 0] = false;
-  currentState[baseRow][baseCol + 1] = true;
-  currentState[baseRow][baseCol + 2] = false;
+  int selectedColorIndex = 0;  // Start with the first color
+                               // bool rightButtonLastState = HIGH; // Assume button not pressed (pull-up resistor)
 
-  currentState[baseRow + 1][baseCol + 0] = false;
-  currentState[baseRow + 1][baseCol + 1] = false;
-  currentState[baseRow + 1][baseCol + 2] = true;
+  // Variables for right button press detection
+  bool rightButtonPressed = false;
+  unsigned long pressStartTime = 0;
+  bool longPressHandled = false;
 
-  currentState[baseRow + 2][baseCol + 0] = true;
-  currentState[baseRow + 2][baseCol + 1] = true;
-  currentState[baseRow + 2][baseCol + 2] = true;
+  bool rightButtonLastState = HIGH;  // Assume button not pressed (pull-up resistor)
 
-  // Serial.println("Predefined glider pattern set.");
-}
+  while (animationRunning()) {
+    Watchdog.reset();
+    paletteTick();
+    unsigned long currentMillis = millis();
 
-// Clear the grid by setting all cells to dead
-void clearGrid() {
-  for (int row = 0; row < 5; row++) {
-    for (int col = 0; col < 10; col++) {
-      currentState[row][col] = false;
-      nextState[row][col] = false;
-      previousState[row][col] = false;
-      secondPreviousState[row][col] = false;
-    }
-  }
-  stableCounter = 0;
-  oscillationCounter = 0;
-  // Serial.println("Grid cleared.");
-}
-
-// Update the grid to the next generation
-void updateGrid() {
-  for (int row = 0; row < 5; row++) {
-    for (int col = 0; col < 10; col++) {
-      if (grid[row][col] != -1) {
-        int liveNeighbors = countLiveNeighbors(row, col);
-        if (currentState[row][col]) {
-          // Cell is alive
-          if (liveNeighbors < 2 || liveNeighbors > 3) {
-            nextState[row][col] = false;  // Cell dies
-          } else {
-            nextState[row][col] = true;  // Cell lives
-          }
-        } else {
-          // Cell is dead
-          if (liveNeighbors == 3) {
-            nextState[row][col] = true;  // Cell becomes alive
-          } else {
-            nextState[row][col] = false;  // Cell remains dead
-          }
-        }
-      } else {
-        nextState[row][col] = false;  // No cell at this position
-      }
-    }
-  }
-
-  // Copy nextState to currentState
-  for (int row = 0; row < 5; row++) {
-    for (int col = 0; col < 10; col++) {
-      currentState[row][col] = nextState[row][col];
+    // Check for both buttons pressed
+    if (isBothButtonsPressed()) {
+      handleBothButtonsPressed();
     }
-  }
 
-  // Serial.println("Grid updated to next generation.");
-}
+    // Read the current state of the right button
+    bool rightButtonCurrentState = digitalRead(RIGHT_BUTTON_PIN);
 
-// Count the number of live neighbors for a cell
-int countLiveNeighbors(int row, int col) {
-  int liveNeighbors = 0;
-  for (int i = -1; i <= 1; i++) {
-    int neighborRow = row + i;
-    if (neighborRow < 0 || neighborRow >= 5) continue;
-    for (int j = -1; j <= 1; j++) {
-      int neighborCol = col + j;
-      if (neighborCol < 0 || neighborCol >= 10) continue;
-      if (i == 0 && j == 0) continue;  // Skip the cell itself
-      if (currentState[neighborRow][neighborCol]) {
-        liveNeighbors++;
+    if (rightButtonLastState == HIGH && rightButtonCurrentState == LOW) {
+      // Button was just pressed
+      delay(50);  // Debounce delay
+      rightButtonCurrentState = digitalRead(RIGHT_BUTTON_PIN);
+      if (rightButtonCurrentState == LOW) {
+        rightButtonPressed = true;
+        pressStartTime = millis();
+        longPressHandled = false;
+        Serial.println("Right button pressed.");
       }
     }
-  }
-  return liveNeighbors;
-}
 
-// Display the current grid state on the NeoPixel grids
-void displayGrid() {
-  // Directly set the pixel colors based on currentState
-  for (int row = 0; row < 5; row++) {
-    for (int col = 0; col < 10; col++) {
-      int pixelIndex = grid[row][col];
-      if (pixelIndex != -1) {
-        if (currentState[row][col]) {
-          pixels.setPixelColor(pixelIndex, LIVE_CELL_COLOR);
-        } else {
-          pixels.setPixelColor(pixelIndex, DEAD_CELL_COLOR);
+    if (rightButtonLastState == LOW && rightButtonCurrentState == HIGH) {
+      // Button was just released
+      if (rightButtonPressed) {
+        unsigned long pressDuration = millis() - pressStartTime;
+        if (pressDuration < SHORT_PRESS_THRESHOLD) {
+          // Short press detected
+          Serial.println("Short press detected. No change for this animation");
+          selectedColorIndex = (selectedColorIndex + 1) % numColors;
+          Serial.print("Color changed to index ");
+          Serial.println(selectedColorIndex);
+        } else if (pressDuration >= LONG_PRESS_THRESHOLD && !longPressHandled) {
+          // Long press detected upon release, only if not handled during holding
+          Serial.println("Long press detected.");
+          handleLongPress(animationIndex);  // Example function
         }
+        rightButtonPressed = false;
       }
     }
-  }
-  pixels.show();
-}
 
-// Print the current grid state to the Serial Monitor
-void printGridToSerial() {
-  Serial.println("Current Grid State:");
-  for (int row = 0; row < 5; row++) {
-    for (int col = 0; col < 10; col++) {
-      if (grid[row][col] != -1) {
-        Serial.print(currentState[row][col] ? "O" : ".");
-      } else {
-        Serial.print(" ");  // Represent invalid positions as space
+    // Handle long press if button is still pressed and threshold exceeded
+    if (rightButtonPressed && !longPressHandled) {
+      unsigned long pressDuration = millis() - pressStartTime;
+      if (pressDuration >= LONG_PRESS_THRESHOLD) {
+        longPressHandled = true;
+        Serial.println("Long press detected (while holding).");
+        handleLongPress(animationIndex);  // Example function
       }
     }
-    Serial.println();
-  }
-  Serial.println();
-}
 
-// Check if a cell is an edge cell (should remain dead)
-bool isEdgeCell(int row, int col) {
-  // Define edges where there are no physical LEDs
-  // Left grid edges
-  if (col < 5) {
-    if ((row == 0 && (col == 0 || col == 4)) || (row == 4 && (col == 0 || col == 4))) {
-      return true;
+    rightButtonLastState = rightButtonCurrentState;
+
+    // Smoothed gravity vector from the shared tilt estimate (steady when held, quick when tilted)
+    const MotionTiltEstimator &tilt = motionCaptureTilt();
+
+    // Map x and y values (-1 g to 1 g) to grid positions (0 to 4)
+    int gridX = map(tilt.vector[0], -MOTION_COUNTS_PER_G, MOTION_COUNTS_PER_G, 0, 4);
+    int gridY = map(tilt.vector[1], -MOTION_COUNTS_PER_G, MOTION_COUNTS_PER_G, 0, 4);  // Inverted Y mapping
+
+    // Constrain to grid
+    gridX = constrain(gridX, 0, 4);
+    gridY = constrain(gridY, 0, 4);
+
+    // Get pixel indices
+    int leftPixel = leftGrid[gridY][gridX];
+    int rightPixel = rightGrid[gridY][gridX];
+
+    // Clear all pixels
+    setAllNeoPixelsColor(pixels, pixels.Color(0, 0, 0));
+
+    // Set the pixels
+    if (leftPixel != -1) {
+      uint8_t red = currentPalette.rgb[selectedColorIndex][0];
+      uint8_t green = currentPalette.rgb[selectedColorIndex][1];
+      uint8_t blue = currentPalette.rgb[selectedColorIndex][2];
+      pixels.setPixelColor(leftPixel, pixels.Color(red, green, blue));
     }
-  }
-  // Right grid edges
-  if (col >= 5) {
-    int c = col - 5;
-    if ((row == 0 && (c == 0 || c == 4)) || (row == 4 && (c == 0 || c == 4))) {
-      return true;
+    if (rightPixel != -1) {
+      uint8_t red = currentPalette.rgb[selectedColorIndex][0];
+      uint8_t green = currentPalette.rgb[selectedColorIndex][1];
+      uint8_t blue = currentPalette.rgb[selectedColorIndex][2];
+      pixels.setPixelColor(rightPixel, pixels.Color(red, green, blue));
     }
-  }
-  return false;
-}
 
-// Compare two grids for equality
-bool areGridsEqual(bool grid1[5][10], bool grid2[5][10]) {
-  for (int row = 0; row < 5; row++) {
-    for (int col = 0; col < 10; col++) {
-      if (grid1[row][col] != grid2[row][col]) {
-        return false;
-      }
-    }
-  }
-  return true;
-}
+    pixels.show();
 
-// Check for oscillation between two states
-bool checkOscillation() {
-  if (areGridsEqual(currentState, secondPreviousState)) {
-    oscillationCounter++;
-    //  Serial.print("Oscillation count: ");
-    //  Serial.println(oscillationCounter);
-    if (oscillationCounter > OSCILLATION_THRESHOLD) {
-      return true;
-    }
-  } else {
-    oscillationCounter = 0;
+    // Small delay to allow for button checking
+    // delay(10);
   }
-  return false;
+
+  // Turn off all pixels after exiting
+  setAllNeoPixelsColor(pixels, pixels.Color(0, 0, 0));
+  delay(50);  // Debounce delay
 }
 
-// Restart the simulation by randomizing the grid and changing the live cell color
-void restartSimulation() {
-  // Change live cell color
-  currentColorIndex = (currentColorIndex + 1) % numColors2;
-  LIVE_CELL_COLOR = colorList[currentColorIndex];
 
-  // Serial.print("Changing live cell color to: ");
-  //  Serial.println(LIVE_CELL_COLOR, HEX);
+void gameOfLifeNeoPixelDemo(Adafruit_NeoPixel &pixels) {
+  Serial.println("Game of Life Animation. Press LEFT button to exit.");
+  setAnimationPalette(PALETTE_CLASSIC);
 
-  // Perform fade out of current state
-  fadeTransition(true, false);
+  // Initialize grid mappings
+  copyGridsToCombinedGrid();
 
-  // Reinitialize grid
-  randomizeGrid();
+  // Initialize live cell color
+  LIVE_CELL_COLOR = paletteStopColor(currentPalette, currentColorIndex);
 
-  // Perform fade in of new state
-  fadeTransition(false, true);
+  // Initialize random seed from A3
+  randomSeed(analogRead(A3));  // Use A3 for random seed
 
-  // Display and print the updated grid
+  // Initialize grid state
+  randomizeGrid();
   displayGrid();
   // printGridToSerial();
 
-  // Update previous states to match current state
+  // Initialize previous states
   for (int row = 0; row < 5; row++) {
     for (int col = 0; col < 10; col++) {
       previousState[row][col] = currentState[row][col];
@@ -2904,43 +2832,434 @@ void restartSimulation() {
     }
   }
 
-  // Reset stable and oscillation counters
-  stableCounter = 0;
-  oscillationCounter = 0;
-}
+  // Variables for button debouncing
+  // bool rightButtonReading;
+  // bool rightButtonState = HIGH;       // Debounced button state
+  // bool lastRightButtonState = HIGH;   // Previous debounced button state
 
 
-// Fade transition between states
-void fadeTransition(bool fadingOut, bool fadingIn) {
-  const int FADE_STEPS = 20;
-  for (int step = 1; step <= FADE_STEPS; step++) {
-    // Check for left button press to exit early
-    if (isLeftButtonPressed()) {
-      break;
-    }
+  unsigned long lastDebounceTime = 0;
+  const unsigned long debounceDelay = 50;
 
-    for (int row = 0; row < 5; row++) {
-      for (int col = 0; col < 10; col++) {
-        int pixelIndex = grid[row][col];
-        if (pixelIndex != -1) {
-          bool wasLive = previousState[row][col];
-          bool isLive = currentState[row][col];
+  unsigned long previousMillis = 0;
+  const unsigned long interval = 20;  // Update interval for animation
+  // Variables for right button press detection
+  bool rightButtonPressed = false;
+  unsigned long pressStartTime = 0;
+  bool longPressHandled = false;
 
-          uint32_t fromColor = wasLive ? LIVE_CELL_COLOR : DEAD_CELL_COLOR;
-          uint32_t toColor = isLive ? LIVE_CELL_COLOR : DEAD_CELL_COLOR;
+  bool rightButtonLastState = HIGH;  // Assume button not pressed (pull-up resistor)
 
-          uint8_t r1 = (fromColor >> 16) & 0xFF;
-          uint8_t g1 = (fromColor >> 8) & 0xFF;
-          uint8_t b1 = fromColor & 0xFF;
+  while (animationRunning()) {
+    Watchdog.reset();
+    paletteTick();
+    unsigned long currentMillis = millis();
 
-          uint8_t r2 = (toColor >> 16) & 0xFF;
-          uint8_t g2 = (toColor >> 8) & 0xFF;
-          uint8_t b2 = toColor & 0xFF;
+    // Check for both buttons pressed
+    if (isBothButtonsPressed()) {
+      handleBothButtonsPressed();
+    }
 
-          uint8_t r, g, b;
+    // Read the current state of the right button
+    bool rightButtonCurrentState = digitalRead(RIGHT_BUTTON_PIN);
 
-          if (fadingOut && !fadingIn) {
-            // Only fade out
+    if (rightButtonLastState == HIGH && rightButtonCurrentState == LOW) {
+      // Button was just pressed
+      delay(50);  // Debounce delay
+      rightButtonCurrentState = digitalRead(RIGHT_BUTTON_PIN);
+      if (rightButtonCurrentState == LOW) {
+        rightButtonPressed = true;
+        pressStartTime = millis();
+        longPressHandled = false;
+        Serial.println("Right button pressed.");
+      }
+    }
+
+    if (rightButtonLastState == LOW && rightButtonCurrentState == HIGH) {
+      // Button was just released
+      if (rightButtonPressed) {
+        unsigned long pressDuration = millis() - pressStartTime;
+        if (pressDuration < SHORT_PRESS_THRESHOLD) {
+          // Short press detected
+          Serial.println("Short press detected.");
+          randomizeGrid();
+          displayGrid();
+        } else if (pressDuration >= LONG_PRESS_THRESHOLD && !longPressHandled) {
+          // Long press detected upon release, only if not handled during holding
+          Serial.println("Long press detected.");
+          handleLongPress(animationIndex);  // Example function
+        }
+        rightButtonPressed = false;
+      }
+    }
+
+    // Handle long press if button is still pressed and threshold exceeded
+    if (rightButtonPressed && !longPressHandled) {
+      unsigned long pressDuration = millis() - pressStartTime;
+      if (pressDuration >= LONG_PRESS_THRESHOLD) {
+        longPressHandled = true;
+        Serial.println("Long press detected (while holding).");
+        handleLongPress(animationIndex);  // Example function
+      }
+    }
+
+    rightButtonLastState = rightButtonCurrentState;
+
+    if (currentMillis - lastGenerationTime >= GENERATION_INTERVAL_MS) {
+      lastGenerationTime = currentMillis;
+
+      // Perform fade out of current state
+      fadeTransition(true, false);
+
+      // Update grid to next generation
+      updateGrid();
+
+      // Check for restart conditions
+      bool allOff = true;
+      for (int row = 0; row < 5; row++) {
+        for (int col = 0; col < 10; col++) {
+          if (grid[row][col] != -1 && currentState[row][col]) {
+            allOff = false;
+            break;
+          }
+        }
+        if (!allOff) break;
+      }
+
+      if (allOff) {
+        restartSimulation();
+        continue;  // Skip further processing after restart
+      }
+
+      // Check if current state is same as previous state
+      if (areGridsEqual(currentState, previousState)) {
+        stableCounter++;
+        if (stableCounter >= STABLE_THRESHOLD) {
+          restartSimulation();
+          continue;  // Skip further processing after restart
+        }
+      } else {
+        stableCounter = 0;  // Reset counter if state changes
+      }
+
+      // Check for oscillation between two states
+      if (checkOscillation()) {
+        restartSimulation();
+        continue;  // Skip further processing after restart
+      }
+
+      // Save current state to previousState and secondPreviousState for next comparison
+      for (int row = 0; row < 5; row++) {
+        for (int col = 0; col < 10; col++) {
+          secondPreviousState[row][col] = previousState[row][col];
+          previousState[row][col] = currentState[row][col];
+        }
+      }
+
+      // Perform fade in of new state
+      fadeTransition(false, true);
+
+      // Display and print the updated grid
+      displayGrid();
+      // printGridToSerial();
+    }
+
+    // Small delay to prevent CPU hogging
+    delay(1);
+  }
+
+  // Turn off all pixels after exiting
+  setAllNeoPixelsColor(pixels, 0);
+  pixels.show();
+  delay(50);  // Debounce delay
+}
+
+
+// ---------------------------
+// Function Definitions
+// ---------------------------
+
+// Copy left and right grids into combined grid
+void copyGridsToCombinedGrid() {
+  // Copy left grid
+  for (int row = 0; row < 5; row++) {
+    for (int col = 0; col < 5; col++) {
+      grid[row][col] = leftGrid[row][col];
+    }
+  }
+  // Copy right grid
+  for (int row = 0; row < 5; row++) {
+    for (int col = 0; col < 5; col++) {
+      grid[row][col + 5] = rightGrid[row][col];
+    }
+  }
+}
+
+// Initialize the grid with a random pattern
+void randomizeGrid() {
+  clearGrid();  // Start with all cells dead
+
+  for (int row = 0; row < 5; row++) {
+    for (int col = 0; col < 10; col++) {
+      if (grid[row][col] != -1 && !isEdgeCell(row, col)) {
+        currentState[row][col] = random(0, 2);  // Randomly set to true (live) or false (dead)
+      } else {
+        currentState[row][col] = false;  // Edges are dead
+      }
+    }
+  }
+
+  // Serial.println("Grid randomized.");
+}
+
+// Initialize the grid with a predefined pattern (e.g., Glider)
+void setPredefinedPattern() {
+  clearGrid();  // Start with all cells dead
+
+  // Example: Glider pattern
+  /*
+    . O .
+    . . O
+    O O O
+  */
+
+  // Coordinates for the glider in the grid
+  // Assuming grid[5][10], placing glider somewhere not on the edge
+  int baseRow = 1;  // Starting at row 1
+  int baseCol = 3;  // Starting at column 3 (left grid)
+
+  currentState[baseRow][baseCol + 0] = false;
+  currentState[baseRow][baseCol + 1] = true;
+  currentState[baseRow][baseCol + 2] = false;
+
+  currentState[baseRow + 1][baseCol + 0] = false;
+  currentState[baseRow + 1][baseCol + 1] = false;
+  currentState[baseRow + 1][baseCol + 2] = true;
+
+  currentState[baseRow + 2][baseCol + 0] = true;
+  currentState[baseRow + 2][baseCol + 1] = true;
+  currentState[baseRow + 2][baseCol + 2] = true;
+
+  // Serial.println("Predefined glider pattern set.");
+}
+
+// Clear the grid by setting all cells to dead
+void clearGrid() {
+  for (int row = 0; row < 5; row++) {
+    for (int col = 0; col < 10; col++) {
+      currentState[row][col] = false;
+      nextState[row][col] = false;
+      previousState[row][col] = false;
+      secondPreviousState[row][col] = false;
+    }
+  }
+  stableCounter = 0;
+  oscillationCounter = 0;
+  // Serial.println("Grid cleared.");
+}
+
+// Update the grid to the next generation
+void updateGrid() {
+  for (int row = 0; row < 5; row++) {
+    for (int col = 0; col < 10; col++) {
+      if (grid[row][col] != -1) {
+        int liveNeighbors = countLiveNeighbors(row, col);
+        if (currentState[row][col]) {
+          // Cell is alive
+          if (liveNeighbors < 2 || liveNeighbors > 3) {
+            nextState[row][col] = false;  // Cell dies
+          } else {
+            nextState[row][col] = true;  // Cell lives
+          }
+        } else {
+          // Cell is dead
+          if (liveNeighbors == 3) {
+            nextState[row][col] = true;  // Cell becomes alive
+          } else {
+            nextState[row][col] = false;  // Cell remains dead
+          }
+        }
+      } else {
+        nextState[row][col] = false;  // No cell at this position
+      }
+    }
+  }
+
+  // Copy nextState to currentState
+  for (int row = 0; row < 5; row++) {
+    for (int col = 0; col < 10; col++) {
+      currentState[row][col] = nextState[row][col];
+    }
+  }
+
+  // Serial.println("Grid updated to next generation.");
+}
+
+// Count the number of live neighbors for a cell
+int countLiveNeighbors(int row, int col) {
+  int liveNeighbors = 0;
+  for (int i = -1; i <= 1; i++) {
+    int neighborRow = row + i;
+    if (neighborRow < 0 || neighborRow >= 5) continue;
+    for (int j = -1; j <= 1; j++) {
+      int neighborCol = col + j;
+      if (neighborCol < 0 || neighborCol >= 10) continue;
+      if (i == 0 && j == 0) continue;  // Skip the cell itself
+      if (currentState[neighborRow][neighborCol]) {
+        liveNeighbors++;
+      }
+    }
+  }
+  return liveNeighbors;
+}
+
+// Display the current grid state on the NeoPixel grids
+void displayGrid() {
+  // Directly set the pixel colors based on currentState
+  for (int row = 0; row < 5; row++) {
+    for (int col = 0; col < 10; col++) {
+      int pixelIndex = grid[row][col];
+      if (pixelIndex != -1) {
+        if (currentState[row][col]) {
+          pixels.setPixelColor(pixelIndex, LIVE_CELL_COLOR);
+        } else {
+          pixels.setPixelColor(pixelIndex, DEAD_CELL_COLOR);
+        }
+      }
+    }
+  }
+  pixels.show();
+}
+
+// Print the current grid state to the Serial Monitor
+void printGridToSerial() {
+  Serial.println("Current Grid State:");
+  for (int row = 0; row < 5; row++) {
+    for (int col = 0; col < 10; col++) {
+      if (grid[row][col] != -1) {
+        Serial.print(currentState[row][col] ? "O" : ".");
+      } else {
+        Serial.print(" ");  // Represent invalid positions as space
+      }
+    }
+    Serial.println();
+  }
+  Serial.println();
+}
+
+// Check if a cell is an edge cell (should remain dead)
+bool isEdgeCell(int row, int col) {
+  // Define edges where there are no physical LEDs
+  // Left grid edges
+  if (col < 5) {
+    if ((row == 0 && (col == 0 || col == 4)) || (row == 4 && (col == 0 || col == 4))) {
+      return true;
+    }
+  }
+  // Right grid edges
+  if (col >= 5) {
+    int c = col - 5;
+    if ((row == 0 && (c == 0 || c == 4)) || (row == 4 && (c == 0 || c == 4))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Compare two grids for equality
+bool areGridsEqual(bool grid1[5][10], bool grid2[5][10]) {
+  for (int row = 0; row < 5; row++) {
+    for (int col = 0; col < 10; col++) {
+      if (grid1[row][col] != grid2[row][col]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Check for oscillation between two states
+bool checkOscillation() {
+  if (areGridsEqual(currentState, secondPreviousState)) {
+    oscillationCounter++;
+    //  Serial.print("Oscillation count: ");
+    //  Serial.println(oscillationCounter);
+    if (oscillationCounter > OSCILLATION_THRESHOLD) {
+      return true;
+    }
+  } else {
+    oscillationCounter = 0;
+  }
+  return false;
+}
+
+// Restart the simulation by randomizing the grid and changing the live cell color
+void restartSimulation() {
+  // Change live cell color
+  currentColorIndex = (currentColorIndex + 1) % PALETTE_STOPS;
+  LIVE_CELL_COLOR = paletteStopColor(currentPalette, currentColorIndex);
+
+  // Serial.print("Changing live cell color to: ");
+  //  Serial.println(LIVE_CELL_COLOR, HEX);
+
+  // Perform fade out of current state
+  fadeTransition(true, false);
+
+  // Reinitialize grid
+  randomizeGrid();
+
+  // Perform fade in of new state
+  fadeTransition(false, true);
+
+  // Display and print the updated grid
+  displayGrid();
+  // printGridToSerial();
+
+  // Update previous states to match current state
+  for (int row = 0; row < 5; row++) {
+    for (int col = 0; col < 10; col++) {
+      previousState[row][col] = currentState[row][col];
+      secondPreviousState[row][col] = currentState[row][col];
+    }
+  }
+
+  // Reset stable and oscillation counters
+  stableCounter = 0;
+  oscillationCounter = 0;
+}
+
+
+// Fade transition between states
+void fadeTransition(bool fadingOut, bool fadingIn) {
+  const int FADE_STEPS = 20;
+  for (int step = 1; step <= FADE_STEPS; step++) {
+    // Check for left button press to exit early
+    if (isLeftButtonPressed()) {
+      break;
+    }
+
+    for (int row = 0; row < 5; row++) {
+      for (int col = 0; col < 10; col++) {
+        int pixelIndex = grid[row][col];
+        if (pixelIndex != -1) {
+          bool wasLive = previousState[row][col];
+          bool isLive = currentState[row][col];
+
+          uint32_t fromColor = wasLive ? LIVE_CELL_COLOR : DEAD_CELL_COLOR;
+          uint32_t toColor = isLive ? LIVE_CELL_COLOR : DEAD_CELL_COLOR;
+
+          uint8_t r1 = (fromColor >> 16) & 0xFF;
+          uint8_t g1 = (fromColor >> 8) & 0xFF;
+          uint8_t b1 = fromColor & 0xFF;
+
+          uint8_t r2 = (toColor >> 16) & 0xFF;
+          uint8_t g2 = (toColor >> 8) & 0xFF;
+          uint8_t b2 = toColor & 0xFF;
+
+          uint8_t r, g, b;
+
+          if (fadingOut && !fadingIn) {
+            // Only fade out
             r = r1 - (r1 * step) / FADE_STEPS;
             g = g1 - (g1 * step) / FADE_STEPS;
             b = b1 - (b1 * step) / FADE_STEPS;
@@ -2950,50 +3269,698 @@ void fadeTransition(bool fadingOut, bool fadingIn) {
             g = g1 + ((g2 - g1) * step) / FADE_STEPS;
             b = b1 + ((b2 - b1) * step) / FADE_STEPS;
           } else {
-            // No fading
-            r = r2;
-            g = g2;
-            b = b2;
+            // No fading
+            r = r2;
+            g = g2;
+            b = b2;
+          }
+
+          // Ensure RGB values are within 0-255
+          r = constrain(r, 0, 255);
+          g = constrain(g, 0, 255);
+          b = constrain(b, 0, 255);
+
+          pixels.setPixelColor(pixelIndex, pixels.Color(r, g, b));
+        }
+      }
+    }
+    pixels.show();
+    delay(FADE_STEP_DELAY_MS);
+  }
+}
+
+
+///////////////////////////////////////////
+
+// tetris animation function
+
+///*
+// Tetris animation function
+void tetrisNeoPixelDemo(Adafruit_NeoPixel &pixels) {
+  // Seed random number generator using analogRead(A3)
+  randomSeed(analogRead(A3));
+  Serial.println("Tetris Animation. Press LEFT button to exit.");
+
+  // Spawn the first piece
+  spawnNewPiece();
+
+  // Variables for button debouncing
+  // bool rightButtonReading;
+  //  bool rightButtonState = HIGH;       // Debounced button state
+  // bool lastRightButtonState = HIGH;   // Previous debounced button state
+  unsigned long lastDebounceTime = 0;
+  const unsigned long debounceDelay = 50;
+
+  unsigned long previousMillis = 0;
+  const unsigned long interval = 20;  // Update interval for animation
+
+  // Variables for right button press detection
+  bool rightButtonPressed = false;
+  unsigned long pressStartTime = 0;
+  bool longPressHandled = false;
+
+  bool rightButtonLastState = HIGH;  // Assume button not pressed (pull-up resistor)
+
+  while (animationRunning()) {
+    Watchdog.reset();
+    unsigned long currentMillis = millis();
+
+    // Check for both buttons pressed
+    if (isBothButtonsPressed()) {
+      handleBothButtonsPressed();
+    }
+
+    // Read the current state of the right button
+    bool rightButtonCurrentState = digitalRead(RIGHT_BUTTON_PIN);
+
+    if (rightButtonLastState == HIGH && rightButtonCurrentState == LOW) {
+      // Button was just pressed
+      delay(50);  // Debounce delay
+      rightButtonCurrentState = digitalRead(RIGHT_BUTTON_PIN);
+      if (rightButtonCurrentState == LOW) {
+        rightButtonPressed = true;
+        pressStartTime = millis();
+        longPressHandled = false;
+        Serial.println("Right button pressed.");
+      }
+    }
+
+    if (rightButtonLastState == LOW && rightButtonCurrentState == HIGH) {
+      // Button was just released
+      if (rightButtonPressed) {
+        unsigned long pressDuration = millis() - pressStartTime;
+        if (pressDuration < SHORT_PRESS_THRESHOLD) {
+          // Short press detected
+          Serial.println("Short press detected.");
+          rotatePiece();
+        } else if (pressDuration >= LONG_PRESS_THRESHOLD && !longPressHandled) {
+          // Long press detected upon release, only if not handled during holding
+          Serial.println("Long press detected.");
+          handleLongPress(animationIndex);  // Example function
+        }
+        rightButtonPressed = false;
+      }
+    }
+
+    // Handle long press if button is still pressed and threshold exceeded
+    if (rightButtonPressed && !longPressHandled) {
+      unsigned long pressDuration = millis() - pressStartTime;
+      if (pressDuration >= LONG_PRESS_THRESHOLD) {
+        longPressHandled = true;
+        Serial.println("Long press detected (while holding).");
+        handleLongPress(animationIndex);  // Example function
+      }
+    }
+
+    rightButtonLastState = rightButtonCurrentState;
+
+    // Move the piece down at regular intervals
+    if (currentMillis - lastFallTime >= FALL_SPEED_MS) {
+      lastFallTime = currentMillis;
+
+      // Move the piece down
+      pieceY += 1;
+
+      // If the piece has moved beyond the grid, spawn a new piece
+      if (pieceY > GRID_HEIGHT) {
+        spawnNewPiece();
+      }
+    }
+
+    // Draw the current piece
+    drawCurrentPiece();
+
+    // Small delay to prevent CPU hogging
+    delay(1);
+  }
+
+  // Turn off all pixels after exiting
+  clearDisplay();
+  pixels.show();
+  delay(50);  // Debounce delay
+}
+
+//*/
+
+// ---------------------------
+// Function Definitions
+// ---------------------------
+
+// Spawn a new random tetromino
+void spawnNewPiece() {
+  int index = random(0, NUM_TETROMINOES);
+
+  // Copy the shape
+  copyShape(currentPiece.shape, tetrominoShapes[index]);
+
+  // Set the color
+  currentPiece.color = tetrominoColors[index];
+
+  // Reset position
+  pieceX = 1;   // Start near the middle
+  pieceY = -4;  // Start above the grid
+
+  // Reset rotation state
+  currentPiece.rotationState = 0;
+
+  // Serial.print("Spawned New Piece Index: ");
+  // Serial.println(index);
+}
+
+// Rotate the current piece
+void rotatePiece() {
+  // Update rotation state
+  currentPiece.rotationState = (currentPiece.rotationState + 1) % 4;
+  // Serial.print("Rotation State: ");
+  // Serial.println(currentPiece.rotationState);
+}
+
+// Draw the current piece on the NeoPixel grids
+void drawCurrentPiece() {
+  // Clear the display
+  clearDisplay();
+
+  // Create a temporary shape to hold the rotated shape
+  int rotatedShape[4][4];
+  copyShape(rotatedShape, currentPiece.shape);
+  rotateShape(rotatedShape, currentPiece.rotationState);
+
+  // Draw current piece
+  for (int y = 0; y < 4; y++) {
+    for (int x = 0; x < 4; x++) {
+      if (rotatedShape[y][x]) {
+        int gridX = pieceX + x;
+        int gridY = pieceY + y;
+        if (gridY >= 0 && gridY < GRID_HEIGHT && gridX >= 0 && gridX < GRID_WIDTH) {
+          int leftPixelIndex = leftGrid[gridY][gridX];
+          int rightPixelIndex = rightGrid[gridY][gridX];
+          if (leftPixelIndex != -1) {
+            pixels.setPixelColor(leftPixelIndex, currentPiece.color);
+          }
+          if (rightPixelIndex != -1) {
+            pixels.setPixelColor(rightPixelIndex, currentPiece.color);
+          }
+        }
+      }
+    }
+  }
+
+  // Update the NeoPixel strip to show changes
+  pixels.show();
+}
+
+// Clear the display
+void clearDisplay() {
+  pixels.clear();
+}
+
+// Copy a shape from src to dest
+void copyShape(int dest[4][4], const int src[4][4]) {
+  for (int y = 0; y < 4; y++) {
+    for (int x = 0; x < 4; x++) {
+      dest[y][x] = src[y][x];
+    }
+  }
+}
+
+// Rotate the shape based on rotation state
+void rotateShape(int shape[4][4], int rotationState) {
+  int temp[4][4];
+
+  // Apply rotation the number of times specified by rotationState
+  for (int i = 0; i < rotationState; i++) {
+    // Rotate the shape 90 degrees clockwise
+    for (int y = 0; y < 4; y++) {
+      for (int x = 0; x < 4; x++) {
+        temp[y][x] = shape[3 - x][y];
+      }
+    }
+    // Copy temp back to shape
+    for (int y = 0; y < 4; y++) {
+      for (int x = 0; x < 4; x++) {
+        shape[y][x] = temp[y][x];
+      }
+    }
+  }
+}
+
+
+// Falling Drops animation function
+void fallingDropsNeoPixelDemo(Adafruit_NeoPixel &pixels) {
+  Serial.println("Falling Drops Animation. Press LEFT button to exit.");
+  setAnimationPalette(PALETTE_RAINBOW);
+
+  // Droplet Arrays for Grids
+  Droplet dropletsLeft[MAX_DROPLETS_PER_GRID];
+  int dropletCountLeft = 0;
+
+  Droplet dropletsRight[MAX_DROPLETS_PER_GRID];
+  int dropletCountRight = 0;
+
+  // Color Selection Variables
+  int colorMode = 0;  // 0 = Random, 1-16 = palette stops 0-15
+
+  // Variables for Button Debouncing
+  // bool rightButtonLastState = HIGH;
+  unsigned long lastDebounceTime = 0;
+  const unsigned long debounceDelay = 50;
+
+  // Initialize Droplet arrays for Left and Right grids
+  for (int i = 0; i < MAX_DROPLETS_PER_GRID; i++) {
+    // Left Grid Droplets
+    dropletsLeft[i].row = -1;  // Inactive
+
+    // Right Grid Droplets
+    dropletsRight[i].row = -1;  // Inactive
+  }
+
+  // Seed random number generator for randomized colors and positions
+  randomSeed(analogRead(A3));
+
+  unsigned long previousMillis = 0;
+  const unsigned long interval = 20;  // Update interval for animation
+
+  // Variables for right button press detection
+  bool rightButtonPressed = false;
+  unsigned long pressStartTime = 0;
+  bool longPressHandled = false;
+
+  bool rightButtonLastState = HIGH;  // Assume button not pressed (pull-up resistor)
+
+  while (animationRunning()) {
+    Watchdog.reset();
+    paletteTick();
+    unsigned long currentMillis = millis();
+
+    // Check for both buttons pressed
+    if (isBothButtonsPressed()) {
+      handleBothButtonsPressed();
+    }
+
+    // Read the current state of the right button
+    bool rightButtonCurrentState = digitalRead(RIGHT_BUTTON_PIN);
+
+    if (rightButtonLastState == HIGH && rightButtonCurrentState == LOW) {
+      // Button was just pressed
+      delay(50);  // Debounce delay
+      rightButtonCurrentState = digitalRead(RIGHT_BUTTON_PIN);
+      if (rightButtonCurrentState == LOW) {
+        rightButtonPressed = true;
+        pressStartTime = millis();
+        longPressHandled = false;
+        Serial.println("Right button pressed.");
+      }
+    }
+
+    if (rightButtonLastState == LOW && rightButtonCurrentState == HIGH) {
+      // Button was just released
+      if (rightButtonPressed) {
+        unsigned long pressDuration = millis() - pressStartTime;
+        if (pressDuration < SHORT_PRESS_THRESHOLD) {
+          // Short press detected
+          Serial.println("Short press detected.");
+          // Cycle colorMode
+          colorMode = (colorMode + 1) % (numColors + 1);  // 0 to numColors
+        } else if (pressDuration >= LONG_PRESS_THRESHOLD && !longPressHandled) {
+          // Long press detected upon release, only if not handled during holding
+          Serial.println("Long press detected.");
+          handleLongPress(animationIndex);  // Example function
+        }
+        rightButtonPressed = false;
+      }
+    }
+
+    // Handle long press if button is still pressed and threshold exceeded
+    if (rightButtonPressed && !longPressHandled) {
+      unsigned long pressDuration = millis() - pressStartTime;
+      if (pressDuration >= LONG_PRESS_THRESHOLD) {
+        longPressHandled = true;
+        Serial.println("Long press detected (while holding).");
+        handleLongPress(animationIndex);  // Example function
+      }
+    }
+
+    rightButtonLastState = rightButtonCurrentState;
+
+    if (currentMillis - previousMillis >= interval) {
+      previousMillis = currentMillis;
+
+      // Create new droplets for Left Grid
+      if (dropletCountLeft < MAX_DROPLETS_PER_GRID) {
+        createDroplet(dropletsLeft, dropletCountLeft, leftGrid);
+      }
+
+      // Create new droplets for Right Grid
+      if (dropletCountRight < MAX_DROPLETS_PER_GRID) {
+        createDroplet(dropletsRight, dropletCountRight, rightGrid);
+      }
+
+      // Update droplet positions for Left Grid
+      updateDroplets(dropletsLeft, dropletCountLeft, leftGrid);
+
+      // Update droplet positions for Right Grid
+      updateDroplets(dropletsRight, dropletCountRight, rightGrid);
+
+      // Display droplets on Left Grid
+      displayDroplets(dropletsLeft, dropletCountLeft, leftGrid);
+
+      // Display droplets on Right Grid
+      displayDroplets(dropletsRight, dropletCountRight, rightGrid);
+    }
+
+    // Small delay to prevent CPU hogging
+    delay(1);
+  }
+
+  // Turn off all pixels after exiting
+  setAllNeoPixelsColor(pixels, 0);
+  pixels.show();
+  delay(50);  // Debounce delay
+}
+
+// ---------------------------
+// Function Definitions
+// ---------------------------
+
+// Function to create a new droplet in the specified grid
+void createDroplet(Droplet droplets[], int &dropletCount, const int grid[5][5]) {
+  // Find an inactive droplet slot
+  for (int i = 0; i < MAX_DROPLETS_PER_GRID; i++) {
+    if (droplets[i].row == -1) {
+      droplets[i].row = 0;  // Start at top row (y=0)
+
+      // Assign a random column within the grid based on row
+      // y=0: columns 1-3
+      // y=1-3: columns 0-4
+      if (droplets[i].row == 0) {
+        droplets[i].column = random(1, 4);  // Columns 1, 2, 3
+      } else {
+        droplets[i].column = random(0, 5);  // Columns 0-4
+      }
+
+      // Ensure the assigned column has a valid pixel in the current row
+      if (grid[droplets[i].row][droplets[i].column] == -1) {
+        // If invalid, assign to a valid column within the row
+        if (droplets[i].row == 0) {
+          droplets[i].column = random(1, 4);  // y=0: Columns 1-3
+        } else {
+          droplets[i].column = random(0, 5);  // y=1-3: Columns 0-4
+        }
+
+        // Recheck and assign again if necessary
+        while (grid[droplets[i].row][droplets[i].column] == -1) {
+          if (droplets[i].row == 0) {
+            droplets[i].column = random(1, 4);
+          } else {
+            droplets[i].column = random(0, 5);
           }
+        }
+      }
 
-          // Ensure RGB values are within 0-255
-          r = constrain(r, 0, 255);
-          g = constrain(g, 0, 255);
-          b = constrain(b, 0, 255);
+      // Assign color based on current colorMode
+      droplets[i].color = getColor();
 
-          pixels.setPixelColor(pixelIndex, pixels.Color(r, g, b));
+      // Set fixed speed
+      droplets[i].speed = DROPLET_SPEED_MS;
+
+      // Update the lastUpdate timestamp
+      droplets[i].lastUpdate = millis();
+
+      // Increment droplet count
+      dropletCount++;
+
+      break;  // Exit after creating one droplet
+    }
+  }
+}
+
+// Function to update droplet positions in the specified grid
+void updateDroplets(Droplet droplets[], int &dropletCount, const int grid[5][5]) {
+  unsigned long currentTime = millis();
+
+  for (int i = 0; i < MAX_DROPLETS_PER_GRID; i++) {
+    if (droplets[i].row != -1) {  // Active droplet
+      if (currentTime - droplets[i].lastUpdate >= droplets[i].speed) {
+        droplets[i].row += 1;                  // Move droplet down by one row
+        droplets[i].lastUpdate = currentTime;  // Reset the lastUpdate timestamp
+
+        // Assign a new column if the droplet is now in y=1,2,3
+        if (droplets[i].row >= 1 && droplets[i].row <= 3) {
+          droplets[i].column = random(0, 5);  // Columns 0-4
+
+          // Ensure the new column has a valid pixel in the current row
+          if (grid[droplets[i].row][droplets[i].column] == -1) {
+            // If invalid, assign to a valid column within the row
+            droplets[i].column = random(0, 5);
+            while (grid[droplets[i].row][droplets[i].column] == -1) {
+              droplets[i].column = random(0, 5);
+            }
+          }
+        }
+
+        // Check if droplet has reached the bottom row
+        if (droplets[i].row >= 5) {  // Assuming grid rows are 0-4
+          droplets[i].row = -1;      // Deactivate droplet
+          droplets[i].color = 0;     // Reset color
+          dropletCount--;            // Decrement droplet count
+        }
+      }
+    }
+  }
+}
+
+// Function to display droplets on the specified grid
+void displayDroplets(Droplet droplets[], int dropletCount, const int grid[5][5]) {
+  // Clear all pixels in the grid before updating
+  for (int row = 0; row < 5; row++) {
+    for (int col = 0; col < 5; col++) {
+      int pixelIndex = grid[row][col];
+      if (pixelIndex != -1) {
+        pixels.setPixelColor(pixelIndex, 0);  // Turn off pixel
+      }
+    }
+  }
+
+  // Light up active droplets
+  for (int i = 0; i < MAX_DROPLETS_PER_GRID; i++) {
+    if (droplets[i].row != -1) {
+      int row = droplets[i].row;
+      int col = droplets[i].column;
+      int pixelIndex = grid[row][col];
+      if (pixelIndex != -1) {
+        pixels.setPixelColor(pixelIndex, droplets[i].color);  // Set droplet color
+      }
+    }
+  }
+
+  // Update the NeoPixel strip to show changes
+  pixels.show();
+}
+
+// Function to get the current color based on colorMode
+uint32_t getColor() {
+  if (colorMode == 0) {
+    // Random color from anywhere in the palette
+    return paletteColor(currentPalette, random(0, 256));
+  } else {
+    // Predefined color from the palette stops
+    uint8_t red = currentPalette.rgb[colorMode - 1][0];
+    uint8_t green = currentPalette.rgb[colorMode - 1][1];
+    uint8_t blue = currentPalette.rgb[colorMode - 1][2];
+    return pixels.Color(red, green, blue);
+  }
+}
+
+void spiralingVortexNeoPixelDemo(Adafruit_NeoPixel &pixels) {
+  Serial.println("Spiraling Vortex NeoPixel Demo. Press LEFT button to exit.");
+  setAnimationPalette(PALETTE_CLASSIC);
+
+  int selectedColorIndex = 0;
+  //  bool rightButtonLastState = HIGH;
+
+  // Variables for right button press detection
+  bool rightButtonPressed = false;
+  unsigned long pressStartTime = 0;
+  bool longPressHandled = false;
+
+  bool rightButtonLastState = HIGH;  // Assume button not pressed (pull-up resistor)
+
+  while (animationRunning()) {
+    Watchdog.reset();
+    paletteTick();
+    unsigned long currentMillis = millis();
+
+    // Check for both buttons pressed
+    if (isBothButtonsPressed()) {
+      handleBothButtonsPressed();
+    }
+
+    // Read the current state of the right button
+    bool rightButtonCurrentState = digitalRead(RIGHT_BUTTON_PIN);
+
+    if (rightButtonLastState == HIGH && rightButtonCurrentState == LOW) {
+      // Button was just pressed
+      delay(50);  // Debounce delay
+      rightButtonCurrentState = digitalRead(RIGHT_BUTTON_PIN);
+      if (rightButtonCurrentState == LOW) {
+        rightButtonPressed = true;
+        pressStartTime = millis();
+        longPressHandled = false;
+        Serial.println("Right button pressed.");
+      }
+    }
+
+    if (rightButtonLastState == LOW && rightButtonCurrentState == HIGH) {
+      // Button was just released
+      if (rightButtonPressed) {
+        unsigned long pressDuration = millis() - pressStartTime;
+        if (pressDuration < SHORT_PRESS_THRESHOLD) {
+          // Short press detected
+          Serial.println("Short press detected. No change for this animation");
+          selectedColorIndex = (selectedColorIndex + 1) % numColors;
+          Serial.print("Color changed to index ");
+          Serial.println(selectedColorIndex);
+        } else if (pressDuration >= LONG_PRESS_THRESHOLD && !longPressHandled) {
+          // Long press detected upon release, only if not handled during holding
+          Serial.println("Long press detected.");
+          handleLongPress(animationIndex);  // Example function
         }
+        rightButtonPressed = false;
+      }
+    }
+
+    // Handle long press if button is still pressed and threshold exceeded
+    if (rightButtonPressed && !longPressHandled) {
+      unsigned long pressDuration = millis() - pressStartTime;
+      if (pressDuration >= LONG_PRESS_THRESHOLD) {
+        longPressHandled = true;
+        Serial.println("Long press detected (while holding).");
+        handleLongPress(animationIndex);  // Example function
       }
     }
+
+    rightButtonLastState = rightButtonCurrentState;
+
+    // Two spiral arms per eye: the arm angle twists further the farther a
+    // pixel sits from its eye center, and the eyes turn in mirror image.
+    // The arms advance one full step every two beats of the beat clock.
+    beatTrackerService();
+    uint8_t phase = beatClockPhase(currentMillis, 2);
+    for (int i = 0; i < NUMPIXELS; i++) {
+      uint8_t arm = pixelMirroredAngle(i) * 2 + pixelDistance(i) * 4 - phase;
+      pixels.setPixelColor(i, paletteStopColor(currentPalette, selectedColorIndex, triangleWave8(arm)));
+    }
+
     pixels.show();
-    delay(FADE_STEP_DELAY_MS);
+    delay(20);
   }
+
+  setAllNeoPixelsColor(pixels, 0);
+  delay(50);
 }
 
+void rippleNeoPixelDemo(Adafruit_NeoPixel &pixels) {
+  Serial.println("Ripple NeoPixel Demo. Press LEFT button to exit.");
+  setAnimationPalette(PALETTE_OCEAN);
 
-///////////////////////////////////////////
+  int selectedColorIndex = 0;
+  int rippleEye = LAYOUT_LEFT_EYE;  // Eye the current ripple starts from
+  int rippleRadius = 0;              // Ring radius in PCB units
 
-// tetris animation function
+  // Variables for right button press detection
+  bool rightButtonPressed = false;
+  unsigned long pressStartTime = 0;
+  bool longPressHandled = false;
 
-///*
-// Tetris animation function
-void tetrisNeoPixelDemo(Adafruit_NeoPixel &pixels) {
-  // Seed random number generator using analogRead(A3)
-  randomSeed(analogRead(A3));
-  Serial.println("Tetris Animation. Press LEFT button to exit.");
+  bool rightButtonLastState = HIGH;  // Assume button not pressed (pull-up resistor)
 
-  // Spawn the first piece
-  spawnNewPiece();
+  while (animationRunning()) {
+    Watchdog.reset();
+    paletteTick();
+    unsigned long currentMillis = millis();
 
-  // Variables for button debouncing
-  // bool rightButtonReading;
-  //  bool rightButtonState = HIGH;       // Debounced button state
-  // bool lastRightButtonState = HIGH;   // Previous debounced button state
-  unsigned long lastDebounceTime = 0;
-  const unsigned long debounceDelay = 50;
+    // Check for both buttons pressed
+    if (isBothButtonsPressed()) {
+      handleBothButtonsPressed();
+    }
+
+    // Read the current state of the right button
+    bool rightButtonCurrentState = digitalRead(RIGHT_BUTTON_PIN);
+
+    if (rightButtonLastState == HIGH && rightButtonCurrentState == LOW) {
+      // Button was just pressed
+      delay(50);  // Debounce delay
+      rightButtonCurrentState = digitalRead(RIGHT_BUTTON_PIN);
+      if (rightButtonCurrentState == LOW) {
+        rightButtonPressed = true;
+        pressStartTime = millis();
+        longPressHandled = false;
+        Serial.println("Right button pressed.");
+      }
+    }
+
+    if (rightButtonLastState == LOW && rightButtonCurrentState == HIGH) {
+      // Button was just released
+      if (rightButtonPressed) {
+        unsigned long pressDuration = millis() - pressStartTime;
+        if (pressDuration < SHORT_PRESS_THRESHOLD) {
+          // Short press detected
+          Serial.println("Short press detected.");
+          selectedColorIndex = (selectedColorIndex + 1) % numColors;
+          Serial.print("Color changed to index ");
+          Serial.println(selectedColorIndex);
+        } else if (pressDuration >= LONG_PRESS_THRESHOLD && !longPressHandled) {
+          // Long press detected upon release, only if not handled during holding
+          Serial.println("Long press detected.");
+          handleLongPress(animationIndex);  // Example function
+        }
+        rightButtonPressed = false;
+      }
+    }
+
+    // Handle long press if button is still pressed and threshold exceeded
+    if (rightButtonPressed && !longPressHandled) {
+      unsigned long pressDuration = millis() - pressStartTime;
+      if (pressDuration >= LONG_PRESS_THRESHOLD) {
+        longPressHandled = true;
+        Serial.println("Long press detected (while holding).");
+        handleLongPress(animationIndex);  // Example function
+      }
+    }
+
+    rightButtonLastState = rightButtonCurrentState;
+
+    // Ring of light spreading out from one eye center, across the other eye
+    // and fading as it grows; the next ripple starts from the other eye
+    uint8_t fade = 255 - min(rippleRadius, 255);
+    for (int i = 0; i < NUMPIXELS; i++) {
+      int offset = abs((int)pixelLayout[i].distance[rippleEye] - rippleRadius);
+      uint8_t level = 0;
+      if (offset < RIPPLE_WIDTH) {
+        level = ((RIPPLE_WIDTH - offset) * fade) / RIPPLE_WIDTH;
+      }
+      pixels.setPixelColor(i, paletteColor(currentPalette, selectedColorIndex * 16 + pixelLayout[i].distance[rippleEye], level));
+    }
+
+    pixels.show();
+    rippleRadius += 4;
+    if (rippleRadius > RIPPLE_MAX_RADIUS) {
+      rippleRadius = 0;
+      rippleEye = (rippleEye == LAYOUT_LEFT_EYE) ? LAYOUT_RIGHT_EYE : LAYOUT_LEFT_EYE;
+    }
+    delay(30);
+  }
+
+  setAllNeoPixelsColor(pixels, 0);
+  delay(50);
+}
 
-  unsigned long previousMillis = 0;
-  const unsigned long interval = 20;  // Update interval for animation
+void radarSweepNeoPixelDemo(Adafruit_NeoPixel &pixels) {
+  Serial.println("Radar Sweep NeoPixel Demo. Press LEFT button to exit.");
+  setAnimationPalette(PALETTE_CLASSIC);
+
+  int selectedColorIndex = 0;
+  uint8_t sweepAngle = 0;  // Angle of the sweep line, 0-255 = one turn
 
   // Variables for right button press detection
   bool rightButtonPressed = false;
@@ -3002,8 +3969,9 @@ void tetrisNeoPixelDemo(Adafruit_NeoPixel &pixels) {
 
   bool rightButtonLastState = HIGH;  // Assume button not pressed (pull-up resistor)
 
-  while (!isLeftButtonPressed() && !animationInterrupted) {
+  while (animationRunning()) {
     Watchdog.reset();
+    paletteTick();
     unsigned long currentMillis = millis();
 
     // Check for both buttons pressed
@@ -3033,7 +4001,9 @@ void tetrisNeoPixelDemo(Adafruit_NeoPixel &pixels) {
         if (pressDuration < SHORT_PRESS_THRESHOLD) {
           // Short press detected
           Serial.println("Short press detected.");
-          rotatePiece();
+          selectedColorIndex = (selectedColorIndex + 1) % numColors;
+          Serial.print("Color changed to index ");
+          Serial.println(selectedColorIndex);
         } else if (pressDuration >= LONG_PRESS_THRESHOLD && !longPressHandled) {
           // Long press detected upon release, only if not handled during holding
           Serial.println("Long press detected.");
@@ -3055,170 +4025,28 @@ void tetrisNeoPixelDemo(Adafruit_NeoPixel &pixels) {
 
     rightButtonLastState = rightButtonCurrentState;
 
-    // Move the piece down at regular intervals
-    if (currentMillis - lastFallTime >= FALL_SPEED_MS) {
-      lastFallTime = currentMillis;
-
-      // Move the piece down
-      pieceY += 1;
-
-      // If the piece has moved beyond the grid, spawn a new piece
-      if (pieceY > GRID_HEIGHT) {
-        spawnNewPiece();
-      }
-    }
-
-    // Draw the current piece
-    drawCurrentPiece();
-
-    // Small delay to prevent CPU hogging
-    delay(1);
-  }
-
-  // Turn off all pixels after exiting
-  clearDisplay();
-  pixels.show();
-  delay(50);  // Debounce delay
-}
-
-//*/
-
-// ---------------------------
-// Function Definitions
-// ---------------------------
-
-// Spawn a new random tetromino
-void spawnNewPiece() {
-  int index = random(0, NUM_TETROMINOES);
-
-  // Copy the shape
-  copyShape(currentPiece.shape, tetrominoShapes[index]);
-
-  // Set the color
-  currentPiece.color = tetrominoColors[index];
-
-  // Reset position
-  pieceX = 1;   // Start near the middle
-  pieceY = -4;  // Start above the grid
-
-  // Reset rotation state
-  currentPiece.rotationState = 0;
-
-  // Serial.print("Spawned New Piece Index: ");
-  // Serial.println(index);
-}
-
-// Rotate the current piece
-void rotatePiece() {
-  // Update rotation state
-  currentPiece.rotationState = (currentPiece.rotationState + 1) % 4;
-  // Serial.print("Rotation State: ");
-  // Serial.println(currentPiece.rotationState);
-}
-
-// Draw the current piece on the NeoPixel grids
-void drawCurrentPiece() {
-  // Clear the display
-  clearDisplay();
-
-  // Create a temporary shape to hold the rotated shape
-  int rotatedShape[4][4];
-  copyShape(rotatedShape, currentPiece.shape);
-  rotateShape(rotatedShape, currentPiece.rotationState);
-
-  // Draw current piece
-  for (int y = 0; y < 4; y++) {
-    for (int x = 0; x < 4; x++) {
-      if (rotatedShape[y][x]) {
-        int gridX = pieceX + x;
-        int gridY = pieceY + y;
-        if (gridY >= 0 && gridY < GRID_HEIGHT && gridX >= 0 && gridX < GRID_WIDTH) {
-          int leftPixelIndex = leftGrid[gridY][gridX];
-          int rightPixelIndex = rightGrid[gridY][gridX];
-          if (leftPixelIndex != -1) {
-            pixels.setPixelColor(leftPixelIndex, currentPiece.color);
-          }
-          if (rightPixelIndex != -1) {
-            pixels.setPixelColor(rightPixelIndex, currentPiece.color);
-          }
-        }
-      }
+    // Sweep line turning around each eye center with a fading trail behind it
+    for (int i = 0; i < NUMPIXELS; i++) {
+      uint8_t behind = sweepAngle - pixelMirroredAngle(i);  // How far the sweep has passed this pixel
+      uint8_t level = (behind < RADAR_TRAIL) ? 255 - (behind * 255) / RADAR_TRAIL : 0;
+      pixels.setPixelColor(i, paletteStopColor(currentPalette, selectedColorIndex, level));
     }
-  }
-
-  // Update the NeoPixel strip to show changes
-  pixels.show();
-}
-
-// Clear the display
-void clearDisplay() {
-  pixels.clear();
-}
 
-// Copy a shape from src to dest
-void copyShape(int dest[4][4], const int src[4][4]) {
-  for (int y = 0; y < 4; y++) {
-    for (int x = 0; x < 4; x++) {
-      dest[y][x] = src[y][x];
-    }
+    pixels.show();
+    sweepAngle += 4;
+    delay(20);
   }
-}
-
-// Rotate the shape based on rotation state
-void rotateShape(int shape[4][4], int rotationState) {
-  int temp[4][4];
 
-  // Apply rotation the number of times specified by rotationState
-  for (int i = 0; i < rotationState; i++) {
-    // Rotate the shape 90 degrees clockwise
-    for (int y = 0; y < 4; y++) {
-      for (int x = 0; x < 4; x++) {
-        temp[y][x] = shape[3 - x][y];
-      }
-    }
-    // Copy temp back to shape
-    for (int y = 0; y < 4; y++) {
-      for (int x = 0; x < 4; x++) {
-        shape[y][x] = temp[y][x];
-      }
-    }
-  }
+  setAllNeoPixelsColor(pixels, 0);
+  delay(50);
 }
 
-
-// Falling Drops animation function
-void fallingDropsNeoPixelDemo(Adafruit_NeoPixel &pixels) {
-  Serial.println("Falling Drops Animation. Press LEFT button to exit.");
-
-  // Droplet Arrays for Grids
-  Droplet dropletsLeft[MAX_DROPLETS_PER_GRID];
-  int dropletCountLeft = 0;
-
-  Droplet dropletsRight[MAX_DROPLETS_PER_GRID];
-  int dropletCountRight = 0;
-
-  // Color Selection Variables
-  int colorMode = 0;  // 0 = Random, 1-10 = colorArray[0-9]
-
-  // Variables for Button Debouncing
-  // bool rightButtonLastState = HIGH;
-  unsigned long lastDebounceTime = 0;
-  const unsigned long debounceDelay = 50;
-
-  // Initialize Droplet arrays for Left and Right grids
-  for (int i = 0; i < MAX_DROPLETS_PER_GRID; i++) {
-    // Left Grid Droplets
-    dropletsLeft[i].row = -1;  // Inactive
-
-    // Right Grid Droplets
-    dropletsRight[i].row = -1;  // Inactive
-  }
-
-  // Seed random number generator for randomized colors and positions
-  randomSeed(analogRead(A3));
+void lavaNeoPixelDemo(Adafruit_NeoPixel &pixels) {
+  Serial.println("Lava NeoPixel Demo. Press LEFT button to exit.");
+  setAnimationPalette(PALETTE_LAVA);
 
   unsigned long previousMillis = 0;
-  const unsigned long interval = 20;  // Update interval for animation
+  uint32_t t = 0;  // Noise time; 32 bits so the slower t >> n axes wrap smoothly too
 
   // Variables for right button press detection
   bool rightButtonPressed = false;
@@ -3227,8 +4055,9 @@ void fallingDropsNeoPixelDemo(Adafruit_NeoPixel &pixels) {
 
   bool rightButtonLastState = HIGH;  // Assume button not pressed (pull-up resistor)
 
-  while (!isLeftButtonPressed() && !animationInterrupted) {
+  while (animationRunning()) {
     Watchdog.reset();
+    paletteTick();
     unsigned long currentMillis = millis();
 
     // Check for both buttons pressed
@@ -3257,9 +4086,7 @@ void fallingDropsNeoPixelDemo(Adafruit_NeoPixel &pixels) {
         unsigned long pressDuration = millis() - pressStartTime;
         if (pressDuration < SHORT_PRESS_THRESHOLD) {
           // Short press detected
-          Serial.println("Short press detected.");
-          // Cycle colorMode
-          colorMode = (colorMode + 1) % (numColors + 1);  // 0 to numColors
+          Serial.println("Short press detected. No change for this animation");
         } else if (pressDuration >= LONG_PRESS_THRESHOLD && !longPressHandled) {
           // Long press detected upon release, only if not handled during holding
           Serial.println("Long press detected.");
@@ -3281,229 +4108,124 @@ void fallingDropsNeoPixelDemo(Adafruit_NeoPixel &pixels) {
 
     rightButtonLastState = rightButtonCurrentState;
 
-    if (currentMillis - previousMillis >= interval) {
+    if (currentMillis - previousMillis >= NOISE_FRAME_MS) {
       previousMillis = currentMillis;
 
-      // Create new droplets for Left Grid
-      if (dropletCountLeft < MAX_DROPLETS_PER_GRID) {
-        createDroplet(dropletsLeft, dropletCountLeft, leftGrid);
-      }
-
-      // Create new droplets for Right Grid
-      if (dropletCountRight < MAX_DROPLETS_PER_GRID) {
-        createDroplet(dropletsRight, dropletCountRight, rightGrid);
+      // Slow two-octave blobs drifting upwards
+      for (int i = 0; i < NUMPIXELS; i++) {
+        uint16_t nx = (pixelLayout[i].x + 128) * 5;
+        uint16_t ny = (pixelLayout[i].y + 128) * 5 + (uint16_t)t;
+        uint8_t heat = fractalNoise3D(nx, ny, (uint16_t)(t >> 1), 2);
+        pixels.setPixelColor(i, paletteColor(currentPalette, heat, 255, false));
       }
-
-      // Update droplet positions for Left Grid
-      updateDroplets(dropletsLeft, dropletCountLeft, leftGrid);
-
-      // Update droplet positions for Right Grid
-      updateDroplets(dropletsRight, dropletCountRight, rightGrid);
-
-      // Display droplets on Left Grid
-      displayDroplets(dropletsLeft, dropletCountLeft, leftGrid);
-
-      // Display droplets on Right Grid
-      displayDroplets(dropletsRight, dropletCountRight, rightGrid);
+      pixels.show();
+      t += 6;
     }
-
-    // Small delay to prevent CPU hogging
     delay(1);
   }
-
-  // Turn off all pixels after exiting
-  setAllNeoPixelsColor(pixels, 0);
-  pixels.show();
-  delay(50);  // Debounce delay
-}
-
-// ---------------------------
-// Function Definitions
-// ---------------------------
-
-// Function to create a new droplet in the specified grid
-void createDroplet(Droplet droplets[], int &dropletCount, const int grid[5][5]) {
-  // Find an inactive droplet slot
-  for (int i = 0; i < MAX_DROPLETS_PER_GRID; i++) {
-    if (droplets[i].row == -1) {
-      droplets[i].row = 0;  // Start at top row (y=0)
-
-      // Assign a random column within the grid based on row
-      // y=0: columns 1-3
-      // y=1-3: columns 0-4
-      if (droplets[i].row == 0) {
-        droplets[i].column = random(1, 4);  // Columns 1, 2, 3
-      } else {
-        droplets[i].column = random(0, 5);  // Columns 0-4
-      }
-
-      // Ensure the assigned column has a valid pixel in the current row
-      if (grid[droplets[i].row][droplets[i].column] == -1) {
-        // If invalid, assign to a valid column within the row
-        if (droplets[i].row == 0) {
-          droplets[i].column = random(1, 4);  // y=0: Columns 1-3
-        } else {
-          droplets[i].column = random(0, 5);  // y=1-3: Columns 0-4
-        }
-
-        // Recheck and assign again if necessary
-        while (grid[droplets[i].row][droplets[i].column] == -1) {
-          if (droplets[i].row == 0) {
-            droplets[i].column = random(1, 4);
-          } else {
-            droplets[i].column = random(0, 5);
-          }
-        }
-      }
-
-      // Assign color based on current colorMode
-      droplets[i].color = getColor();
-
-      // Set fixed speed
-      droplets[i].speed = DROPLET_SPEED_MS;
-
-      // Update the lastUpdate timestamp
-      droplets[i].lastUpdate = millis();
-
-      // Increment droplet count
-      dropletCount++;
-
-      break;  // Exit after creating one droplet
-    }
-  }
+
+  setAllNeoPixelsColor(pixels, 0);
+  delay(50);
 }
 
-// Function to update droplet positions in the specified grid
-void updateDroplets(Droplet droplets[], int &dropletCount, const int grid[5][5]) {
-  unsigned long currentTime = millis();
+void fogNeoPixelDemo(Adafruit_NeoPixel &pixels) {
+  Serial.println("Fog NeoPixel Demo. Press LEFT button to exit.");
+  setAnimationPalette(PALETTE_CLASSIC);
 
-  for (int i = 0; i < MAX_DROPLETS_PER_GRID; i++) {
-    if (droplets[i].row != -1) {  // Active droplet
-      if (currentTime - droplets[i].lastUpdate >= droplets[i].speed) {
-        droplets[i].row += 1;                  // Move droplet down by one row
-        droplets[i].lastUpdate = currentTime;  // Reset the lastUpdate timestamp
+  int selectedColorIndex = 8;  // Start on white
+  unsigned long previousMillis = 0;
+  uint32_t t = 0;              // Noise time; 32 bits so the slower t >> n axes wrap smoothly too
 
-        // Assign a new column if the droplet is now in y=1,2,3
-        if (droplets[i].row >= 1 && droplets[i].row <= 3) {
-          droplets[i].column = random(0, 5);  // Columns 0-4
+  // Variables for right button press detection
+  bool rightButtonPressed = false;
+  unsigned long pressStartTime = 0;
+  bool longPressHandled = false;
 
-          // Ensure the new column has a valid pixel in the current row
-          if (grid[droplets[i].row][droplets[i].column] == -1) {
-            // If invalid, assign to a valid column within the row
-            droplets[i].column = random(0, 5);
-            while (grid[droplets[i].row][droplets[i].column] == -1) {
-              droplets[i].column = random(0, 5);
-            }
-          }
-        }
+  bool rightButtonLastState = HIGH;  // Assume button not pressed (pull-up resistor)
 
-        // Check if droplet has reached the bottom row
-        if (droplets[i].row >= 5) {  // Assuming grid rows are 0-4
-          droplets[i].row = -1;      // Deactivate droplet
-          droplets[i].color = 0;     // Reset color
-          dropletCount--;            // Decrement droplet count
-        }
-      }
+  while (animationRunning()) {
+    Watchdog.reset();
+    paletteTick();
+    unsigned long currentMillis = millis();
+
+    // Check for both buttons pressed
+    if (isBothButtonsPressed()) {
+      handleBothButtonsPressed();
     }
-  }
-}
 
-// Function to display droplets on the specified grid
-void displayDroplets(Droplet droplets[], int dropletCount, const int grid[5][5]) {
-  // Clear all pixels in the grid before updating
-  for (int row = 0; row < 5; row++) {
-    for (int col = 0; col < 5; col++) {
-      int pixelIndex = grid[row][col];
-      if (pixelIndex != -1) {
-        pixels.setPixelColor(pixelIndex, 0);  // Turn off pixel
+    // Read the current state of the right button
+    bool rightButtonCurrentState = digitalRead(RIGHT_BUTTON_PIN);
+
+    if (rightButtonLastState == HIGH && rightButtonCurrentState == LOW) {
+      // Button was just pressed
+      delay(50);  // Debounce delay
+      rightButtonCurrentState = digitalRead(RIGHT_BUTTON_PIN);
+      if (rightButtonCurrentState == LOW) {
+        rightButtonPressed = true;
+        pressStartTime = millis();
+        longPressHandled = false;
+        Serial.println("Right button pressed.");
       }
     }
-  }
 
-  // Light up active droplets
-  for (int i = 0; i < MAX_DROPLETS_PER_GRID; i++) {
-    if (droplets[i].row != -1) {
-      int row = droplets[i].row;
-      int col = droplets[i].column;
-      int pixelIndex = grid[row][col];
-      if (pixelIndex != -1) {
-        pixels.setPixelColor(pixelIndex, droplets[i].color);  // Set droplet color
+    if (rightButtonLastState == LOW && rightButtonCurrentState == HIGH) {
+      // Button was just released
+      if (rightButtonPressed) {
+        unsigned long pressDuration = millis() - pressStartTime;
+        if (pressDuration < SHORT_PRESS_THRESHOLD) {
+          // Short press detected
+          Serial.println("Short press detected.");
+          selectedColorIndex = (selectedColorIndex + 1) % numColors;
+          Serial.print("Color changed to index ");
+          Serial.println(selectedColorIndex);
+        } else if (pressDuration >= LONG_PRESS_THRESHOLD && !longPressHandled) {
+          // Long press detected upon release, only if not handled during holding
+          Serial.println("Long press detected.");
+          handleLongPress(animationIndex);  // Example function
+        }
+        rightButtonPressed = false;
       }
     }
-  }
 
-  // Update the NeoPixel strip to show changes
-  pixels.show();
-}
+    // Handle long press if button is still pressed and threshold exceeded
+    if (rightButtonPressed && !longPressHandled) {
+      unsigned long pressDuration = millis() - pressStartTime;
+      if (pressDuration >= LONG_PRESS_THRESHOLD) {
+        longPressHandled = true;
+        Serial.println("Long press detected (while holding).");
+        handleLongPress(animationIndex);  // Example function
+      }
+    }
 
-// Function to get the current color based on colorMode
-uint32_t getColor() {
-  if (colorMode == 0) {
-    // Random color
-    uint16_t hue = random(0, 65535);  // Random hue
-    return ColorHSV(hue, 255, 255);   // Full saturation and brightness
-  } else {
-    // Predefined color from colorArray
-    uint8_t red = colorArray[colorMode - 1][0];
-    uint8_t green = colorArray[colorMode - 1][1];
-    uint8_t blue = colorArray[colorMode - 1][2];
-    return pixels.Color(red, green, blue);
-  }
-}
+    rightButtonLastState = rightButtonCurrentState;
 
-// Helper function to convert HSV to RGB
-uint32_t ColorHSV(long hue, uint8_t sat, uint8_t val) {
-  // Hue: 0-65535, Saturation: 0-255, Value: 0-255
-  uint16_t region = hue / (65535 / 6);
-  uint8_t remainder = (hue % (65535 / 6)) * 255 / (65535 / 6);
-  uint8_t p = (val * (255 - sat)) / 255;
-  uint8_t q = (val * (255 - ((sat * remainder) / 255))) / 255;
-  uint8_t t = (val * (255 - ((sat * (255 - remainder)) / 255))) / 255;
-  uint8_t r, g, b;
+    if (currentMillis - previousMillis >= NOISE_FRAME_MS) {
+      previousMillis = currentMillis;
 
-  switch (region) {
-    case 0:
-      r = val;
-      g = t;
-      b = p;
-      break;
-    case 1:
-      r = q;
-      g = val;
-      b = p;
-      break;
-    case 2:
-      r = p;
-      g = val;
-      b = t;
-      break;
-    case 3:
-      r = p;
-      g = q;
-      b = val;
-      break;
-    case 4:
-      r = t;
-      g = p;
-      b = val;
-      break;
-    case 5:
-    default:
-      r = val;
-      g = p;
-      b = q;
-      break;
+      // Soft, low-contrast patches rolling sideways across both eyes
+      for (int i = 0; i < NUMPIXELS; i++) {
+        uint16_t nx = (pixelLayout[i].x + 128) * 3 + (uint16_t)t;
+        uint16_t ny = (pixelLayout[i].y + 128) * 3;
+        uint8_t density = fractalNoise3D(nx, ny, (uint16_t)(t >> 2), 3);
+        uint8_t level = 24 + (density * 3) / 4;
+        pixels.setPixelColor(i, paletteStopColor(currentPalette, selectedColorIndex, level));
+      }
+      pixels.show();
+      t += 4;
+    }
+    delay(1);
   }
 
-  return pixels.Color(r, g, b);
+  setAllNeoPixelsColor(pixels, 0);
+  delay(50);
 }
 
-void spiralingVortexNeoPixelDemo(Adafruit_NeoPixel &pixels) {
-  Serial.println("Spiraling Vortex NeoPixel Demo. Press LEFT button to exit.");
+void auroraNeoPixelDemo(Adafruit_NeoPixel &pixels) {
+  Serial.println("Aurora NeoPixel Demo. Press LEFT button to exit.");
+  setAnimationPalette(PALETTE_AURORA);
 
-  int selectedColorIndex = 0;
-  //  bool rightButtonLastState = HIGH;
-  int radius = 0;
+  unsigned long previousMillis = 0;
+  uint32_t t = 0;  // Noise time; 32 bits so the slower t >> n axes wrap smoothly too
 
   // Variables for right button press detection
   bool rightButtonPressed = false;
@@ -3512,8 +4234,9 @@ void spiralingVortexNeoPixelDemo(Adafruit_NeoPixel &pixels) {
 
   bool rightButtonLastState = HIGH;  // Assume button not pressed (pull-up resistor)
 
-  while (!isLeftButtonPressed() && !animationInterrupted) {
+  while (animationRunning()) {
     Watchdog.reset();
+    paletteTick();
     unsigned long currentMillis = millis();
 
     // Check for both buttons pressed
@@ -3543,9 +4266,6 @@ void spiralingVortexNeoPixelDemo(Adafruit_NeoPixel &pixels) {
         if (pressDuration < SHORT_PRESS_THRESHOLD) {
           // Short press detected
           Serial.println("Short press detected. No change for this animation");
-          selectedColorIndex = (selectedColorIndex + 1) % numColors;
-          Serial.print("Color changed to index ");
-          Serial.println(selectedColorIndex);
         } else if (pressDuration >= LONG_PRESS_THRESHOLD && !longPressHandled) {
           // Long press detected upon release, only if not handled during holding
           Serial.println("Long press detected.");
@@ -3567,20 +4287,23 @@ void spiralingVortexNeoPixelDemo(Adafruit_NeoPixel &pixels) {
 
     rightButtonLastState = rightButtonCurrentState;
 
-    uint8_t red = colorArray[selectedColorIndex][0];
-    uint8_t green = colorArray[selectedColorIndex][1];
-    uint8_t blue = colorArray[selectedColorIndex][2];
-
-    setAllNeoPixelsColor(pixels, 0);
+    if (currentMillis - previousMillis >= NOISE_FRAME_MS) {
+      previousMillis = currentMillis;
 
-    for (int i = 0; i < radius; i++) {
-      int pixelIndex = (i * 7 + radius) % pixels.numPixels();  // Spiral pattern
-      pixels.setPixelColor(pixelIndex, pixels.Color(red, green, blue));
+      // Vertical curtains: brightness varies across x and time, barely with y,
+      // while the color wanders more slowly through the palette
+      for (int i = 0; i < NUMPIXELS; i++) {
+        uint16_t nx = (pixelLayout[i].x + 128) * 6;
+        uint16_t ny = (pixelLayout[i].y + 128);
+        uint8_t curtain = noise3D(nx, ny, (uint16_t)t);
+        uint8_t level = triangleWave8(curtain);
+        uint8_t hue = fractalNoise3D(nx >> 1, ny * 2, (uint16_t)(t >> 2), 2);
+        pixels.setPixelColor(i, paletteColor(currentPalette, hue, level, false));
+      }
+      pixels.show();
+      t += 10;
     }
-
-    pixels.show();
-    radius = (radius + 1) % pixels.numPixels();
-    delay(100);
+    delay(1);
   }
 
   setAllNeoPixelsColor(pixels, 0);
@@ -3591,8 +4314,305 @@ void neopixelsOff(Adafruit_NeoPixel &pixels) {
   setAllNeoPixelsColor(pixels, 0);  // Turn off all NeoPixels
 }
 
+// Animation to return to once the microphone calibration finishes
+static void (*calibrationReturnAnimation)(Adafruit_NeoPixel &) = NULL;
+
+// Run the microphone calibration in place of the current animation
+void startMicCalibration() {
+  if (currentAnimation != microphoneCalibration) {
+    calibrationReturnAnimation = currentAnimation;
+  }
+  currentAnimation = microphoneCalibration;
+  animationInterrupted = true;
+}
+
+// Guided calibration: blue while it listens to the quiet room, green while
+// it listens to loud sound (music, clapping). The average quiet loudness is
+// the noise floor, the loudest stretch of the second phase sets the range.
+void microphoneCalibration(Adafruit_NeoPixel &pixels) {
+  Serial.println("Microphone calibration. Stay quiet while the eyes are blue. Press LEFT button to cancel.");
+
+  uint32_t quietSum = 0;
+  uint16_t quietBlocks = 0;
+  uint16_t loudest = 0;
+  uint32_t recent = 0;  // Loudness smoothed over ~4 blocks, 8.8 scaled by 4
+  bool completed = false;
+
+  setAllNeoPixelsColor(pixels, pixels.Color(0, 0, 64));
+  unsigned long phaseStart = millis();
+  bool loudPhase = false;
+  audioCaptureEnableGestures(false);  // Clapping here should not draw a card
+
+  while (animationRunning()) {
+    Watchdog.reset();
+
+    // Meter loudness of the newest capture block
+    uint16_t loudness = audioCaptureLoudness();
+
+    if (!loudPhase) {
+      quietSum += loudness;
+      quietBlocks++;
+      if (millis() - phaseStart >= MIC_CALIBRATION_PHASE_MS) {
+        Serial.println("Now make some noise while the eyes are green.");
+        setAllNeoPixelsColor(pixels, pixels.Color(0, 64, 0));
+        loudPhase = true;
+        phaseStart = millis();
+      }
+    } else {
+      recent += loudness - (recent >> 2);
+      if ((recent >> 2) > loudest) {
+        loudest = recent >> 2;
+      }
+      if (millis() - phaseStart >= MIC_CALIBRATION_PHASE_MS) {
+        completed = true;
+        break;
+      }
+    }
+    delay(4);  // One capture block
+  }
+
+  audioCaptureEnableGestures(true);
+
+  if (completed && quietBlocks > 0) {
+    uint16_t noiseFloor = quietSum / quietBlocks;
+    int calibration = micCalibrationPack(noiseFloor, loudest);
+    Serial.print("Microphone noise floor ");
+    Serial.print(noiseFloor);
+    Serial.print(", loud level ");
+    Serial.println(loudest);
+
+    updateConfigParameterInt("mic_calibration", calibration);
+    currentConfig.mic_calibration = calibration;
+    applyMicCalibration(calibration);
+  } else {
+    Serial.println("Microphone calibration cancelled.");
+  }
+
+  // Hand the eyes back unless another command already switched animations
+  if (!animationInterrupted && currentAnimation == microphoneCalibration) {
+    currentAnimation = (calibrationReturnAnimation != NULL) ? calibrationReturnAnimation : neopixelsOff;
+  }
+
+  setAllNeoPixelsColor(pixels, 0);
+  delay(50);
+}
+
+// Animation to return to once the accelerometer calibration finishes
+static void (*accelCalibrationReturnAnimation)(Adafruit_NeoPixel &) = NULL;
+
+// Run the accelerometer calibration in place of the current animation
+void startAccelCalibration() {
+  if (currentAnimation != accelerometerCalibration) {
+    accelCalibrationReturnAnimation = currentAnimation;
+  }
+  currentAnimation = accelerometerCalibration;
+  animationInterrupted = true;
+}
+
+// True when a raw sample looks like the pose asked for: flat face up
+// (phase 0) or standing on any side edge (phase 1)
+static bool accelPoseMatches(uint8_t phase, const MotionSample &sample) {
+  const int16_t square = MOTION_COUNTS_PER_G - MOTION_POSE_TOLERANCE;
+  if (phase == 0) {
+    return sample.z > square;
+  }
+  return abs(sample.x) > square || abs(sample.y) > square;
+}
+
+// Guided calibration: hold the card flat, face up, while the eyes are blue,
+// then stand it on an edge while they are green. The eyes brighten while a
+// pose is being held still; each is averaged for ACCEL_CALIBRATION_HOLD_MS.
+// Offsets and scale are saved to accel_calibration in one write and applied
+// to the capture, so every accelerometer consumer sees the corrected counts.
+void accelerometerCalibration(Adafruit_NeoPixel &pixels) {
+  Serial.println("Accelerometer calibration. Hold the card flat, face up, while the eyes are blue. Press LEFT button to cancel.");
+
+  // Let go of the buttons first; the left one would cancel straight away
+  setAllNeoPixelsColor(pixels, pixels.Color(16, 16, 16));
+  while (digitalRead(LEFT_BUTTON_PIN) == LOW || digitalRead(RIGHT_BUTTON_PIN) == LOW) {
+    Watchdog.reset();
+    delay(10);
+  }
+  delay(50);
+
+  // Measure raw counts; gestures would fire as the card is turned over
+  motionCaptureSetCalibration(0, 0, 0, 0);
+  motionCaptureEnableGestures(false);
+
+  const uint16_t holdSamples = ACCEL_CALIBRATION_HOLD_MS * MOTION_SAMPLE_RATE / 1000;
+  int16_t means[2][3];
+  uint8_t phase = 0;
+  bool holding = false;
+  bool completed = false;
+  MotionPoseAverage pose;
+  motionPoseReset(pose);
+  uint32_t cursor = motionCaptureSamplesWritten();
+  unsigned long started = millis();
+
+  setAllNeoPixelsColor(pixels, pixels.Color(0, 0, 16));
+
+  while (animationRunning()) {
+    Watchdog.reset();
+
+    if (millis() - started >= ACCEL_CALIBRATION_TIMEOUT_MS) {
+      Serial.println("Accelerometer calibration timed out.");
+      break;
+    }
+
+    MotionSample sample;
+    while (motionCaptureRead(sample, cursor)) {
+      int16_t counts[3] = { sample.x, sample.y, sample.z };
+      motionPoseAdd(pose, counts);
+      if (!accelPoseMatches(phase, sample) || !motionPoseSteady(pose)) {
+        motionPoseReset(pose);  // Moved or not in the pose yet: start the average again
+      }
+    }
+
+    // Brighter while a pose is being held
+    bool nowHolding = pose.count > 0;
+    if (nowHolding != holding) {
+      holding = nowHolding;
+      uint8_t level = holding ? 64 : 16;
+      setAllNeoPixelsColor(pixels, phase == 0 ? pixels.Color(0, 0, level) : pixels.Color(0, level, 0));
+    }
+
+    if (pose.count >= holdSamples) {
+      motionPoseMean(pose, means[phase]);
+      motionPoseReset(pose);
+      holding = false;
+      if (phase == 0) {
+        Serial.println("Now stand the card on one of its edges while the eyes are green.");
+        setAllNeoPixelsColor(pixels, pixels.Color(0, 16, 0));
+        phase = 1;
+      } else {
+        completed = true;
+        break;
+      }
+    }
+    delay(10);
+  }
+
+  MotionCalibration calibration;
+  if (completed && motionCalibrationSolve(means[0], means[1], calibration)) {
+    Serial.print("Accelerometer offsets x=");
+    Serial.print(calibration.offset[0]);
+    Serial.print(" y=");
+    Serial.print(calibration.offset[1]);
+    Serial.print(" z=");
+    Serial.print(calibration.offset[2]);
+    Serial.print(", ");
+    Serial.print(calibration.scale);
+    Serial.println(" counts per g");
+
+    // One save for all four values
+    DynamicJsonDocument tempDoc(256);
+    JsonObject accelCal = tempDoc.createNestedObject("accel_calibration");
+    accelCal["x"] = calibration.offset[0];
+    accelCal["y"] = calibration.offset[1];
+    accelCal["z"] = calibration.offset[2];
+    accelCal["scale"] = calibration.scale;
+    JsonVariant variant = tempDoc["accel_calibration"];
+    if (!configManager.updateConfig("accel_calibration", variant)) {
+      Serial.println(F("Failed to update 'accel_calibration'."));
+    }
+    currentConfig.accel_calibration.x = calibration.offset[0];
+    currentConfig.accel_calibration.y = calibration.offset[1];
+    currentConfig.accel_calibration.z = calibration.offset[2];
+    currentConfig.accel_calibration.scale = calibration.scale;
+    setAllNeoPixelsColor(pixels, pixels.Color(0, 64, 0));
+  } else {
+    if (completed) {
+      Serial.println("Accelerometer calibration failed: the card was not held square.");
+      setAllNeoPixelsColor(pixels, pixels.Color(64, 0, 0));
+    } else {
+      Serial.println("Accelerometer calibration cancelled.");
+    }
+  }
+
+  // Back to the stored (possibly new) calibration
+  applyAccelCalibration(currentConfig.accel_calibration.x,
+                        currentConfig.accel_calibration.y,
+                        currentConfig.accel_calibration.z,
+                        currentConfig.accel_calibration.scale);
+  motionCaptureEnableGestures(true);
+  delay(500);
+
+  // Hand the eyes back unless another command already switched animations
+  if (!animationInterrupted && currentAnimation == accelerometerCalibration) {
+    currentAnimation = (accelCalibrationReturnAnimation != NULL) ? accelCalibrationReturnAnimation : neopixelsOff;
+  }
+
+  setAllNeoPixelsColor(pixels, 0);
+  delay(50);
+}
+
+// Animation to return to once a host message has scrolled past
+static void (*messageReturnAnimation)(Adafruit_NeoPixel &) = NULL;
+
+// Load a message received from the host and hand the eyes to the scroller
+void showHostMessage(const uint8_t* text, int length) {
+  char message[MAX_SCROLL_TEXT_LENGTH + 1];
+  int messageLength = min(length, MAX_SCROLL_TEXT_LENGTH);
+  for (int i = 0; i < messageLength; i++) {
+    message[i] = (char)text[i];
+  }
+  message[messageLength] = '\0';
+
+  scrollerSetText(message, 0);
+  // Give each glyph the next color from the classic palette
+  Palette16 messagePalette;
+  loadPalette(messagePalette, PALETTE_CLASSIC);
+  for (int i = 0; i < messageLength; i++) {
+    scrollerSetGlyphColor(i, paletteStopColor(messagePalette, i));
+  }
+
+  if (currentAnimation != textScrollerNeoPixelDemo) {
+    messageReturnAnimation = currentAnimation;
+  }
+  currentAnimation = textScrollerNeoPixelDemo;
+  animationInterrupted = true;
+}
+
+// Text Scroller: scrolls the loaded message once, then resumes the previous animation
+void textScrollerNeoPixelDemo(Adafruit_NeoPixel &pixels) {
+  Serial.println("Text Scroller. Press LEFT button to exit.");
+
+  unsigned long previousMillis = 0;
+
+  setAllNeoPixelsColor(pixels, 0);
+
+  while (animationRunning()) {
+    Watchdog.reset();
+    unsigned long currentMillis = millis();
+
+    // Check for both buttons pressed
+    if (isBothButtonsPressed()) {
+      handleBothButtonsPressed();
+    }
+
+    if (currentMillis - previousMillis >= SCROLL_STEP_MS) {
+      previousMillis = currentMillis;
+
+      if (!scrollerStep(pixels)) {
+        break;  // Message has scrolled off the canvas
+      }
+    }
+
+    delay(1);
+  }
+
+  // Hand the eyes back unless another command already switched animations
+  if (!animationInterrupted && currentAnimation == textScrollerNeoPixelDemo) {
+    currentAnimation = (messageReturnAnimation != NULL) ? messageReturnAnimation : neopixelsOff;
+  }
+
+  setAllNeoPixelsColor(pixels, 0);
+  delay(50);
+}
+
 void theaterMarqueeNeoPixelDemo(Adafruit_NeoPixel &pixels) {
   Serial.println("Theater Marquee NeoPixel Demo. Press LEFT button to exit.");
+  setAnimationPalette(PALETTE_CLASSIC);
   Watchdog.reset();
   int selectedColorIndex = 0;
   // Variables for right button press detection
@@ -3602,8 +4622,9 @@ void theaterMarqueeNeoPixelDemo(Adafruit_NeoPixel &pixels) {
 
   bool rightButtonLastState = HIGH;  // Assume button not pressed (pull-up resistor)
 
-  while (!isLeftButtonPressed() && !animationInterrupted) {
+  while (animationRunning()) {
     Watchdog.reset();
+    paletteTick();
     unsigned long currentMillis = millis();
 
     // Check for both buttons pressed
@@ -3657,29 +4678,22 @@ void theaterMarqueeNeoPixelDemo(Adafruit_NeoPixel &pixels) {
 
     rightButtonLastState = rightButtonCurrentState;
 
-    uint8_t red = colorArray[selectedColorIndex][0];
-    uint8_t green = colorArray[selectedColorIndex][1];
-    uint8_t blue = colorArray[selectedColorIndex][2];
+    // Chase moves on every eighth note and each light decays through its step
+    beatTrackerService();
+    uint8_t beatPhase = beatClockBeatPhase(currentMillis);
+    uint32_t step = beatClockBeatCount(currentMillis) * 2 + beatPhase / 128;
+    uint8_t level = 255 - (beatPhase & 0x7F);
+    uint32_t color = paletteStopColor(currentPalette, selectedColorIndex, level);
 
     for (int i = 0; i < pixels.numPixels(); i++) {
-      if (i % 3 == 0) {
-        pixels.setPixelColor(i, pixels.Color(red, green, blue));
+      if ((i + step) % 3 == 0) {
+        pixels.setPixelColor(i, color);
       } else {
         pixels.setPixelColor(i, 0);
       }
     }
     pixels.show();
-    delay(100);
-
-    for (int i = 0; i < pixels.numPixels(); i++) {
-      if ((i + 1) % 3 == 0) {
-        pixels.setPixelColor(i, pixels.Color(red, green, blue));
-      } else {
-        pixels.setPixelColor(i, 0);
-      }
-    }
-    pixels.show();
-    delay(100);
+    delay(10);
   }
 
   setAllNeoPixelsColor(pixels, 0);
@@ -7,15 +7,30 @@
 #include <Wire.h>
 #include <Adafruit_NeoPixel.h>
 #include <Adafruit_LIS3DH.h>
-#include <Adafruit_ZeroFFT.h>
 #include <Adafruit_ZeroPDM.h>
 
 #include "NFCWriter.h"
 #include "SparkFun_ST25DV64KC_Arduino_Library.h"
+#include "TextScroller.h"
+#include "Palette.h"
+#include "PixelLayout.h"
+#include "Noise.h"
+#include "BeatClock.h"
+#include "BeatTracker.h"
+#include "PitchTracker.h"
+#include "AudioPipeline.h"
+#include "AudioCapture.h"
+#include "MotionCapture.h"
+#include "PowerManager.h"
+#include "HostLink.h"
 
 // Extern variables
 extern NFCWriter nfcWriter;
 
+// Eye grid mappings (pixel index per 5x5 cell, -1 where there is no LED)
+extern const int leftGrid[5][5];
+extern const int rightGrid[5][5];
+
 // I2C client Address
 //int CLIENT_ADDRESS = 0x12;  // Ensure this matches the host's client_ADDRESS
 
@@ -25,12 +40,11 @@ extern NFCWriter nfcWriter;
 #define PIN_PDM_DATA 12
 
 // FFT/SPECTRUM CONFIGURATION
-#define FFT_SIZE 64                 // Size of the FFT; must be a power of two
-#define SPECTRUM_SIZE (FFT_SIZE / 2) // FFT output bins
-#define SAMPLE_RATE 16000           // 16 kHz sample rate
+// FFT_SIZE and SAMPLE_RATE live in AudioPipeline.h, shared with the harness
+#define SPECTRUM_SIZE (FFT_SIZE / 2) // FFT output bins (62.5 Hz each at 256)
 
 // PDM DECIMATION PARAMETERS
-#define DECIMATION 64
+#define DECIMATION PDM_DECIMATION
 
 // NeoPixel configuration
 #define NEOPIXEL_PIN 7
@@ -96,13 +110,27 @@ void cyberpunkGlitchNeoPixelDemo(Adafruit_NeoPixel &pixels);
 void cyberpunkCircuitNeoPixelDemo(Adafruit_NeoPixel &pixels);
 void solidColorMusic(Adafruit_NeoPixel &pixels);
 void rainbowBeatMusic(Adafruit_NeoPixel &pixels);
+void spectrumAnalyzerMusic(Adafruit_NeoPixel &pixels);
+void pitchColorMusic(Adafruit_NeoPixel &pixels);
 void accelerometerNeoPixelDemoSmoother(Adafruit_NeoPixel &pixels);
 void gameOfLifeNeoPixelDemo(Adafruit_NeoPixel &pixels);
 void tetrisNeoPixelDemo(Adafruit_NeoPixel &pixels);
 void fallingDropsNeoPixelDemo(Adafruit_NeoPixel &pixels);
 void spiralingVortexNeoPixelDemo(Adafruit_NeoPixel &pixels);
+void rippleNeoPixelDemo(Adafruit_NeoPixel &pixels);
+void radarSweepNeoPixelDemo(Adafruit_NeoPixel &pixels);
+void lavaNeoPixelDemo(Adafruit_NeoPixel &pixels);
+void fogNeoPixelDemo(Adafruit_NeoPixel &pixels);
+void auroraNeoPixelDemo(Adafruit_NeoPixel &pixels);
 void theaterMarqueeNeoPixelDemo(Adafruit_NeoPixel &pixels);
 void neopixelsOff(Adafruit_NeoPixel &pixels);
+void textScrollerNeoPixelDemo(Adafruit_NeoPixel &pixels);
+void microphoneCalibration(Adafruit_NeoPixel &pixels);
+void accelerometerCalibration(Adafruit_NeoPixel &pixels);
+
+// Joined 10x5 eye canvas helpers
+int canvasPixelIndex(int row, int col);
+void showHostMessage(const uint8_t* text, int length);
 
 // **Startup Sequence and Shapes**
 void runStartupSequence();
@@ -115,6 +143,10 @@ void drawSingleDot(Adafruit_NeoPixel &pixels, int x, int y);
 bool isLeftButtonPressed();
 bool isRightButtonPressed();
 bool isBothButtonsPressed();
+bool animationRunning();  // Per-frame loop condition for animations
+void beatTrackerService();  // Beat-locked animations: analyzes a captured frame if one is ready
+bool sleepDue();          // Idle for the sleep timeout
+void sleepUntilWoken(Adafruit_NeoPixel &pixels);
 
 //void handleBothButtonsPressed();
 
@@ -122,6 +154,7 @@ bool isBothButtonsPressed();
 // Utility functions
 void waitForButtonPress(bool (*buttonFunction)());
 void handleBothButtonsPressed();
+void drawCard(bool useFullRange);
 
 // Test functions (functionality kept but not used in main sketch)
 void testSensors(Adafruit_LIS3DH &lis);
@@ -131,6 +164,15 @@ void testNeoPixels(Adafruit_NeoPixel &pixels);
 void recordAudio();
 void processFFT();
 float calculateVolume();
+float volumeThreshold();
+void applyMicCalibration(int calibration);
+void applyAccelCalibration(int x, int y, int z, int scale);
+void applyMotionGestureThresholds(int shake, int tilt, int spin, int flipMs);
+void startMicCalibration();
+void startAccelCalibration();
+extern BandEnergies bandEnergies;  // Updated by processFFT()
+bool processPitch();
+extern PitchTracker pitchTracker;  // Updated by processPitch()
 void displaySolidColor(Adafruit_NeoPixel &pixels, uint32_t selectedColor);
 void displayRainbow(Adafruit_NeoPixel &pixels);
 
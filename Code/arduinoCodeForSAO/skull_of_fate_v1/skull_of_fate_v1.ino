@@ -47,6 +47,20 @@ void updateConfigParameterInt(const String& key, int value);
 
 volatile bool animationInterrupted = false;
 
+// Acoustic gesture heard by the capture interrupt, handled in loop()
+volatile SoundGesture pendingSoundGesture = SOUND_GESTURE_NONE;
+
+// Motion gesture from the accelerometer, handled in loop()
+volatile MotionGesture pendingMotionGesture = MOTION_GESTURE_NONE;
+int faceDownReturnIndex = -1;  // Animation to go back to once turned face up
+uint8_t spinPaletteId = 0;     // Palette a spin moves on from
+
+// Last gestures and how many have been seen, for the host's register map
+volatile uint8_t lastMotionGesture = MOTION_GESTURE_NONE;
+volatile uint8_t motionGestureCount = 0;
+volatile uint8_t lastSoundGesture = SOUND_GESTURE_NONE;
+volatile uint8_t soundGestureCount = 0;
+
 // NFC Tag and Writer instances
 SFE_ST25DV64KC tag;       // Create an instance of the ST25DV64KC NDEF class
 NFCWriter nfcWriter(tag); // Create an instance of NFCWriter
@@ -54,7 +68,8 @@ NFCWriter nfcWriter(tag); // Create an instance of NFCWriter
 // Variables for the chase pattern
 int animationIndex = 0; // current animation index
 
-// Function pointer array for animations
+// Function pointer array for animations. Config files and hosts refer to
+// animations by index, so new ones go on the end.
 void (*animations[])(Adafruit_NeoPixel&) = {
   eyeballNeoPixelDemo,
   accelerometerNeoPixelDemoSmoother,
@@ -72,7 +87,14 @@ void (*animations[])(Adafruit_NeoPixel&) = {
   fallingDropsNeoPixelDemo,
   spiralingVortexNeoPixelDemo,
   theaterMarqueeNeoPixelDemo,
-  neopixelsOff
+  neopixelsOff,
+  rippleNeoPixelDemo,
+  radarSweepNeoPixelDemo,
+  lavaNeoPixelDemo,
+  fogNeoPixelDemo,
+  auroraNeoPixelDemo,
+  spectrumAnalyzerMusic,
+  pitchColorMusic
 };
 
 const int numAnimations = sizeof(animations) / sizeof(animations[0]); // Update numAnimations
@@ -112,8 +134,9 @@ const int MAX_MESSAGE_LENGTH = 512;  // Adjust based on maximum expected data
 char receivedMessage[MAX_MESSAGE_LENGTH];
 int messageLength = 0;
 
-// Variable to store the last requested sensor data
-char lastRequestedSensor = 0;
+// First byte of the last write: a command picks what the next read returns,
+// anything below HOST_COMMAND_FIRST is the register address reads start at
+volatile char lastRequestedSensor = HOST_REG_ID;
 
 
 // Function to switch animations
@@ -140,6 +163,30 @@ void onDoubleTap() {
     switchAnimation(animationIndex);
 }
 
+// Callback from the capture interrupt: stop the animation and let loop() act
+void onSoundGesture(SoundGesture gesture) {
+  lastSoundGesture = gesture;
+  soundGestureCount++;
+  pendingSoundGesture = gesture;
+  animationInterrupted = true;
+}
+
+// Called as accelerometer samples are drained. A spin only changes the
+// palette, which blends in under the running animation; the others stop it.
+void onMotionGesture(MotionGesture gesture) {
+  lastMotionGesture = gesture;
+  motionGestureCount++;
+  if (gesture == MOTION_GESTURE_SPIN) {
+    spinPaletteId = (spinPaletteId + 1) % NUM_PALETTES;
+    selectPalette(spinPaletteId);
+    Serial.print("Spin: blending to palette ");
+    Serial.println(spinPaletteId);
+    return;
+  }
+  pendingMotionGesture = gesture;
+  animationInterrupted = true;
+}
+
 /*
 // Function to handle configuration updates
 void handleConfigUpdate(const String& key, int value) {
@@ -199,6 +246,8 @@ void setup() {
   chaseSpeed = 100; // You can set this based on config if available
   chaseRepeats = 2; // Similarly, set based on config if available
   watchdogTimeout = currentConfig.watchdogmaxtimeout / 1000; // Convert ms to seconds
+  powerSetSleepTimeout((unsigned long)currentConfig.sleep_timeout * 1000);
+  applyMicCalibration(currentConfig.mic_calibration); // Microphone AGC starting point
 
 
 
@@ -206,6 +255,14 @@ void setup() {
 
   // Initialize accelerometer
   initializeAccelerometer(lis);
+  applyAccelCalibration(currentConfig.accel_calibration.x,
+                        currentConfig.accel_calibration.y,
+                        currentConfig.accel_calibration.z,
+                        currentConfig.accel_calibration.scale);
+  applyMotionGestureThresholds(currentConfig.motion_gestures.shake,
+                               currentConfig.motion_gestures.tilt,
+                               currentConfig.motion_gestures.spin,
+                               currentConfig.motion_gestures.flip_ms);
 
   // Setup I2C
   // myWire.begin(currentConfig.defaulti2cAddress);
@@ -292,12 +349,18 @@ void setup() {
 
   Serial.print("I2C Client address set to: 0x");
   Serial.println(CLIENT_ADDRESS, HEX);
+
+  // Scroll the client address across the eyes so it can be read without a serial console
+  char addressText[8];
+  snprintf(addressText, sizeof(addressText), "0X%02X", CLIENT_ADDRESS);
+  scrollTextBlocking(pixels, addressText, pixels.Color(0, 255, 0));
   
   
 
   //delay(1000);
 
      // Initialize I2C as client
+  hostLinkBegin(handleCommand, fillHostRegisters);
   myWire.begin(CLIENT_ADDRESS);
   myWire.onReceive(receiveEvent);
   myWire.onRequest(requestEvent);
@@ -326,6 +389,8 @@ void setup() {
   Serial.println(" milliseconds!");
 
   setDoubleTapCallback(onDoubleTap);
+  audioCaptureSetGestureCallback(onSoundGesture);
+  motionCaptureSetGestureCallback(onMotionGesture);
 
   configManager.printConfig();
 
@@ -336,6 +401,18 @@ void setup() {
 void loop() {
   // Always check for special mode timeout
   isSpecialModeActive();
+
+  // Accelerometer batches and taps between animations
+  motionCaptureService();
+
+  // Commands the host sent while the last animation ran
+  hostLinkService();
+  static uint16_t reportedDrops = 0;
+  if (hostLinkDropped() != reportedDrops) {
+    reportedDrops = hostLinkDropped();
+    Serial.print("I2C commands dropped, queue full: ");
+    Serial.println(reportedDrops);
+  }
   
   // Handle button presses
   handleBothButtonsPressed(); // Let this function manage its own state
@@ -355,6 +432,34 @@ void loop() {
     
     // Right button already checks for special mode in isRightButtonPressed()
     
+    // Double clap draws a card, three knocks move to the next animation
+    SoundGesture gesture = pendingSoundGesture;
+    if (gesture != SOUND_GESTURE_NONE) {
+      pendingSoundGesture = SOUND_GESTURE_NONE;
+      if (gesture == SOUND_GESTURE_DOUBLE_CLAP) {
+        Serial.println("Double clap heard.");
+        drawCard(false);
+      } else if (gesture == SOUND_GESTURE_KNOCK) {
+        Serial.println("Knock pattern heard.");
+        advanceAnimation();
+      }
+      Watchdog.reset();
+    }
+    
+    // Shake draws a card, face down blanks the LEDs until turned back over,
+    // tilting right / left steps through the animations
+    MotionGesture motion = pendingMotionGesture;
+    if (motion != MOTION_GESTURE_NONE) {
+      pendingMotionGesture = MOTION_GESTURE_NONE;
+      handleMotionGesture(motion);
+      Watchdog.reset();
+    }
+    
+    // Sleep once nothing has happened for a while; the animation resumes on wake
+    if (sleepDue()) {
+      sleepUntilWoken(pixels);
+    }
+    
     // Run the current animation
     if (currentAnimation != NULL) {
       currentAnimation(pixels);
@@ -367,96 +472,154 @@ void loop() {
   Watchdog.reset();
 }
 
-// Function to handle received I2C commands
+// Called from the SERCOM1 interrupt when the host writes. A lone register
+// address only moves the read pointer; commands are queued and
+// hostLinkService() runs them from the main loop.
 void receiveEvent(int howMany) {
   if (howMany <= 0) return;
 
   char command = myWire.read();
-  Serial.print("Command received: ");
-  Serial.println(command);
+  lastRequestedSensor = command;
 
-  // Initialize variables for data reception
-  uint8_t dataBuffer[howMany - 1];
-  int dataLength = 0;
+  if ((uint8_t)command < HOST_COMMAND_FIRST) {
+    powerNoteHostWake();  // Polling the map is not use; leave the idle timer alone
+    while (myWire.available()) {
+      myWire.read();  // The register map is read-only
+    }
+    return;
+  }
+
+  powerNoteActivity();  // Also wakes the card if this address match did
 
-  // Read the remaining bytes as data
+  HostCommand* slot = hostLinkReserve();
+  uint8_t dataLength = 0;
   while (myWire.available()) {
-    if (dataLength < (howMany - 1)) {
-      dataBuffer[dataLength++] = myWire.read();
-    } else {
-      myWire.read();  // Discard any extra bytes
+    uint8_t value = myWire.read();
+    if (slot != NULL && dataLength < HOST_COMMAND_MAX_DATA) {
+      slot->data[dataLength++] = value;
     }
   }
 
-  handleCommand(command, dataBuffer, dataLength);
+  if (slot != NULL) {
+    slot->command = command;
+    slot->length = dataLength;
+    hostLinkCommit();
+  }
 }
 
-// Callback function executed when the host requests data
+// Called from the SERCOM1 interrupt when the host reads. Answers from the
+// registers the main loop keeps current: a block from the register address
+// on, or the reply to a sensor command.
 void requestEvent() {
-  // Send sensor data based on the last requested sensor
-  switch (lastRequestedSensor) {
-    case '3': {
+  const HostRegisters &registers = hostLinkRegisters();
+  uint8_t request = lastRequestedSensor;
+
+  if (request < HOST_COMMAND_FIRST) {
+    if (request < HOST_REGISTER_COUNT) {
+      myWire.write((const uint8_t*)&registers + request, HOST_REGISTER_COUNT - request);
+    } else {
+      myWire.write(0);
+    }
+    return;
+  }
+
+  switch (request) {
+    case '3':
       // Magnetic sensor data
-      bool magneticField = isMagneticFieldDetected();
-      Serial.println(magneticField);
-      if (magneticField) {
-        myWire.write(1); // Magnetic field detected
-      } else {
-        myWire.write(0); // No magnetic field
-      }
-      Serial.println("Magnetic sensor value sent.");
-      Watchdog.reset();
+      myWire.write((registers.status & HOST_STATUS_MAGNET) ? 1 : 0);
       break;
-    }
     case '4': {
-      // Accelerometer data
-      float x, y, z;
-      getAccelerometerValues(lis, x, y, z);
-      myWire.write((byte*)&x, sizeof(x));
-      myWire.write((byte*)&y, sizeof(y));
-      myWire.write((byte*)&z, sizeof(z));
-      Serial.println("Accelerometer data sent.");
-      Watchdog.reset();
+      // Accelerometer data, newest FIFO sample in g
+      float accel[3];
+      for (uint8_t i = 0; i < 3; i++) {
+        accel[i] = registers.accel[i] * (1.0f / MOTION_COUNTS_PER_G);
+      }
+      myWire.write((const uint8_t*)accel, sizeof(accel));
       break;
     }
-    case '5': {
+    case '5':
       // Button states
-      uint8_t buttons = 0;
-      if (isLeftButtonPressed()) buttons |= 0x01;
-      if (isRightButtonPressed()) buttons |= 0x02;
-      myWire.write(buttons);
-      Serial.println("Button states sent.");
-      Watchdog.reset();
+      myWire.write((registers.status >> 1) & 0x03);
       break;
-    }
     case '6': {
-      // PDM microphone data (e.g., volume level)
-      float volume = getMicrophoneVolume();
-      myWire.write((byte*)&volume, sizeof(volume));
-      Serial.println("PDM microphone data sent.");
-      Watchdog.reset();
+      // PDM microphone volume
+      float volume = registers.volume * (1.0f / 256);
+      myWire.write((const uint8_t*)&volume, sizeof(volume));
       break;
     }
+    case 'E':
+    case 'e':
+      // Bass, mid and treble energies (0-255 each) from the last FFT frame
+      myWire.write(registers.bands, sizeof(registers.bands));
+      break;
     default:
       // Send a dummy byte if no valid sensor was requested
       myWire.write('A');
-      Serial.println("Default data sent.");
-      Watchdog.reset();
       break;
   }
 }
 
-// Function to handle different commands
+// Refreshes the register map from the main loop, once per frame
+void fillHostRegisters(HostRegisters &registers) {
+  unsigned long now = millis();
+
+  // Raw pin reads: the button helpers have side effects (special mode)
+  uint8_t status = 0;
+  if (isMagneticFieldDetected()) status |= HOST_STATUS_MAGNET;
+  if (digitalRead(LEFT_BUTTON_PIN) == LOW) status |= HOST_STATUS_LEFT_BUTTON;
+  if (digitalRead(RIGHT_BUTTON_PIN) == LOW) status |= HOST_STATUS_RIGHT_BUTTON;
+  if (audioCaptureVolume() > audioCaptureThreshold()) status |= HOST_STATUS_SOUND;
+  if (specialModeActive) status |= HOST_STATUS_SPECIAL_MODE;
+  if (hostLinkDropped() != 0) status |= HOST_STATUS_DROPPED;
+
+  const MotionTiltEstimator &tilt = motionCaptureTilt();
+  if (tilt.energy > MOTION_ACTIVITY_THRESHOLD) status |= HOST_STATUS_MOVING;
+  registers.status = status;
+  registers.animation = animationIndex;
+
+  MotionSample sample = { 0, 0, 0 };
+  motionCaptureLatest(sample);
+  registers.accel[0] = sample.x;
+  registers.accel[1] = sample.y;
+  registers.accel[2] = sample.z;
+  registers.pitch = tilt.pitch;
+  registers.roll = tilt.roll;
+  registers.motion = tilt.energy;
+  registers.motionGesture = lastMotionGesture;
+  registers.soundGesture = lastSoundGesture;
+
+  registers.volume = audioCaptureVolume();
+  registers.threshold = audioCaptureThreshold();
+  registers.bands[0] = (bandEnergies.bass * 17) >> 8;
+  registers.bands[1] = (bandEnergies.mid * 17) >> 8;
+  registers.bands[2] = (bandEnergies.treble * 17) >> 8;
+
+  registers.bpm = min(beatClockBpm(), (uint16_t)255);
+  registers.beatPhase = beatClockBeatPhase(now);
+  registers.beatInBar = beatClockBeatInBar(now);
+  registers.motionGestures = motionGestureCount;
+  registers.soundGestures = soundGestureCount;
+  registers.uptime = now;
+
+  registers.i2cAddress = CLIENT_ADDRESS;
+  registers.defaultAnimation = currentConfig.defaultAnimation;
+  registers.sleepTimeout = currentConfig.sleep_timeout;
+  registers.accelRate = currentConfig.accel_rate;
+  registers.brightness = currentConfig.neopixelmaxbrightness;
+  registers.animations = numAnimations;
+}
+
+// Function to handle different commands, run from the main loop by hostLinkService()
 void handleCommand(char command, uint8_t* data, int length) {
-  // Store the last requested sensor command
-  lastRequestedSensor = command;
+  Serial.print("Command received: ");
+  Serial.println(command);
 
   switch (command) {
     case '0':
       // Stop all effects and turn off LEDs
       turnOffAllLEDs();   // Turn off all individual LEDs
       setAllNeoPixelsColor(pixels, 0);  // Turn off all NeoPixels
-      currentAnimation = animations[numAnimations - 1];
+      currentAnimation = neopixelsOff;
       animationInterrupted = true;
       Serial.println("All effects stopped, LEDs turned OFF");
       Watchdog.reset();
@@ -466,7 +629,11 @@ void handleCommand(char command, uint8_t* data, int length) {
       if (length >= 1) {
           uint8_t newIndex = data[0];
           if (newIndex == 255) { // Random animation
+              // Any animation but off: a draw of off takes the last one instead
               animationIndex = random(0, numAnimations-1);
+              if (animations[animationIndex] == neopixelsOff) {
+                  animationIndex = numAnimations - 1;
+              }
           } else if (newIndex < numAnimations) {
               animationIndex = newIndex;
           } else {
@@ -548,6 +715,69 @@ void handleCommand(char command, uint8_t* data, int length) {
       // Add your code here
       Watchdog.reset();
       break;
+    case 'T':
+    case 't':
+      // Scroll a text message across both eyes (Format: T <text>)
+      if (length >= 1) {
+        showHostMessage(data, length);
+        Serial.print("Scrolling host message of length ");
+        Serial.println(length);
+      } else {
+        Serial.println("Error: Message text not provided.");
+      }
+      Watchdog.reset();
+      break;
+    case 'P':
+    case 'p':
+      // Switch the running animation to another palette (Format: P <paletteId>)
+      if (length >= 1) {
+        uint8_t paletteId = data[0];
+        if (paletteId < NUM_PALETTES) {
+          selectPalette(paletteId);
+          Serial.print("Blending to palette ");
+          Serial.println(paletteId);
+        } else {
+          Serial.println("Error: Invalid palette id.");
+        }
+      } else {
+        Serial.println("Error: Palette id not provided.");
+      }
+      Watchdog.reset();
+      break;
+    case 'K':
+    case 'k':
+      // Set the beat clock tempo, starting a bar now (Format: K <bpm>, 0 = follow the microphone)
+      if (length >= 1) {
+        beatClockSetBpm(data[0], millis());
+        Serial.print("Beat clock set to ");
+        Serial.print(data[0]);
+        Serial.println(" BPM");
+      } else {
+        Serial.println("Error: BPM not provided.");
+      }
+      Watchdog.reset();
+      break;
+    case 'E':
+    case 'e':
+      // Request to send bass/mid/treble band energies
+      Serial.println("Band energies requested.");
+      // Data will be sent in requestEvent
+      Watchdog.reset();
+      break;
+    case 'M':
+    case 'm':
+      // Calibrate the microphone noise floor and range (saved to mic_calibration)
+      startMicCalibration();
+      Serial.println("Microphone calibration started.");
+      Watchdog.reset();
+      break;
+    case 'G':
+    case 'g':
+      // Calibrate the accelerometer offsets and scale (saved to accel_calibration)
+      startAccelCalibration();
+      Serial.println("Accelerometer calibration started.");
+      Watchdog.reset();
+      break;
     case 'C':
     case 'c':
       // Control Individual LED (Format: C <LED_ID> <STATE>)
@@ -580,6 +810,7 @@ void handleCommand(char command, uint8_t* data, int length) {
         Serial.println("Error: Insufficient parameters for LED control.");
       }
       Watchdog.reset();
+      break;
     case 'U':  // Example command to update config parameter
       // Format: U <key_length> <key> <value>
       if (length >= 3) { // At least key_length, key, and value
@@ -626,6 +857,54 @@ void advanceAnimation() {
   Watchdog.reset();
 }
 
+// Function to go back to the previous animation
+void retreatAnimation() {
+  animationIndex = (animationIndex + numAnimations - 1) % numAnimations;
+  currentAnimation = animations[animationIndex];
+  Serial.print("Switched to animation index ");
+  Serial.println(animationIndex);
+  Watchdog.reset();
+}
+
+// Acts on a motion gesture between animations
+void handleMotionGesture(MotionGesture gesture) {
+  switch (gesture) {
+    case MOTION_GESTURE_SHAKE:
+      Serial.println("Shake felt.");
+      drawCard(false);
+      break;
+    case MOTION_GESTURE_FACE_DOWN:
+      Serial.println("Face down: LEDs off.");
+      if (faceDownReturnIndex < 0) {
+        faceDownReturnIndex = animationIndex;
+      }
+      turnOffAllLEDs();
+      setAllNeoPixelsColor(pixels, 0);
+      currentAnimation = neopixelsOff;
+      break;
+    case MOTION_GESTURE_FACE_UP:
+      if (faceDownReturnIndex >= 0) {
+        Serial.println("Face up: resuming.");
+        animationIndex = faceDownReturnIndex;
+        faceDownReturnIndex = -1;
+        currentAnimation = animations[animationIndex];
+      }
+      break;
+    case MOTION_GESTURE_TILT_RIGHT:
+      if (faceDownReturnIndex < 0) {
+        advanceAnimation();
+      }
+      break;
+    case MOTION_GESTURE_TILT_LEFT:
+      if (faceDownReturnIndex < 0) {
+        retreatAnimation();
+      }
+      break;
+    default:
+      break;
+  }
+}
+
 // Function to run the startup sequence
 void runStartupSequence() {
   const int delayTime = 150; // Delay time in milliseconds (can be adjusted)
@@ -704,14 +983,6 @@ void runChasePattern(int speed, int repeats) {
 
 // Function to get microphone volume level
 float getMicrophoneVolume() {
-  // Record audio data
-  recordAudio();
-
-  // Process FFT on the recorded audio
-  processFFT();
-
-  // Calculate the overall volume from the spectrum
-  float volume = calculateVolume();
-  Watchdog.reset();
-  return volume;
+  // Cached by the capture interrupt's level meter
+  return calculateVolume();
 }
@@ -66,6 +66,19 @@ onboard_led = Pin("LED", Pin.OUT)  # Initialize onboard LED
 # Debounce settings
 DEBOUNCE_TIME = 0.05  # 50 milliseconds debounce time for button presses
 
+# Skull of Fate register map (HostLink.h): one read returns the whole state
+SKULL_REGISTER_COUNT = 44         # Bytes from register 0x00 to the end of the map
+SKULL_REGISTER_FORMAT = '<BBBBIhhhbbHBBHHBBBBBBBBIBBHHBB'
+SKULL_REGISTER_FIELDS = (
+    'id', 'version', 'status', 'animation', 'frame',
+    'accel_x', 'accel_y', 'accel_z', 'pitch', 'roll', 'motion',
+    'motion_gesture', 'sound_gesture', 'volume', 'threshold',
+    'bass', 'mid', 'treble', 'bpm', 'beat_phase', 'beat_in_bar',
+    'motion_gestures', 'sound_gestures', 'uptime',
+    'i2c_address', 'default_animation', 'sleep_timeout', 'accel_rate',
+    'brightness', 'animations',
+)
+
 # Helper Functions
 def set_neopixel_color(color):
     """Sets the color of the NeoPixel.
@@ -114,6 +127,51 @@ def send_i2c_command(command_char, data_bytes=None, response_length=1):
     except Exception as e:
         print(f"Error sending I2C command: {e}")
 
+def read_skull_registers(start=0, length=SKULL_REGISTER_COUNT):
+    """Reads a block of the Skull of Fate register map in one transaction.
+
+    Writing the start address sets the read pointer; no delay is needed
+    before the read because the card answers from registers it keeps current.
+    A poller that only ever reads from 0 can skip the write after the first
+    time, until it sends another command.
+
+    Args:
+        start (int, optional): First register address. Defaults to 0.
+        length (int, optional): Number of bytes to read. Defaults to the whole map.
+
+    Returns:
+        bytes: The register bytes, or None if the bus is not available.
+    """
+    if not skull_of_fate_bus:
+        print("Skull of Fate bus not initialized. Cannot read registers.")
+        return None
+    try:
+        skull_of_fate_bus.writeto(SKULL_OF_FATE_ADDRESS, bytes([start]))
+        return skull_of_fate_bus.readfrom(SKULL_OF_FATE_ADDRESS, length)
+    except Exception as e:
+        print(f"Error reading I2C registers: {e}")
+        return None
+
+def read_skull_state():
+    """Reads the whole register map and returns it as a dict of named fields."""
+    data = read_skull_registers()
+    if not data or len(data) != SKULL_REGISTER_COUNT:
+        return None
+    return dict(zip(SKULL_REGISTER_FIELDS, struct.unpack(SKULL_REGISTER_FORMAT, data)))
+
+def print_skull_state():
+    """Prints every register of the Skull of Fate."""
+    state = read_skull_state()
+    if state is None:
+        print("No register data received from Skull of Fate.")
+        return
+    status = state['status']
+    print(f"Frame {state['frame']}, uptime {state['uptime']} ms, animation {state['animation']} of {state['animations']}")
+    print(f"Magnet: {bool(status & 0x01)}, Left Button: {bool(status & 0x02)}, Right Button: {bool(status & 0x04)}, Moving: {bool(status & 0x10)}")
+    print(f"Accelerometer - X: {state['accel_x'] / 1024:.2f}, Y: {state['accel_y'] / 1024:.2f}, Z: {state['accel_z'] / 1024:.2f}, Pitch: {state['pitch']}, Roll: {state['roll']}")
+    print(f"Microphone Volume: {state['volume'] / 256:.2f} (threshold {state['threshold'] / 256:.2f}), Bass: {state['bass']}, Mid: {state['mid']}, Treble: {state['treble']}")
+    print(f"BPM: {state['bpm']}, Beat {state['beat_in_bar']} phase {state['beat_phase']}, Gestures - motion: {state['motion_gestures']}, sound: {state['sound_gestures']}")
+
 def decode_response(command_char, data):
     """Decodes the response received from the Skull of Fate device.
 
@@ -147,6 +205,12 @@ def decode_response(command_char, data):
             return
         volume = float_from_bytes(data)
         print(f"Microphone Volume: {volume:.2f}")
+    elif command_char == 'E':
+        # Band energies (3 bytes, 0-255 each)
+        if len(data) != 3:
+            print("Incorrect data length for band energies.")
+            return
+        print(f"Bass: {data[0]}, Mid: {data[1]}, Treble: {data[2]}")
     elif command_char == '1':
         # Animation command acknowledgment
         if len(data) != 1:
@@ -236,6 +300,13 @@ if skull_of_fate_bus:
     print("A - Placeholder command 4")
     print("B - Placeholder command 5")
     print("C - Control Individual LED (Format: C <LED_ID> <STATE>)")
+    print("T - Scroll a text message across the eyes (Format: T <TEXT>)")
+    print("P - Switch the animation palette (Format: P <PALETTE_ID>, 0-9)")
+    print("K - Set the beat clock tempo (Format: K <BPM>, 0 = follow the microphone)")
+    print("E - Request bass/mid/treble energies")
+    print("M - Calibrate the microphone (quiet while blue, loud while green)")
+    print("G - Calibrate the accelerometer (flat while blue, on an edge while green)")
+    print("R - Read every sensor and setting in one register-map read")
     print("Type the command and press Enter.")
     print()
     print("BUTTON A,B,C ON THE BADGE CAN SEND COMMANDS ALSO")
@@ -395,6 +466,54 @@ while True:
                 # Send command 'C' followed by LED_ID and State
                 send_i2c_command('C', payload)
 
+            elif command == 'T':
+                # Expected format: T <TEXT>
+                if len(parts) < 2:
+                    print("Error: Invalid format. Use: T <TEXT>")
+                    continue
+
+                # Send command 'T' followed by the message text (max 64 characters)
+                text = user_input.split(None, 1)[1][:64]
+                send_i2c_command('T', text.encode())
+
+            elif command == 'P':
+                # Expected format: P <PALETTE_ID>
+                if len(parts) != 2:
+                    print("Error: Invalid format. Use: P <PALETTE_ID>")
+                    continue
+
+                try:
+                    paletteId = int(parts[1])
+                except ValueError:
+                    print("Error: Invalid palette id.")
+                    continue
+
+                if paletteId < 0 or paletteId > 9:
+                    print("Error: Palette id must be between 0 and 9.")
+                    continue
+
+                # Send command 'P' followed by the palette id
+                send_i2c_command('P', bytes([paletteId]))
+
+            elif command == 'K':
+                # Expected format: K <BPM>
+                if len(parts) != 2:
+                    print("Error: Invalid format. Use: K <BPM>")
+                    continue
+
+                try:
+                    bpm = int(parts[1])
+                except ValueError:
+                    print("Error: Invalid BPM.")
+                    continue
+
+                if bpm != 0 and (bpm < 60 or bpm > 180):
+                    print("Error: BPM must be 0 or between 60 and 180.")
+                    continue
+
+                # Send command 'K' followed by the tempo
+                send_i2c_command('K', bytes([bpm]))
+
             elif command == '1':
                 # Expected format: 1 <ANIMATION_INDEX>
                 if len(parts) != 2:
@@ -432,6 +551,14 @@ while True:
                 # Command expecting 4 bytes response (microphone data)
                 send_i2c_command(command, response_length=4)
 
+            elif command == 'E':
+                # Command expecting 3 bytes response (bass, mid, treble)
+                send_i2c_command(command, response_length=3)
+
+            elif command == 'R':
+                # Whole register map in one read, no command delay
+                print_skull_state()
+
             else:
                 # Send the command to the I2C CLIENT without additional data
                 send_i2c_command(command)
@@ -478,6 +605,54 @@ while True:
             # Send command 'C' followed by LED_ID and State
             send_i2c_command('C', payload)
 
+        elif command == 'T':
+            # Expected format: T <TEXT>
+            if len(parts) < 2:
+                print("Error: Invalid format. Use: T <TEXT>")
+                continue
+
+            # Send command 'T' followed by the message text (max 64 characters)
+            text = user_input.split(None, 1)[1][:64]
+            send_i2c_command('T', text.encode())
+
+        elif command == 'P':
+            # Expected format: P <PALETTE_ID>
+            if len(parts) != 2:
+                print("Error: Invalid format. Use: P <PALETTE_ID>")
+                continue
+
+            try:
+                paletteId = int(parts[1])
+            except ValueError:
+                print("Error: Invalid palette id.")
+                continue
+
+            if paletteId < 0 or paletteId > 9:
+                print("Error: Palette id must be between 0 and 9.")
+                continue
+
+            # Send command 'P' followed by the palette id
+            send_i2c_command('P', bytes([paletteId]))
+
+        elif command == 'K':
+            # Expected format: K <BPM>
+            if len(parts) != 2:
+                print("Error: Invalid format. Use: K <BPM>")
+                continue
+
+            try:
+                bpm = int(parts[1])
+            except ValueError:
+                print("Error: Invalid BPM.")
+                continue
+
+            if bpm != 0 and (bpm < 60 or bpm > 180):
+                print("Error: BPM must be 0 or between 60 and 180.")
+                continue
+
+            # Send command 'K' followed by the tempo
+            send_i2c_command('K', bytes([bpm]))
+
         elif command == '1':
             # Expected format: 1 <ANIMATION_INDEX>
             if len(parts) != 2:
@@ -515,6 +690,14 @@ while True:
             # Command expecting 4 bytes response (microphone data)
             send_i2c_command(command, response_length=4)
 
+        elif command == 'E':
+            # Command expecting 3 bytes response (bass, mid, treble)
+            send_i2c_command(command, response_length=3)
+
+        elif command == 'R':
+            # Whole register map in one read, no command delay
+            print_skull_state()
+
         else:
             # Send the command to the I2C CLIENT
             send_i2c_command(command)